@@ -19,6 +19,7 @@
 	IBOutlet UITextField* textView;
 	
 	Client* client;
+	TouchSampleList samples;
 
 }
 
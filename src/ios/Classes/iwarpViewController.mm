@@ -53,25 +53,31 @@
 }
 
 bool moved = false;
-float acceleration = 1.0f;
 
 - (void)touchesMoved:(NSSet *)touches withEvent:(UIEvent *)event {	
 	UITouch *touch = [touches anyObject];
 	CGPoint currentPosition = [touch locationInView:sessionView];
 	CGPoint previousPosition = [touch previousLocationInView: sessionView];
 	
-	float x = currentPosition.x - previousPosition.x;
-	float y = currentPosition.y - previousPosition.y;
-  
-  if (acceleration < 3.0f) {
-    acceleration += 0.1f;
-  }
-	
-	client->send_mouse_moved(x * acceleration, y * acceleration);
+	// samples wait for the next display frame, see sendSamples
+	TouchSample sample;
+	sample.x = currentPosition.x - previousPosition.x;
+	sample.y = currentPosition.y - previousPosition.y;
+	sample.timestamp = touch.timestamp;
+	samples.push_back(sample);
 	moved = true;
 }
 
+- (void)sendSamples {
+	if (!samples.empty()) {
+		client->send_touch_samples(samples);
+		samples.clear();
+	}
+}
+
 - (void)touchesEnded:(NSSet *)touches withEvent:(UIEvent *)event {
+	[self sendSamples];
+	
 	if(!moved) {
 		UITouch *touch = [[event allTouches] anyObject];
 		
@@ -92,12 +98,11 @@ float acceleration = 1.0f;
   		}
 		}
 	}
-  acceleration = 1.0f;
 	moved = false;
 }
 
 - (void)clientUpdate {
-  client->update(1000);
+  client->update();
 }
 
 // Implement viewDidLoad to do additional setup after loading the view, typically from a nib.
@@ -105,6 +110,7 @@ float acceleration = 1.0f;
 	[super viewDidLoad];
 	client = new Client();
   [NSTimer scheduledTimerWithTimeInterval:1 target:self selector:@selector(clientUpdate) userInfo:nil repeats:YES];
+  [[CADisplayLink displayLinkWithTarget:self selector:@selector(sendSamples)] addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSDefaultRunLoopMode];
 	[self.view addSubview:connectView];
 	[addressField becomeFirstResponder];
 }
@@ -0,0 +1,54 @@
+#ifndef DISPLAY_FRAME_SOURCE_HPP
+#define DISPLAY_FRAME_SOURCE_HPP
+
+#include <ApplicationServices/ApplicationServices.h>
+#include "PreviewPublisher.h"
+
+	class DisplayFrameSource : public IFrameSource
+	{
+		
+	public:
+		
+		DisplayFrameSource() : image_(NULL), data_(NULL) { };
+		
+		bool capture(Frame& frame)
+		{
+			image_ = CGDisplayCreateImage(CGMainDisplayID());
+			if (!image_)
+			{
+				return false;
+			}
+			
+			// the encoder wants 32 bit pixels, which is what the main display hands out
+			if (CGImageGetBitsPerPixel(image_) != 32)
+			{
+				CGImageRelease(image_);
+				image_ = NULL;
+				return false;
+			}
+			
+			data_ = CGDataProviderCopyData(CGImageGetDataProvider(image_));
+			
+			frame.width = CGImageGetWidth(image_);
+			frame.height = CGImageGetHeight(image_);
+			frame.stride = CGImageGetBytesPerRow(image_);
+			frame.pixels = CFDataGetBytePtr(data_);
+			return true;
+		}
+		
+		void release(Frame& frame)
+		{
+			CFRelease(data_);
+			CGImageRelease(image_);
+			data_ = NULL;
+			image_ = NULL;
+		}
+		
+	private:
+		
+		CGImageRef image_;
+		CFDataRef data_;
+		
+	};
+
+#endif
@@ -1,6 +1,13 @@
 #include "Entrance.h"
 
-Entrance::Entrance()
+static bool is_motion(CGEventType type)
+{
+  return type == kCGEventMouseMoved || type == kCGEventLeftMouseDragged || type == kCGEventRightMouseDragged;
+}
+
+Entrance::Entrance(bool motion_lane)
+  : router_(&layout_)
+  , motion_lane_(motion_lane)
 {
 	client_commands_[kCGEventKeyDown]						= new KeyDownClientCommand();
 	client_commands_[kCGEventKeyUp]							= new KeyUpClientCommand();
@@ -15,11 +22,47 @@ Entrance::Entrance()
 	client_commands_[kCGEventScrollWheel]				= new ScrollWheelClientCommand();
   
   enabled_ = false;
-  client_ = new Client();
+  single_client_ = create_client();
+  broadcast_socket_ = new ZeroMQBroadcastSocket();
+  broadcast_client_ = motion_lane_ ? new Client(new MotionLaneSocket(broadcast_socket_, true)) : new Client(broadcast_socket_);
+  client_ = single_client_;
 };
 
+Client* Entrance::create_client()
+{
+  if (motion_lane_)
+  {
+    return new Client(new MotionLaneSocket(new ZeroMQSendSocket()));
+  }
+  return new Client();
+}
+
 bool Entrance::connect_to(const std::string& host, unsigned int port)
 {
+  if (client_ == broadcast_client_)
+  {
+    broadcast_client_->disconnect();
+    client_ = single_client_;
+  }
+  
+	bool result = client_->connect_to(host, port);
+	
+	if (result)
+	{
+		enable();
+	}
+	
+	return result;
+}
+
+bool Entrance::broadcast_to(const std::string& host, unsigned int port)
+{
+  if (client_ == single_client_ && single_client_->connected())
+  {
+    single_client_->disconnect();
+  }
+  
+  client_ = broadcast_client_;
 	bool result = client_->connect_to(host, port);
 	
 	if (result)
@@ -48,8 +91,90 @@ void Entrance::on_event(CGEventType type, CGEventRef event)
   }
 }
 
+bool Entrance::pending()
+{
+  return client_->pending();
+}
+
+bool Entrance::load_layout(std::istream& input)
+{
+  if (!layout_.load(input))
+  {
+    return false;
+  }
+  
+  screen_clients_.assign(layout_.count(), (Client*)NULL);
+  
+  // every neighbour stays connected so an edge crossing is only a pointer swap
+  for (int screen = 0; screen < layout_.count(); screen++)
+  {
+    if (screen == layout_.home())
+    {
+      continue;
+    }
+    
+    Client* client = create_client();
+    client->set_idle_timeout(0);
+    client->connect_to(layout_.screen(screen).name, SERVER_PORT);
+    screen_clients_[screen] = client;
+  }
+  
+  return true;
+}
+
+void Entrance::route_to(int screen)
+{
+  client_->flush();
+  
+  if (screen == layout_.home())
+  {
+    CGWarpMouseCursorPosition(CGPointMake(router_.x(), router_.y()));
+    client_ = single_client_;
+    enabled_ = false;
+    return;
+  }
+  
+  client_ = screen_clients_[screen];
+  enable();
+  client_->send_mouse_position(router_.x(), router_.y());
+}
+
+bool Entrance::track_local(CGEventType type, CGEventRef event)
+{
+  if (enabled_ || layout_.count() < 2 || !is_motion(type))
+  {
+    return false;
+  }
+  
+  CGPoint location = CGEventGetLocation(event);
+  router_.enter(layout_.home(), location.x, location.y);
+  return scan_edges(type, event);
+}
+
+bool Entrance::scan_edges(CGEventType type, CGEventRef event)
+{
+  int x = CGEventGetIntegerValueField(event, kCGMouseEventDeltaX);
+  int y = CGEventGetIntegerValueField(event, kCGMouseEventDeltaY);
+  
+  if (!router_.move(x, y))
+  {
+    return false;
+  }
+  
+  route_to(router_.active());
+  return true;
+}
+
 CGEventRef Entrance::scan_input(CGEventType type, CGEventRef event)
 {	
+  if (layout_.count() > 1 && client_ != single_client_ && client_ != broadcast_client_ && is_motion(type))
+  {
+    if (scan_edges(type, event))
+    {
+      return NULL;
+    }
+  }
+  
 	if (client_commands_.find(type) != client_commands_.end())
   {
     try
@@ -84,6 +209,16 @@ void Entrance::toggle()
   }  
 }
 
+void Entrance::update()
+{
+  client_->update();
+}
+
+void Entrance::flush()
+{
+  client_->flush();
+}
+
 void Entrance::disable()
 {
   client_->disconnect();
@@ -8,6 +8,9 @@
 
 	#include "IClientCommand.h"
 	#include "Client.h"
+	#include "ZeroMQBroadcastSocket.h"
+	#include "MotionLaneSocket.h"
+	#include "ScreenLayout.h"
 
   typedef std::vector<std::string> StringList; 
 
@@ -15,15 +18,23 @@
 	{	
 		
 		typedef std::map<int, IClientCommand*> ClientCommandList;
+		typedef std::vector<Client*> ScreenClientList;
 		
 	public:
 		
-		Entrance();
+		Entrance(bool motion_lane = false);
     
     bool understands(const CGEventType& event_type);
     void on_event(CGEventType type, CGEventRef event);
 		bool connect_to(const std::string& host, unsigned int port);
+		bool broadcast_to(const std::string& host, unsigned int port);
     void toggle();
+    void update();
+    void flush();
+    bool pending();
+    
+    bool load_layout(std::istream& input);
+    bool track_local(CGEventType type, CGEventRef event);
     
     
 		void disable();
@@ -34,11 +45,22 @@
 		
     void scan_reconnect(CGEventType type, CGEventRef event);
 		CGEventRef scan_input(CGEventType type, CGEventRef event);
+    bool scan_edges(CGEventType type, CGEventRef event);
+    void route_to(int screen);
+    Client* create_client();
 		
 		Client* client_;
+		Client* single_client_;
+		Client* broadcast_client_;
+		ZeroMQBroadcastSocket* broadcast_socket_;
+    
+    ScreenLayout layout_;
+    ScreenRouter router_;
+    ScreenClientList screen_clients_;
 		
 		ClientCommandList client_commands_;
 		bool enabled_;
+		bool motion_lane_;
     
 	};
 
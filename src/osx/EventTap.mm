@@ -60,6 +60,11 @@
     return NULL;
   }
   
+  if ([network on_local_event:type withEvent:event])
+  {
+    return NULL;
+  }
+  
 	return event;  
 }
 
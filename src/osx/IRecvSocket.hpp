@@ -10,6 +10,10 @@
     
     virtual Message* receive() = 0;
     
+    virtual Message* try_receive() = 0;
+    
+    virtual void* poll_handle() = 0;
+    
     virtual void dispose(Message* message) = 0;
     
     virtual void terminate() = 0;
@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include "Reactor.h"
+
 static const int BUFFER_SIZE = 64;
 
 static const char* MULTICAST_GROUP = "225.1.2.3";
@@ -31,6 +33,8 @@ static const int NAK_RDATA_IVL = pgm_secs (2);
 static const int NAK_DATA_RETRIES = 50;
 static const int NAK_NCF_RETRIES = 50;
 static const int MULTICAST_LOOP = 0;
+static const int NOBLOCK = 1;
+static const unsigned int BROADCAST_INTERVAL = 1000;
 
 static std::string hostname()
 {
@@ -41,6 +45,11 @@ static std::string hostname()
 }
 
 Multicast::Multicast()
+  : socket_(NULL)
+  , reactor_(NULL)
+  , listener_(NULL)
+  , broadcast_timer_(0)
+  , pending_timer_(0)
 {
   pgm_error_t* pgm_err = NULL;
 	sa_family_t sa_family = AF_UNSPEC;
@@ -85,6 +94,7 @@ Multicast::Multicast()
 	pgm_setsockopt (socket_, IPPROTO_PGM, PGM_NAK_RDATA_IVL, &NAK_RDATA_IVL, sizeof(NAK_RDATA_IVL));
 	pgm_setsockopt (socket_, IPPROTO_PGM, PGM_NAK_DATA_RETRIES, &NAK_DATA_RETRIES, sizeof(NAK_DATA_RETRIES));
 	pgm_setsockopt (socket_, IPPROTO_PGM, PGM_NAK_NCF_RETRIES, &NAK_NCF_RETRIES, sizeof(NAK_NCF_RETRIES));
+  pgm_setsockopt (socket_, IPPROTO_PGM, PGM_NOBLOCK, &NOBLOCK, sizeof(NOBLOCK));
     
   pgm_setsockopt (socket_, IPPROTO_PGM, PGM_JOIN_GROUP, &res->ai_recv_addrs[0], sizeof(struct group_req));
 	pgm_setsockopt (socket_, IPPROTO_PGM, PGM_SEND_GROUP, &res->ai_send_addrs[0], sizeof(struct group_req));
@@ -134,7 +144,74 @@ void Multicast::broadcast()
   }
 }
 
-std::string Multicast::receive()
+void Multicast::attach(Reactor* reactor, IDiscoveryListener* listener)
+{
+  reactor_ = reactor;
+  listener_ = listener;
+  
+  int recv_sock = 0;
+  int pending_sock = 0;
+  socklen_t optlen = sizeof(int);
+  
+  pgm_getsockopt(socket_, IPPROTO_PGM, PGM_RECV_SOCK, &recv_sock, &optlen);
+  optlen = sizeof(int);
+  pgm_getsockopt(socket_, IPPROTO_PGM, PGM_PENDING_SOCK, &pending_sock, &optlen);
+  
+  reactor_->add_fd(recv_sock, this);
+  reactor_->add_fd(pending_sock, this);
+  
+  broadcast_timer_ = reactor_->add_timer(BROADCAST_INTERVAL, this);
+  broadcast();
+}
+
+void Multicast::on_readable()
+{
+  std::string host;
+  int status = PGM_IO_STATUS_NORMAL;
+  
+  while ((status = receive(host)) == PGM_IO_STATUS_NORMAL)
+  {
+    if (host.length() > 0 && listener_)
+    {
+      listener_->on_host_found(host);
+    }
+  }
+  
+  if (PGM_IO_STATUS_TIMER_PENDING == status || PGM_IO_STATUS_RATE_LIMITED == status)
+  {
+    schedule_pending();
+  }
+}
+
+void Multicast::on_timer(int timer_id)
+{
+  if (timer_id == broadcast_timer_)
+  {
+    broadcast();
+  }
+  else if (timer_id == pending_timer_)
+  {
+    pending_timer_ = 0;
+    on_readable();
+  }
+}
+
+void Multicast::schedule_pending()
+{
+  if (pending_timer_ != 0)
+  {
+    return;
+  }
+  
+  struct timeval tv;
+  socklen_t optlen = sizeof(tv);
+  pgm_getsockopt(socket_, IPPROTO_PGM, PGM_TIME_REMAIN, &tv, &optlen);
+  
+  unsigned int remain = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+  pending_timer_ = reactor_->add_timer(remain, this, false);
+}
+
+int Multicast::receive(std::string& host)
 {
   char buffer[BUFFER_SIZE];
   memset(buffer, 0, BUFFER_SIZE);
@@ -142,10 +219,11 @@ std::string Multicast::receive()
   pgm_error_t* pgm_err = NULL;
   const int status = pgm_recv(socket_, buffer, BUFFER_SIZE, 0, 0, &pgm_err);
   
-  if (PGM_IO_STATUS_NORMAL != status)
+  if (PGM_IO_STATUS_ERROR == status)
   {
     std::cerr << "fail receiving" << std::endl;
   }
   
-  return std::string(buffer);
-}
\ No newline at end of file
+  host = std::string(buffer);
+  return status;
+}
@@ -1,12 +1,24 @@
 #include <string>
 
+#include "IReactorHandler.hpp"
 
 extern "C" {
   #include <pgm/pgm.h>
   #include <pgm/in.h>
 }
 
-class Multicast
+class Reactor;
+
+class IDiscoveryListener
+{
+  
+public:
+  
+  virtual void on_host_found(const std::string& host) = 0;
+  
+};
+
+class Multicast : public IReactorHandler, public ITimerHandler
 {
   
 public:
@@ -14,12 +26,26 @@ public:
   Multicast();
   ~Multicast();
   
+  void attach(Reactor* reactor, IDiscoveryListener* listener);
+  
   void broadcast();
   
-  std::string receive();
+  void on_readable();
+  
+  void on_timer(int timer_id);
   
 private:
   
+  int receive(std::string& host);
+  
+  void schedule_pending();
+  
   pgm_sock_t* socket_;
   
+  Reactor* reactor_;
+  IDiscoveryListener* listener_;
+  
+  int broadcast_timer_;
+  int pending_timer_;
+  
 };
\ No newline at end of file
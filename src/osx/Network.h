@@ -4,6 +4,11 @@
 #import "BezelWindow.h"
 #import "StatusMenu.h"
 #import "Multicast.h"
+#import "Reactor.h"
+#import "ClipboardChannel.h"
+#import "FileSender.h"
+#import "FileReceiver.h"
+#import "PreviewSubscriber.h"
 
 @interface Network : NSObject {
   IBOutlet Entrance* entrance;
@@ -11,21 +16,42 @@
   IBOutlet StatusMenu* status_menu;
   
   Multicast multicast;
+  Reactor* reactor;
+  
+  ClipboardChannel* clipboard_exit;
+  ClipboardChannel* clipboard_entrance;
+  NSCondition* clipboard_condition;
+  NSString* clipboard_content;
+  unsigned long long pending_digest;
+  NSInteger pasteboard_count;
+  
+  Reactor* transfer_reactor;
+  FileSender* file_sender;
+  PreviewSubscriber* preview_subscriber;
+  
+  bool flush_scheduled;
   
   bool quit;
 }
 
 - (void)on_event:(CGEventType)eventType withEvent:(CGEventRef)event;
 - (void)connect_to:(NSString*)address withPort:(unsigned int)port;
+- (void)broadcast_to:(NSString*)address withPort:(unsigned int)port;
 - (void)toggle;
+- (void)show_capture:(bool)captured;
 - (bool)is_connected;
 - (bool)understands:(CGEventType)eventType;
+- (bool)on_local_event:(CGEventType)eventType withEvent:(CGEventRef)event;
 
 - (void)quit;
 - (void)recent:(NSString*)address;
+- (void)broadcast:(NSString*)address;
+- (void)send_file:(NSString*)path;
+
+- (void)clipboard_offered:(NSNumber*)digest;
+- (void)clipboard_ready:(NSString*)content;
+- (void)preview_updated:(NSImage*)image;
 
-- (void)exit_thread;
-- (void)broadcast_thread;
-- (void)subscriber_thread;
-- (void)update_thread;
+- (void)network_thread;
+- (void)transfer_thread;
 @end
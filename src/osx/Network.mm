@@ -1,26 +1,120 @@
 #import "Network.h"
 #import "Exit.h"
 #import "ZeroMQContext.hpp"
+#import "PreviewPublisher.h"
+#import "DisplayFrameSource.hpp"
+
+#include <fstream>
+
+class NetworkDiscoveryListener : public IDiscoveryListener
+{
+  
+public:
+  
+  NetworkDiscoveryListener(id network) : network_(network) { };
+  
+  void on_host_found(const std::string& host)
+  {
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    [network_ performSelectorOnMainThread:@selector(add_network_item:) withObject:[NSString stringWithUTF8String:host.c_str()] waitUntilDone:false];
+    [pool release];
+  }
+  
+private:
+  
+  id network_;
+  
+};
+
+class NetworkClipboardListener : public IClipboardListener
+{
+  
+public:
+  
+  NetworkClipboardListener(id network) : network_(network) { };
+  
+  // these run on the network thread, whose own pool is only drained at exit
+  void on_clipboard_offered(unsigned long long digest, unsigned int size)
+  {
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    [network_ performSelectorOnMainThread:@selector(clipboard_offered:) withObject:[NSNumber numberWithUnsignedLongLong:digest] waitUntilDone:false];
+    [pool release];
+  }
+  
+  void on_clipboard_ready(unsigned long long digest, const std::string& content)
+  {
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    [network_ clipboard_ready:[NSString stringWithUTF8String:content.c_str()]];
+    [pool release];
+  }
+  
+private:
+  
+  id network_;
+  
+};
+
+class NetworkPreviewListener : public IPreviewListener
+{
+  
+public:
+  
+  NetworkPreviewListener(id network) : network_(network) { };
+  
+  void on_preview(int width, int height, const unsigned char* pixels)
+  {
+    // the transfer thread's own pool is only drained when it exits
+    NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+    NSBitmapImageRep* bitmap = [[[NSBitmapImageRep alloc] initWithBitmapDataPlanes:NULL pixelsWide:width pixelsHigh:height bitsPerSample:8 samplesPerPixel:4 hasAlpha:YES isPlanar:NO colorSpaceName:NSDeviceRGBColorSpace bytesPerRow:width * 4 bitsPerPixel:32] autorelease];
+    memcpy([bitmap bitmapData], pixels, width * height * 4);
+    
+    NSImage* image = [[[NSImage alloc] initWithSize:NSMakeSize(width, height)] autorelease];
+    [image addRepresentation:bitmap];
+    [network_ performSelectorOnMainThread:@selector(preview_updated:) withObject:image waitUntilDone:false];
+    [pool release];
+  }
+  
+private:
+  
+  id network_;
+  
+};
 
 @implementation Network
 
 - (id) init {
   self = [super init];
   quit = false;
+  reactor = NULL;
+  clipboard_exit = NULL;
+  clipboard_entrance = NULL;
+  clipboard_condition = [[NSCondition alloc] init];
+  clipboard_content = nil;
+  pending_digest = 0;
+  pasteboard_count = [[NSPasteboard generalPasteboard] changeCount];
+  transfer_reactor = NULL;
+  file_sender = NULL;
+  preview_subscriber = NULL;
   
   ZeroMQContext::init();
-  entrance = new Entrance();
+  entrance = new Entrance([[NSUserDefaults standardUserDefaults] boolForKey:@"MotionLane"]);
+  [self load_layout];
     
-  [NSThread detachNewThreadSelector:@selector(exit_thread) toTarget:self withObject:nil];
-  [NSThread detachNewThreadSelector:@selector(broadcast_thread) toTarget:self withObject:nil];
-  [NSThread detachNewThreadSelector:@selector(subscriber_thread) toTarget:self withObject:nil];
-  [NSThread detachNewThreadSelector:@selector(update_thread) toTarget:self withObject:nil];
+  [NSThread detachNewThreadSelector:@selector(network_thread) toTarget:self withObject:nil];
+  [NSThread detachNewThreadSelector:@selector(transfer_thread) toTarget:self withObject:nil];
+  [NSTimer scheduledTimerWithTimeInterval:1 target:self selector:@selector(update) userInfo:nil repeats:YES];
 
   return self;
 }
 
 - (void)quit {
   quit = true;
+  if (reactor) {
+    reactor->stop();
+  }
+  if (transfer_reactor) {
+    transfer_reactor->stop();
+  }
   sleep(1);
   [NSApp performSelector:@selector(terminate:) withObject:nil afterDelay:0.0]; 
 }
@@ -29,16 +123,57 @@
   [self connect_to:address withPort:SERVER_PORT]; 
 }
 
+- (void)broadcast:(NSString*)address {
+  [self broadcast_to:address withPort:SERVER_PORT];
+}
+
+- (void)send_file:(NSString*)path {
+  if (file_sender) {
+    file_sender->send([path fileSystemRepresentation]);
+  }
+}
+
 - (void)awakeFromNib {
   [status_menu set_delegate:self]; 
 }
 
 - (void)on_event:(CGEventType)eventType withEvent:(CGEventRef)event {
   entrance->on_event(eventType, event);
+  
+  if (entrance->pending() && !flush_scheduled) {
+    flush_scheduled = true;
+    [self performSelector:@selector(flush) withObject:nil afterDelay:SCROLL_FRAME_INTERVAL / 1000.0];
+  }
+  
+  if (![self is_connected]) {
+    [self show_capture:false];
+  }
+}
+
+- (bool)on_local_event:(CGEventType)eventType withEvent:(CGEventRef)event {
+  if (!entrance->track_local(eventType, event)) {
+    return false;
+  }
+  
+  [self show_capture:[self is_connected]];
+  return true;
+}
+
+- (void)load_layout {
+  NSString* path = [[NSBundle mainBundle] pathForResource:@"layout" ofType:@"txt"];
+  
+  if (path) {
+    std::ifstream input([path fileSystemRepresentation]);
+    entrance->load_layout(input);
+  }
 }
 
 - (void)connected_test {
-  if (![self is_connected]) {
+  [self show_capture:![self is_connected]];
+}
+
+- (void)show_capture:(bool)captured {
+  if (captured) {
     [[NSApplication sharedApplication] activateIgnoringOtherApps : YES];
     CGAssociateMouseAndMouseCursorPosition(false);
     CGDisplayHideCursor(kCGDirectMainDisplay);
@@ -55,6 +190,24 @@
   [self connected_test];
   [status_menu add_recent_item:address];
   entrance->connect_to([address cStringUsingEncoding:NSASCIIStringEncoding], port);
+  
+  if (clipboard_entrance) {
+    clipboard_entrance->connect_to([address cStringUsingEncoding:NSASCIIStringEncoding], CLIPBOARD_PORT);
+  }
+  
+  if (file_sender) {
+    file_sender->connect_to([address cStringUsingEncoding:NSASCIIStringEncoding], TRANSFER_PORT);
+  }
+  
+  if (preview_subscriber) {
+    preview_subscriber->connect_to([address cStringUsingEncoding:NSASCIIStringEncoding], PREVIEW_PORT);
+  }
+}
+
+- (void)broadcast_to:(NSString*)address withPort:(unsigned int)port {
+  [self connected_test];
+  [status_menu add_recent_item:address];
+  entrance->broadcast_to([address cStringUsingEncoding:NSASCIIStringEncoding], port);
 }
 
 - (void)toggle {
@@ -74,49 +227,145 @@
   [status_menu add_network_item:address time:4000];
 }
 
-- (void)subscriber_thread {
+- (void)network_thread {
   NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
-	while (!quit) {
-    std::string host = multicast.receive();
-    if (host.length() > 0)
-    {
-      [self performSelectorOnMainThread:@selector(add_network_item:) withObject:[NSString stringWithUTF8String:host.c_str()] waitUntilDone:false];
-    }
-    sleep(1);
-	}
-  [pool release];  
-}
-
-- (void)broadcast_thread {
-  NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
-	while (!quit) {
-    multicast.broadcast();
-    sleep(1);
-	}
-  [pool release];  
+  NetworkDiscoveryListener listener(self);
+  NetworkClipboardListener clipboard_listener(self);
+  Exit exit;
+  Reactor network_reactor;
+  ClipboardChannel exit_clipboard;
+  ClipboardChannel entrance_clipboard;
+  
+  bool compress = [[NSUserDefaults standardUserDefaults] boolForKey:@"BulkCompression"];
+  exit_clipboard.set_compression(compress);
+  entrance_clipboard.set_compression(compress);
+  
+  exit.attach(&network_reactor);
+  multicast.attach(&network_reactor, &listener);
+  exit_clipboard.bind(CLIPBOARD_PORT);
+  exit_clipboard.attach(&network_reactor, &clipboard_listener);
+  entrance_clipboard.attach(&network_reactor, &clipboard_listener);
+  
+  clipboard_exit = &exit_clipboard;
+  clipboard_entrance = &entrance_clipboard;
+  reactor = &network_reactor;
+  if (!quit) {
+    network_reactor.run();
+  }
+  reactor = NULL;
+  clipboard_entrance = NULL;
+  clipboard_exit = NULL;
+  
+  exit.shutdown();
+  [pool release];
 }
 
-- (void)exit_thread {
+- (void)transfer_thread {
   NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
-  Exit exit;
-	while (!quit) {
-    exit.receive_input();
-	}
-  exit.shutdown();
+  NSString* downloads = [NSSearchPathForDirectoriesInDomains(NSDownloadsDirectory, NSUserDomainMask, YES) objectAtIndex:0];
+  
+  // bulk transfers get a loop of their own so they never delay the exit
+  Reactor reactor_loop;
+  FileSender sender;
+  FileReceiver receiver([downloads fileSystemRepresentation]);
+  DisplayFrameSource screen;
+  PreviewPublisher preview(&screen);
+  PreviewSubscriber subscriber;
+  NetworkPreviewListener preview_listener(self);
+  
+  bool compress = [[NSUserDefaults standardUserDefaults] boolForKey:@"BulkCompression"];
+  sender.set_compression(compress);
+  preview.set_compression(compress);
+  
+  sender.attach(&reactor_loop);
+  receiver.bind(TRANSFER_PORT);
+  receiver.attach(&reactor_loop, NULL);
+  preview.bind(PREVIEW_PORT);
+  preview.attach(&reactor_loop);
+  subscriber.attach(&reactor_loop, &preview_listener);
+  
+  file_sender = &sender;
+  preview_subscriber = &subscriber;
+  transfer_reactor = &reactor_loop;
+  if (!quit) {
+    reactor_loop.run();
+  }
+  transfer_reactor = NULL;
+  preview_subscriber = NULL;
+  file_sender = NULL;
+  
   [pool release];
 }
 
+- (void)preview_updated:(NSImage*)image {
+  [status_menu show_preview:image];
+}
+
+- (void)flush {
+  flush_scheduled = false;
+  entrance->flush();
+}
+
 - (void)update {
+  entrance->update();
   [status_menu update:1000];
+  [self update_clipboard];
 }
 
-- (void)update_thread {
-  NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
-	while (!quit) {
-    [self performSelectorOnMainThread:@selector(update) withObject:nil waitUntilDone:false];
-    sleep(1);
-	}
-  [pool release];
-};
+- (void)update_clipboard {
+  NSPasteboard* pasteboard = [NSPasteboard generalPasteboard];
+  
+  if ([pasteboard changeCount] == pasteboard_count) {
+    return;
+  }
+  pasteboard_count = [pasteboard changeCount];
+  
+  // offer to both the machine we control and whoever controls us, each side
+  // drops content it just pulled from the other
+  NSString* content = [pasteboard stringForType:NSStringPboardType];
+  if (content && clipboard_entrance) {
+    clipboard_entrance->offer([content UTF8String]);
+  }
+  if (content && clipboard_exit) {
+    clipboard_exit->offer([content UTF8String]);
+  }
+}
+
+- (void)clipboard_offered:(NSNumber*)digest {
+  // claim the pasteboard but leave the bytes on the controller until a paste
+  pending_digest = [digest unsignedLongLongValue];
+  NSPasteboard* pasteboard = [NSPasteboard generalPasteboard];
+  pasteboard_count = [pasteboard declareTypes:[NSArray arrayWithObject:NSStringPboardType] owner:self];
+}
+
+- (void)clipboard_ready:(NSString*)content {
+  [clipboard_condition lock];
+  [clipboard_content release];
+  clipboard_content = [content retain];
+  [clipboard_condition signal];
+  [clipboard_condition unlock];
+}
+
+- (void)pasteboard:(NSPasteboard*)pasteboard provideDataForType:(NSString*)type {
+  if (!clipboard_exit || !clipboard_entrance) {
+    return;
+  }
+  
+  NSDate* deadline = [NSDate dateWithTimeIntervalSinceNow:CLIPBOARD_FETCH_TIMEOUT / 1000.0];
+  
+  [clipboard_condition lock];
+  [clipboard_content release];
+  clipboard_content = nil;
+  // only the channel the digest was offered on has anything to pull
+  clipboard_exit->fetch(pending_digest);
+  clipboard_entrance->fetch(pending_digest);
+  
+  while (!clipboard_content && [clipboard_condition waitUntilDate:deadline]);
+  
+  if (clipboard_content) {
+    [pasteboard setString:clipboard_content forType:type];
+  }
+  [clipboard_condition unlock];
+}
 
 @end
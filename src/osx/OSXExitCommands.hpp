@@ -5,6 +5,7 @@
 #include <ApplicationServices/ApplicationServices.h>
 #include <iostream>
 #include "KeyCodes.hpp"
+#include "ScrollAccumulator.h"
 
 	void PostMouseEvent(CGMouseButton button, CGEventType type, const CGPoint point, int click_count = 1) 
 	{
@@ -143,6 +144,23 @@
 		
 	};
 
+	class MousePositionCommand : public IExitCommand
+	{
+		
+	public:
+		
+		static int type() { return MOUSE_POSITION; };
+		
+		void Execute(const Message& message)
+		{
+			CGPoint point;
+			point.x = message.x;
+			point.y = message.y;
+			PostMouseEvent(kCGMouseButtonCenter, kCGEventMouseMoved, point);
+		};
+		
+	};
+
 	class LeftDraggedCommand : public IExitCommand
 	{
 		
@@ -205,21 +223,34 @@
 		
 	public:
 		
+		ScrollWheelCommand()
+			: horizontal_(SCROLL_FIXED_ONE)
+			, vertical_(SCROLL_FIXED_ONE)
+		{ };
+		
 		static int type() { return SCROLL_WHEEL; };
 		
 		void Execute(const Message& message)
 		{
-			CGEventRef ourEvent = CGEventCreate(NULL);
-			CGPoint point = CGEventGetLocation(ourEvent);
+			int x = horizontal_.add(message.x);
+			int y = vertical_.add(message.y);
 			
-			CGEventRef e = CGEventCreateScrollWheelEvent(NULL, kCGScrollEventUnitPixel, 1, 2);
+			if (x == 0 && y == 0)
+			{
+				return;
+			}
 			
-			CGEventSetType(e, kCGEventScrollWheel);
-			CGEventSetIntegerValueField(e, kCGScrollWheelEventDeltaAxis1, message.y);
+			CGEventRef e = CGEventCreateScrollWheelEvent(NULL, kCGScrollEventUnitPixel, 2, y, x);
+			CGEventSetIntegerValueField(e, kCGScrollWheelEventIsContinuous, 1);
 			CGEventPost(kCGSessionEventTap, e);
 			CFRelease(e);
 		};
 		
+	private:
+		
+		ScrollAccumulator horizontal_;
+		ScrollAccumulator vertical_;
+		
 	};
 
 	class LeftDoubleClickCommand : public IExitCommand
@@ -249,4 +280,40 @@
 	};
 
 
+	class TextCommand : public IExitCommand
+	{
+		
+	public:
+		
+		static int type() { return TEXT; };
+		
+		void Execute(const Message& message)
+		{
+			CFStringRef text = CFStringCreateWithBytes(NULL, (const UInt8*)message.text, text_length(message), kCFStringEncodingUTF8, false);
+			
+			if (!text)
+			{
+				return;
+			}
+			
+			UniChar chars[MESSAGE_TEXT_SIZE];
+			CFIndex length = CFStringGetLength(text);
+			CFStringGetCharacters(text, CFRangeMake(0, length), chars);
+			CFRelease(text);
+			
+			// one down and up types the whole string, whatever the keyboard layout
+			CGEventRef down = CGEventCreateKeyboardEvent(NULL, 0, true);
+			CGEventRef up = CGEventCreateKeyboardEvent(NULL, 0, false);
+			CGEventSetFlags(down, 0);
+			CGEventSetFlags(up, 0);
+			CGEventKeyboardSetUnicodeString(down, length, chars);
+			CGEventKeyboardSetUnicodeString(up, length, chars);
+			CGEventPost(kCGSessionEventTap, down);
+			CGEventPost(kCGSessionEventTap, up);
+			CFRelease(down);
+			CFRelease(up);
+		};
+		
+	};
+
 #endif
\ No newline at end of file
@@ -18,6 +18,7 @@
   IBOutlet NSMenuItem* network_seperator_item;
   
   NSMutableArray* network_items;
+  NSMenuItem* preview_item;
   
   NSStatusItem* statusItem;
   bool is_open;
@@ -28,6 +29,7 @@
 
 - (IBAction)quit:(id)sender;
 - (IBAction)recent:(id)sender;
+- (IBAction)send_file:(id)sender;
 
 - (void)add_recent_item:(NSString*)item_address;
 - (void)add_network_item:(NSString*)item_address time:(int)time;
@@ -36,6 +38,8 @@
 
 - (void)update:(int)delta_milliseconds;
 
+- (void)show_preview:(NSImage*)image;
+
 - (void)show_menu;
 
 - (void)start_searching;
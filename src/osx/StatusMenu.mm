@@ -15,9 +15,31 @@
 - (IBAction)recent:(id)sender {
   NSMenuItem* menu_item = sender;
 	[self add_recent_item:[menu_item title]];	
+  
+  // option-click adds the host to the broadcast group instead of switching to it
+  if ([[NSApp currentEvent] modifierFlags] & NSAlternateKeyMask) {
+    [delegate performSelector:@selector(broadcast:) withObject:[menu_item title]];
+    return;
+  }
+  
   [delegate performSelector:@selector(recent:) withObject:[menu_item title]];
 }
 
+- (IBAction)send_file:(id)sender {
+  NSOpenPanel* panel = [NSOpenPanel openPanel];
+  [panel setCanChooseDirectories:NO];
+  [panel setAllowsMultipleSelection:YES];
+  
+  [NSApp activateIgnoringOtherApps:YES];
+  if ([panel runModal] != NSOKButton) {
+    return;
+  }
+  
+  for (NSURL* url in [panel URLs]) {
+    [delegate performSelector:@selector(send_file:) withObject:[url path]];
+  }
+}
+
 - (NSString*)recent_path {
 	NSString* path = [[[NSString alloc] initWithFormat:@"%@/Contents/Resources/recent.plist", [[NSBundle mainBundle] bundlePath]] autorelease];
 	if (![[[[NSFileManager alloc] init] autorelease] fileExistsAtPath:path isDirectory:FALSE]) {
@@ -57,6 +79,10 @@
 - (void)awakeFromNib {
 	[self init_main_menu];
 	[self init_recent_list];
+  [[main_menu insertItemWithTitle:@"Send File..." action:@selector(send_file:) keyEquivalent:@"" atIndex:0] setTarget:self];
+  
+  preview_item = [main_menu insertItemWithTitle:@"" action:NULL keyEquivalent:@"" atIndex:0];
+  [preview_item setHidden:YES];
 }
 
 - (void)show_menu {
@@ -74,6 +100,18 @@
   }
 }
 
+- (void)show_preview:(NSImage*)image {
+  // thumbnail of the exit being driven, at most 240 points wide
+  NSSize size = [image size];
+  if (size.width > 240) {
+    [image setScalesWhenResized:YES];
+    [image setSize:NSMakeSize(240, size.height * 240 / size.width)];
+  }
+  
+  [preview_item setImage:image];
+  [preview_item setHidden:NO];
+}
+
 - (void)store_recent_list {
 	NSMutableArray* recent_list = [[NSMutableArray alloc] init];
 	
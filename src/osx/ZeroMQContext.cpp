@@ -4,7 +4,7 @@ ZeroMQContext* ZeroMQContext::instance_ = NULL;
 
 ZeroMQContext::ZeroMQContext()
 {
-  context_ = new zmq::context_t(1);
+  context_ = new zmq::context_t(2);
 };
 
 void ZeroMQContext::init()
@@ -22,7 +22,15 @@ ZeroMQContext* ZeroMQContext::instance()
   return instance_;
 }
 
-zmq::socket_t* ZeroMQContext::create_socket(int type)
+zmq::socket_t* ZeroMQContext::create_socket(int type, Lane lane)
 {
-  return new zmq::socket_t(*context_, type);
+  zmq::socket_t* socket = new zmq::socket_t(*context_, type);
+  
+  if (lane != ANY_LANE)
+  {
+    unsigned long long affinity = lane;
+    socket->setsockopt(ZMQ_AFFINITY, &affinity, sizeof(affinity));
+  }
+  
+  return socket;
 }
\ No newline at end of file
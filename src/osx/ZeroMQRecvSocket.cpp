@@ -10,7 +10,7 @@
 
 ZeroMQRecvSocket::ZeroMQRecvSocket()
 {
-  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_PULL);
+  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_PULL, ZeroMQContext::INPUT_LANE);
   std::stringstream final_host;
   final_host << "tcp://*:" << SERVER_PORT;
   
@@ -38,6 +38,31 @@ Message* ZeroMQRecvSocket::receive()
   return data;
 };
 
+Message* ZeroMQRecvSocket::try_receive()
+{
+  zmq::message_t message;
+  
+  try {
+    if (!socket_->recv(&message, ZMQ_NOBLOCK))
+    {
+      return NULL;
+    }
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return NULL;
+  }
+  
+  Message* data = new Message();
+  memcpy(data, message.data(), message.size());
+  return data;
+}
+
+void* ZeroMQRecvSocket::poll_handle()
+{
+  return *socket_;
+}
+
 void ZeroMQRecvSocket::dispose(Message* message)
 {
   delete message;
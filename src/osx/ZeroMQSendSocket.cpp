@@ -30,7 +30,7 @@ bool ZeroMQSendSocket::connect_to(const std::string& host, unsigned int port)
 {
   
 //  terminate();
-  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_PUSH); 
+  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_PUSH, ZeroMQContext::INPUT_LANE); 
 
   try {
     socket_->connect(final_host(host, port).c_str());
@@ -0,0 +1,145 @@
+/*
+ *  bulk_codec.cpp
+ *  warp
+ *
+ *  Measures the bulk channel compressor on payloads shaped like what the
+ *  clipboard, file and preview channels carry: encode and decode throughput,
+ *  ratio, and how many frames the adaptive bypass let through raw. Built
+ *  against the shared sources alone, for example:
+ *
+ *    g++ -O2 -I../shared bulk_codec.cpp ../shared/BulkCodec.cpp \
+ *      ../shared/Lz4Compressor.cpp -o bulk_codec
+ *
+ *  The optional argument is the seed for the generated payloads.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BulkCodec.h"
+#include "Clock.h"
+#include "Lz4Compressor.h"
+
+static const unsigned int FRAME_SIZE = 16384;
+static const unsigned int FRAME_COUNT = 2048;
+
+static unsigned int state = 1;
+
+static unsigned int next_random()
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// words from a small vocabulary, like copied prose or source code
+static std::string text_payload(size_t size)
+{
+  static const char* words[] = { "the ", "warp ", "exit ", "entrance ", "message ", "socket ",
+    "return ", "if (", "} ", "\n  ", "clipboard ", "of ", "and ", "frame ", "0x", "int " };
+  std::string payload;
+
+  while (payload.size() < size)
+  {
+    payload += words[next_random() % 16];
+  }
+  payload.resize(size);
+  return payload;
+}
+
+// long runs with a little noise, like run-length encoded screen tiles
+static std::string preview_payload(size_t size)
+{
+  std::string payload;
+
+  while (payload.size() < size)
+  {
+    unsigned char run = (unsigned char)(next_random() % 32);
+    unsigned short colour = (unsigned short)(next_random() % 8) * 0x0841;
+    payload += (char)run;
+    payload += (char)(colour & 0xFF);
+    payload += (char)(colour >> 8);
+
+    if (next_random() % 4 != 0)
+    {
+      payload.append(payload.end() - 3, payload.end());
+    }
+  }
+  payload.resize(size);
+  return payload;
+}
+
+// what an already compressed file looks like
+static std::string random_payload(size_t size)
+{
+  std::string payload(size, 0);
+
+  for (size_t i = 0; i < size; i++)
+  {
+    payload[i] = (char)next_random();
+  }
+  return payload;
+}
+
+static void measure(const char* name, const std::string& payload)
+{
+  BulkCodec codec(new Lz4Compressor());
+  std::vector<std::string> encoded(FRAME_COUNT);
+  std::vector<int> codecs(FRAME_COUNT);
+  unsigned int compressed = 0;
+
+  unsigned long long started = Clock::now();
+  for (unsigned int i = 0; i < FRAME_COUNT; i++)
+  {
+    codecs[i] = codec.encode(payload.data(), payload.size(), encoded[i]);
+    compressed += (codecs[i] != CODEC_NONE) ? 1 : 0;
+  }
+  unsigned long long encode_ns = Clock::now() - started + 1;
+
+  std::string decoded;
+  bool intact = true;
+
+  started = Clock::now();
+  for (unsigned int i = 0; i < FRAME_COUNT; i++)
+  {
+    if (codecs[i] != CODEC_NONE)
+    {
+      intact &= BulkCodec::decode(codecs[i], encoded[i].data(), encoded[i].size(), payload.size(), decoded);
+      intact &= (decoded == payload);
+    }
+  }
+  unsigned long long decode_ns = Clock::now() - started + 1;
+
+  double total = (double)payload.size() * FRAME_COUNT;
+  printf("%-10s %9.1f", name, total * 1000.0 / encode_ns);
+
+  // nothing to time when every frame was bypassed
+  if (compressed > 0)
+  {
+    printf(" %9.1f", (double)payload.size() * compressed * 1000.0 / decode_ns);
+  }
+  else
+  {
+    printf(" %9s", "-");
+  }
+
+  printf(" %7.3f %9u %9u %s\n", (double)codec.sent_bytes() / codec.raw_bytes(),
+    compressed, FRAME_COUNT - compressed, intact ? "ok" : "CORRUPT");
+}
+
+int main(int argc, char* argv[])
+{
+  state = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  state = (state == 0) ? 1 : state;
+
+  printf("%-10s %9s %9s %7s %9s %9s\n", "payload", "enc MB/s", "dec MB/s", "ratio", "packed", "bypassed");
+  measure("text", text_payload(FRAME_SIZE));
+  measure("preview", preview_payload(FRAME_SIZE));
+  measure("random", random_payload(FRAME_SIZE));
+  measure("small", text_payload(128));
+  return 0;
+}
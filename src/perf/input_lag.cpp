@@ -0,0 +1,177 @@
+/*
+ *  input_lag.cpp
+ *  warp
+ *
+ *  Sends a steady stream of mouse-rate input through an ImpairmentProxy for a
+ *  range of network conditions and reports the lag a user would see. Built
+ *  against the shared sources and libzmq, for example:
+ *
+ *    g++ -I../shared -I../win/ext/zeromq-2.0.10/include input_lag.cpp \
+ *      ../shared/ImpairmentProxy.cpp ../shared/Reactor.cpp \
+ *      ../shared/TimerWheel.cpp ../shared/ZeroMQContext.cpp \
+ *      ../shared/ZeroMQSendSocket.cpp -lzmq -lpthread -o input_lag
+ *
+ *  The optional argument is the seed; the same seed gives the same drops
+ *  and reorderings on every run.
+ */
+
+#include <zmq.hpp>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include "Clock.h"
+#include "ImpairmentProxy.h"
+#include "Message.h"
+#include "Reactor.h"
+#include "ZeroMQContext.hpp"
+#include "ZeroMQSendSocket.h"
+
+static const unsigned int MESSAGE_COUNT = 500;
+static const unsigned int SEND_INTERVAL = 8;
+static const unsigned int DRAIN_TIME = 1000;
+static const unsigned int BASE_PORT = 45100;
+
+struct Condition
+{
+  const char* name;
+  Impairment impairment;
+};
+
+static const Condition conditions[] = {
+  { "clean",             {   0,  0, 0.00, 0.00,  0,      0 } },
+  { "20ms delay",        {  20,  0, 0.00, 0.00,  0,      0 } },
+  { "20ms +/- 10ms",     {  20, 10, 0.00, 0.00,  0,      0 } },
+  { "5% loss",           {   0,  0, 0.05, 0.00,  0,      0 } },
+  { "10% reorder",       {   0,  0, 0.00, 0.10, 30,      0 } },
+  { "64 kbit/s",         {   0,  0, 0.00, 0.00,  0,  64000 } },
+  { "bad wifi",          {  15, 40, 0.02, 0.05, 50, 256000 } }
+};
+
+struct ProxyThread
+{
+  Condition condition;
+  unsigned int seed;
+  unsigned int port;
+  Reactor* volatile reactor;
+  ImpairmentProxy* volatile proxy;
+};
+
+static void* run_proxy(void* argument)
+{
+  ProxyThread* thread = (ProxyThread*)argument;
+  
+  std::stringstream front, back;
+  front << "tcp://127.0.0.1:" << thread->port;
+  back << "tcp://127.0.0.1:" << thread->port + 1;
+  
+  Reactor reactor;
+  ImpairmentProxy proxy(thread->condition.impairment, thread->seed);
+  proxy.bind(front.str());
+  proxy.connect(back.str());
+  proxy.attach(&reactor);
+  
+  thread->proxy = &proxy;
+  thread->reactor = &reactor;
+  reactor.run();
+  
+  printf("%-16s %9u %9u", thread->condition.name, proxy.forwarded(), proxy.dropped());
+  return 0;
+}
+
+static unsigned long long percentile(std::vector<unsigned long long>& lags, double fraction)
+{
+  if (lags.empty())
+  {
+    return 0;
+  }
+  
+  std::sort(lags.begin(), lags.end());
+  return lags[(size_t)(fraction * (lags.size() - 1))];
+}
+
+static void measure(const Condition& condition, unsigned int seed, unsigned int port)
+{
+  ProxyThread thread = { condition, seed, port, 0, 0 };
+  
+  std::stringstream back;
+  back << "tcp://127.0.0.1:" << port + 1;
+  zmq::socket_t* receiver = ZeroMQContext::instance()->create_socket(ZMQ_PULL);
+  receiver->bind(back.str().c_str());
+  
+  pthread_t proxy_thread;
+  pthread_create(&proxy_thread, 0, run_proxy, &thread);
+  while (thread.reactor == 0)
+  {
+    usleep(1000);
+  }
+  
+  ZeroMQSendSocket sender;
+  sender.connect_to("127.0.0.1", port);
+  
+  std::vector<unsigned long long> lags;
+  unsigned int reordered = 0;
+  int last_index = -1;
+  
+  unsigned long long start = Clock::now_ms();
+  unsigned long long end = start + MESSAGE_COUNT * SEND_INTERVAL + DRAIN_TIME;
+  unsigned int sent = 0;
+  
+  for (unsigned long long now = start; now < end; now = Clock::now_ms())
+  {
+    if (sent < MESSAGE_COUNT && now >= start + sent * SEND_INTERVAL)
+    {
+      Message message;
+      memset(&message, 0, sizeof(message));
+      message.type = MOUSE_MOVE;
+      message.x = sent++;
+      message.flags = (unsigned int)now;
+      sender.send(&message, sizeof(message));
+      continue;
+    }
+    
+    zmq::pollitem_t item = { *receiver, 0, ZMQ_POLLIN, 0 };
+    zmq::poll(&item, 1, 1000);
+    
+    zmq::message_t received;
+    while (receiver->recv(&received, ZMQ_NOBLOCK))
+    {
+      Message message;
+      memcpy(&message, received.data(), sizeof(message));
+      
+      lags.push_back((unsigned int)Clock::now_ms() - message.flags);
+      reordered += (message.x < last_index) ? 1 : 0;
+      last_index = (message.x > last_index) ? message.x : last_index;
+    }
+  }
+  
+  thread.reactor->stop();
+  pthread_join(proxy_thread, 0);
+  
+  printf(" %9u %7llu %7llu %7llu\n", reordered, percentile(lags, 0.5), percentile(lags, 0.99), percentile(lags, 1.0));
+  
+  delete receiver;
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned int seed = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  
+  ZeroMQContext::init();
+  
+  printf("%-16s %9s %9s %9s %7s %7s %7s\n", "condition", "delivered", "dropped", "reordered", "p50 ms", "p99 ms", "max ms");
+  
+  for (unsigned int i = 0; i < sizeof(conditions) / sizeof(conditions[0]); i++)
+  {
+    measure(conditions[i], seed, BASE_PORT + i * 2);
+  }
+  
+  ZeroMQContext::destroy();
+  return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ *  preview_tiles.cpp
+ *  warp
+ *
+ *  Drives the preview encoder and decoder with synthetic frames, the way the
+ *  exit's screen capture would: a static desktop, a window being dragged
+ *  across it, a blinking caret, a resize and a lossy link. Every decoded
+ *  canvas is checked against a reference downscale of the frame, and the
+ *  tiles, bytes and encode time per frame are reported. Built against the
+ *  shared sources alone, for example:
+ *
+ *    g++ -O2 -I../shared preview_tiles.cpp ../shared/TileEncoder.cpp \
+ *      -o preview_tiles
+ *
+ *  The optional argument is the seed for the desktop's noise.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Clock.h"
+#include "TileEncoder.h"
+
+static const int SCREEN_WIDTH = 1000;
+static const int SCREEN_HEIGHT = 700;
+static const unsigned int FRAME_COUNT = 60;
+static const unsigned int LOSS_INTERVAL = 3;
+
+static unsigned int state = 1;
+
+static unsigned int next_random()
+{
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+class Screen
+{
+
+public:
+
+  Screen(int width, int height) : width_(width), height_(height), pixels_(width * height * 4)
+  {
+    // a gradient with a little noise, so neighbouring tiles never hash alike
+    for (int y = 0; y < height; y++)
+    {
+      for (int x = 0; x < width; x++)
+      {
+        unsigned char* pixel = &pixels_[(y * width + x) * 4];
+        pixel[0] = (unsigned char)(x * 255 / (width + 1));
+        pixel[1] = (unsigned char)(y * 255 / (height + 1));
+        pixel[2] = (unsigned char)(next_random() % 16);
+        pixel[3] = 255;
+      }
+    }
+    background_ = pixels_;
+  };
+
+  void fill(int left, int top, int width, int height, unsigned int colour)
+  {
+    for (int y = top; y < top + height && y < height_; y++)
+    {
+      for (int x = left; x < left + width && x < width_; x++)
+      {
+        memcpy(&pixels_[(y * width_ + x) * 4], &colour, 4);
+      }
+    }
+  };
+
+  void restore(int left, int top, int width, int height)
+  {
+    for (int y = top; y < top + height && y < height_; y++)
+    {
+      int count = ((left + width < width_) ? width : width_ - left) * 4;
+      memcpy(&pixels_[(y * width_ + left) * 4], &background_[(y * width_ + left) * 4], count);
+    }
+  };
+
+  Frame frame()
+  {
+    Frame frame = { width_, height_, width_ * 4, &pixels_[0] };
+    return frame;
+  };
+
+private:
+
+  int width_;
+  int height_;
+  std::vector<unsigned char> pixels_;
+  std::vector<unsigned char> background_;
+
+};
+
+// what the decoder should hold: a box filtered, RGB565 rounded copy
+static bool matches(const Frame& frame, TileDecoder& decoder)
+{
+  int width = (frame.width + PREVIEW_SCALE - 1) / PREVIEW_SCALE;
+  int height = (frame.height + PREVIEW_SCALE - 1) / PREVIEW_SCALE;
+
+  if (decoder.width() != width || decoder.height() != height)
+  {
+    return false;
+  }
+
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+    {
+      unsigned int sums[3] = { 0, 0, 0 };
+      unsigned int samples = 0;
+
+      for (int sy = y * PREVIEW_SCALE; sy < (y + 1) * (int)PREVIEW_SCALE && sy < frame.height; sy++)
+      {
+        for (int sx = x * PREVIEW_SCALE; sx < (x + 1) * (int)PREVIEW_SCALE && sx < frame.width; sx++)
+        {
+          const unsigned char* pixel = frame.pixels + sy * frame.stride + sx * 4;
+          sums[0] += pixel[0];
+          sums[1] += pixel[1];
+          sums[2] += pixel[2];
+          samples++;
+        }
+      }
+
+      const unsigned char* decoded = decoder.pixels() + (y * width + x) * 4;
+
+      if (decoded[0] != ((sums[2] / samples) & 0xf8) || decoded[1] != ((sums[1] / samples) & 0xfc) || decoded[2] != ((sums[0] / samples) & 0xf8))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+struct Totals
+{
+  unsigned int frames;
+  unsigned int tiles;
+  unsigned long long bytes;
+  unsigned long long encode_ns;
+  bool intact;
+};
+
+static void step(TileEncoder& encoder, TileDecoder& decoder, const Frame& frame, Totals& totals, bool deliver)
+{
+  std::string message;
+
+  unsigned long long started = Clock::now();
+  totals.tiles += encoder.encode(frame, message);
+  totals.encode_ns += Clock::now() - started;
+  totals.bytes += message.size();
+  totals.frames++;
+
+  if (deliver && !decoder.decode(message.data(), message.size()))
+  {
+    totals.intact = false;
+  }
+}
+
+static void report(const char* name, const Totals& totals, bool intact)
+{
+  printf("%-12s %7u %9.1f %9.0f %9.1f %s\n", name, totals.frames, (double)totals.tiles / totals.frames,
+    (double)totals.bytes / totals.frames, totals.encode_ns / 1000.0 / totals.frames,
+    (totals.intact && intact) ? "ok" : "CORRUPT");
+}
+
+int main(int argc, char* argv[])
+{
+  state = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1;
+  state = (state == 0) ? 1 : state;
+
+  printf("%-12s %7s %9s %9s %9s\n", "scene", "frames", "tiles", "bytes", "enc us");
+
+  Screen screen(SCREEN_WIDTH, SCREEN_HEIGHT);
+  TileEncoder encoder;
+  TileDecoder decoder;
+
+  // nothing moves, so only the refresh rotation goes out after the first frame
+  Totals still = { 0, 0, 0, 0, true };
+  for (unsigned int i = 0; i < FRAME_COUNT; i++)
+  {
+    step(encoder, decoder, screen.frame(), still, true);
+  }
+  report("static", still, matches(screen.frame(), decoder));
+
+  Totals drag = { 0, 0, 0, 0, true };
+  bool intact = true;
+  for (unsigned int i = 0; i < FRAME_COUNT; i++)
+  {
+    int x = 40 + i * 11;
+    int y = 60 + i * 5;
+    screen.fill(x, y, 300, 200, 0xff3070c0);
+    step(encoder, decoder, screen.frame(), drag, true);
+    intact &= matches(screen.frame(), decoder);
+    screen.restore(x, y, 300, 200);
+  }
+  report("drag", drag, intact);
+
+  Totals caret = { 0, 0, 0, 0, true };
+  intact = true;
+  for (unsigned int i = 0; i < FRAME_COUNT; i++)
+  {
+    if (i % 2 == 0)
+    {
+      screen.fill(517, 333, 2, 18, 0xff000000);
+    }
+    else
+    {
+      screen.restore(517, 333, 2, 18);
+    }
+    step(encoder, decoder, screen.frame(), caret, true);
+    intact &= matches(screen.frame(), decoder);
+  }
+  report("caret", caret, intact);
+
+  // every few messages are lost, then the screen holds still long enough for
+  // the refresh rotation to heal the canvas
+  Totals lossy = { 0, 0, 0, 0, true };
+  for (unsigned int i = 0; i < FRAME_COUNT; i++)
+  {
+    screen.fill(100 + i * 7, 400, 64, 64, 0xffe0e0e0);
+    step(encoder, decoder, screen.frame(), lossy, i % LOSS_INTERVAL != 0);
+  }
+  for (unsigned int i = 0; i < PREVIEW_REFRESH_FRAMES; i++)
+  {
+    step(encoder, decoder, screen.frame(), lossy, true);
+  }
+  report("lossy", lossy, matches(screen.frame(), decoder));
+
+  // a resolution change, then odd sizes down to a screen with no tiles at all
+  Screen small(317, 201);
+  Totals resize = { 0, 0, 0, 0, true };
+  step(encoder, decoder, small.frame(), resize, true);
+  intact = matches(small.frame(), decoder);
+
+  Screen tiny(1, 1);
+  step(encoder, decoder, tiny.frame(), resize, true);
+  intact &= matches(tiny.frame(), decoder);
+
+  Frame empty = { 0, 0, 0, 0 };
+  step(encoder, decoder, empty, resize, true);
+  step(encoder, decoder, empty, resize, true);
+  intact &= (decoder.width() == 0 && decoder.height() == 0);
+  report("resize", resize, intact);
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include "BulkCodec.h"
+
+#include "Clock.h"
+#include "Constants.hpp"
+#include "Lz4Compressor.h"
+
+BulkCodec::BulkCodec(ICompressor* compressor)
+  : compressor_(compressor)
+  , skip_(0)
+  , backoff_(1)
+  , raw_bytes_(0)
+  , sent_bytes_(0)
+{
+  
+}
+
+BulkCodec::~BulkCodec()
+{
+  delete compressor_;
+}
+
+void BulkCodec::set_compressor(ICompressor* compressor)
+{
+  delete compressor_;
+  compressor_ = compressor;
+  skip_ = 0;
+  backoff_ = 1;
+}
+
+void BulkCodec::back_off()
+{
+  skip_ = backoff_;
+  backoff_ = (backoff_ < BULK_COMPRESS_MAX_BACKOFF) ? backoff_ * 2 : BULK_COMPRESS_MAX_BACKOFF;
+}
+
+int BulkCodec::encode(const char* data, size_t size, std::string& out)
+{
+  raw_bytes_ += size;
+  
+  if (compressor_ == 0 || size < BULK_COMPRESS_MIN_SIZE)
+  {
+    sent_bytes_ += size;
+    return CODEC_NONE;
+  }
+  
+  if (skip_ > 0)
+  {
+    skip_--;
+    sent_bytes_ += size;
+    return CODEC_NONE;
+  }
+  
+  buffer_.resize(compressor_->bound(size));
+  
+  unsigned long long started = Clock::now();
+  size_t compressed = compressor_->compress(data, size, &buffer_[0], buffer_.size());
+  unsigned long long elapsed_us = (Clock::now() - started) / 1000 + 1;
+  
+  // a frame has to save an eighth of itself, and compressing it has to keep
+  // up with the link, or it goes out raw
+  bool smaller = compressed > 0 && compressed <= size - size / 8;
+  bool fast = size / elapsed_us >= BULK_COMPRESS_MIN_RATE;
+  
+  if (!smaller || !fast)
+  {
+    back_off();
+    sent_bytes_ += size;
+    return CODEC_NONE;
+  }
+  
+  backoff_ = 1;
+  sent_bytes_ += compressed;
+  out.assign(buffer_.data(), compressed);
+  return compressor_->codec();
+}
+
+bool BulkCodec::decode(int codec, const char* data, size_t data_size, size_t size, std::string& out)
+{
+  if (codec == CODEC_NONE)
+  {
+    out.assign(data, data_size);
+    return data_size == size;
+  }
+  
+  if (codec != CODEC_LZ4 || size > BULK_DECODE_LIMIT)
+  {
+    return false;
+  }
+  
+  out.resize(size);
+  return Lz4Compressor().decompress(data, data_size, (size > 0) ? &out[0] : 0, size);
+}
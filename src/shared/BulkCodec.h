@@ -0,0 +1,57 @@
+#ifndef BULKCODEC_H_
+#define BULKCODEC_H_
+
+  #include <string>
+
+  #include "ICompressor.hpp"
+
+  /*
+   * Per frame compression for the bulk channels: clipboard, file transfer
+   * and preview. The input lane never goes through here. A codec without a
+   * compressor sends everything as CODEC_NONE, which is how compression
+   * stays optional; decode() understands every codec regardless, so only the
+   * sending side has to opt in.
+   *
+   * Frames that are short, barely shrink or compress slower than
+   * BULK_COMPRESS_MIN_RATE are sent raw, and the codec then stops trying
+   * for a doubling number of frames, so already compressed files and noisy
+   * screens cost next to nothing after the first few frames.
+   */
+  class BulkCodec
+  {
+    
+  public:
+    
+    BulkCodec(ICompressor* compressor = 0);
+    
+    ~BulkCodec();
+    
+    // fills out and returns its codec, or returns CODEC_NONE to send data as is
+    int encode(const char* data, size_t size, std::string& out);
+    
+    static bool decode(int codec, const char* data, size_t data_size, size_t size, std::string& out);
+    
+    void set_compressor(ICompressor* compressor);
+    
+    inline bool enabled() { return compressor_ != 0; };
+    
+    inline unsigned long long raw_bytes() { return raw_bytes_; };
+    
+    inline unsigned long long sent_bytes() { return sent_bytes_; };
+    
+  private:
+    
+    void back_off();
+    
+    ICompressor* compressor_;
+    std::string buffer_;
+    
+    unsigned int skip_;
+    unsigned int backoff_;
+    
+    unsigned long long raw_bytes_;
+    unsigned long long sent_bytes_;
+    
+  };
+
+#endif
@@ -10,19 +10,51 @@
 #include "Client.h"
 #include "Constants.hpp"
 
-void Client::update_input(float delta)
+void Client::update()
 {
-  if (connected_ && timeout_ > 0)
-  {
-    timeout_ -= delta;
+  timers_.advance(Clock::now_ms());
   
-    if (timeout_ <= 0)
+  // the exit dropped the connection, no need to wait out the idle timeout
+  if (connected_ && socket_->link_lost())
+  {
+    disconnect();
+  }
+}
+
+void Client::on_timer(int timer_id)
+{
+  if (timer_id == timeout_timer_)
+  {
+    timeout_timer_ = 0;
+    
+    if (connected_)
     {
       disconnect();
     }
   }
 }
 
+void Client::reset_timeout()
+{
+  timers_.cancel(timeout_timer_);
+  timeout_timer_ = 0;
+  
+  if (idle_timeout_ > 0)
+  {
+    timeout_timer_ = timers_.schedule(Clock::now_ms(), idle_timeout_, this);
+  }
+}
+
+void Client::set_idle_timeout(unsigned int timeout_ms)
+{
+  idle_timeout_ = timeout_ms;
+  
+  if (connected_)
+  {
+    reset_timeout();
+  }
+}
+
 void Client::update_search()
 {
 //  ISocket::received_data* datas = m_recv_socket_->receive();
@@ -39,7 +71,7 @@ void Client::update_search()
 bool Client::connect_to(const std::string& host, unsigned int port)
 {	
   connected_ = socket_->connect_to(host, port);
-	timeout_ = TIME_OUT;
+	reset_timeout();
 	last_host_ = host;
   return connected_;
 }
@@ -72,6 +104,11 @@ void Client::search_for_hosts()
 void Client::disconnect()
 {
 	connected_ = false;
+  timers_.cancel(timeout_timer_);
+  timeout_timer_ = 0;
+  scroll_x_ = 0;
+  scroll_y_ = 0;
+  text_.clear();
   socket_->terminate();
 }
 
@@ -80,17 +117,36 @@ bool Client::can_reconnect()
 	return (last_host_.length() > 0);
 }
 
+unsigned int Client::new_session()
+{
+  // only has to tell the controllers of one exit apart, not be unguessable
+  unsigned int session = (unsigned int)(Clock::now() ^ reinterpret_cast<size_t>(this));
+  return (session == 0) ? 1 : session;
+}
+
 bool Client::send_message(const Message& message)
 {	
+  // a click or key must not overtake scroll or text still held back
+  if (message.type != TEXT && !text_.empty())
+  {
+    flush_text();
+  }
+  
+  if (message.type != SCROLL_WHEEL && scroll_pending())
+  {
+    flush_scroll();
+  }
+  
 	if (!connected_)
 	{
 		reconnect();
 	}
 	
-	timeout_ = TIME_OUT;
+	reset_timeout();
   int message_size = sizeof(Message);
 	char* data = new char[message_size];
 	memcpy(data, &message, message_size);
+	reinterpret_cast<Message*>(data)->session = session_;
   return socket_->send(data, message_size);
 }
 
@@ -156,6 +212,15 @@ bool Client::send_mouse_moved(int x, int y)
 	return send_message(message);
 }
 
+bool Client::send_mouse_position(int x, int y)
+{
+	Message message;
+	message.type = MOUSE_POSITION;
+	message.x = x;
+	message.y = y;
+	return send_message(message);
+}
+
 bool Client::send_left_dragged(int x, int y)
 {
 	Message message;
@@ -183,11 +248,174 @@ bool Client::send_flags(int key_code, unsigned int flags)
 	return send_message(message);
 }
 
+bool Client::send_touch_samples(const TouchSampleList& samples)
+{
+  if (samples.empty())
+  {
+    return true;
+  }
+  
+  double x = 0;
+  double y = 0;
+  
+  for (TouchSampleList::const_iterator sample = samples.begin(); sample != samples.end(); ++sample)
+  {
+    x += sample->x;
+    y += sample->y;
+  }
+  
+  // the span runs from the end of the previous batch; the first batch of a
+  // new stroke has nothing before it, so it is taken to cover one frame
+  double start = samples.front().timestamp - TOUCH_FRAME_INTERVAL / 1000.0;
+  
+  if (last_touch_ > 0 && samples.front().timestamp - last_touch_ < TOUCH_STROKE_GAP / 1000.0)
+  {
+    start = last_touch_;
+  }
+  
+  last_touch_ = samples.back().timestamp;
+  
+	Message message;
+	message.type = TOUCH_MOVE;
+	message.x = (int)(x * TOUCH_FIXED_ONE);
+	message.y = (int)(y * TOUCH_FIXED_ONE);
+	message.key_code = (int)((last_touch_ - start) * 1000000);
+	message.flags = samples.size();
+	return send_message(message);
+}
+
 bool Client::send_scroll_wheel(int x, int y)
 {
+  scroll_x_ += x;
+  scroll_y_ += y;
+  
+  // trackpads report far faster than the exit can redraw, so at most one
+  // scroll goes out per frame and the rest is summed until flush_scroll
+  if (Clock::now_ms() - last_scroll_ < SCROLL_FRAME_INTERVAL)
+  {
+    return true;
+  }
+  
+  return flush_scroll();
+}
+
+bool Client::flush_scroll()
+{
+  if (!scroll_pending())
+  {
+    return true;
+  }
+  
 	Message message;
 	message.type = SCROLL_WHEEL;
+	message.x = scroll_x_;
+	message.y = scroll_y_;
+  scroll_x_ = 0;
+  scroll_y_ = 0;
+  last_scroll_ = Clock::now_ms();
+	return send_message(message);
+}
+static size_t text_boundary(const std::string& text, size_t limit)
+{
+  if (text.length() <= limit)
+  {
+    return text.length();
+  }
+  
+  // never split a multi-byte sequence across two messages
+  size_t end = limit;
+  while (end > 0 && (text[end] & 0xC0) == 0x80)
+  {
+    end--;
+  }
+  return (end > 0) ? end : limit;
+}
+
+bool Client::send_text(const std::string& utf8)
+{
+  text_ += utf8;
+  
+  // only full messages go out now, the tail waits for more or for flush_text
+  while (text_.length() >= (size_t)MESSAGE_TEXT_SIZE)
+  {
+    if (!send_text_message())
+    {
+      return false;
+    }
+  }
+  
+  return true;
+}
+
+bool Client::flush_text()
+{
+  while (!text_.empty())
+  {
+    if (!send_text_message())
+    {
+      return false;
+    }
+  }
+  
+  return true;
+}
+
+bool Client::send_text_message()
+{
+  size_t length = text_boundary(text_, MESSAGE_TEXT_SIZE);
+  
+  Message message;
+  message.type = TEXT;
+  memset(message.text, 0, sizeof(message.text));
+  memcpy(message.text, text_.data(), length);
+  text_.erase(0, length);
+  
+  if (!send_message(message))
+  {
+    text_.clear();
+    return false;
+  }
+  
+  return true;
+}
+
+bool Client::begin_macro(int id)
+{
+	Message message;
+	message.type = MACRO_BEGIN;
+	message.key_code = id;
+	return send_message(message);
+}
+
+bool Client::send_macro_wait(unsigned int delay_ms)
+{
+	Message message;
+	message.type = MACRO_WAIT;
+	message.x = delay_ms;
+	return send_message(message);
+}
+
+bool Client::end_macro()
+{
+	Message message;
+	message.type = MACRO_END;
+	return send_message(message);
+}
+
+bool Client::run_macro(int id, int x, int y, unsigned int repeat)
+{
+	Message message;
+	message.type = MACRO_RUN;
+	message.key_code = id;
 	message.x = x;
-	message.y = y;	
+	message.y = y;
+	message.flags = repeat;
 	return send_message(message);
-}
\ No newline at end of file
+}
+
+bool Client::cancel_macros()
+{
+	Message message;
+	message.type = MACRO_CANCEL;
+	return send_message(message);
+}
@@ -6,27 +6,59 @@
   #include <vector>
 
   #include "ZeroMQSendSocket.h"
+  #include "IReactorHandler.hpp"
+  #include "TimerWheel.h"
+  #include "Clock.h"
+  #include "Constants.hpp"
+  #include "TouchSample.h"
 
   typedef std::vector<std::string> StringList;  
 
-	class Client
+	class Client : public ITimerHandler
 	{
 		
 	public:
 		
     Client()
       : connected_(false)
-      , timeout_(0)
+      , timeout_timer_(0)
+      , idle_timeout_(TIME_OUT)
       , last_host_("") 
+      , timers_(Clock::now_ms())
+      , session_(new_session())
+      , scroll_x_(0)
+      , scroll_y_(0)
+      , last_scroll_(0)
+      , last_touch_(0)
     { 
       socket_ = new ZeroMQSendSocket();      
+    };
+    
+    Client(ISendSocket* socket)
+      : connected_(false)
+      , timeout_timer_(0)
+      , idle_timeout_(TIME_OUT)
+      , last_host_("") 
+      , timers_(Clock::now_ms())
+      , socket_(socket)
+      , session_(new_session())
+      , scroll_x_(0)
+      , scroll_y_(0)
+      , last_scroll_(0)
+      , last_touch_(0)
+    { 
+      
     };
     
 		bool connected() { return connected_; };
 		
+		unsigned int session() { return session_; };
+		
 		bool connect_to(const std::string& host, unsigned int port);
 		
-		void update_input(float delta);
+		void update();
+    
+    void on_timer(int timer_id);
     
     void update_search();
 		
@@ -48,6 +80,12 @@
 		
 		bool send_mouse_moved(int x, int y);
 		
+		bool send_mouse_position(int x, int y);
+		
+		bool send_touch_samples(const TouchSampleList& samples);
+		
+		void set_idle_timeout(unsigned int timeout_ms);
+		
 		bool send_key_down(unsigned int flags, int key_code);
 		
 		bool send_key_up(unsigned int flags, int key_code);
@@ -56,6 +94,28 @@
 		
 		bool send_scroll_wheel(int x, int y);
 		
+		bool flush_scroll();
+		
+		bool scroll_pending() { return scroll_x_ != 0 || scroll_y_ != 0; };
+		
+		bool send_text(const std::string& utf8);
+		
+		bool flush_text();
+		
+		bool flush() { return flush_text() && flush_scroll(); };
+		
+		bool pending() { return scroll_pending() || !text_.empty(); };
+		
+		bool begin_macro(int id);
+		
+		bool send_macro_wait(unsigned int delay_ms);
+		
+		bool end_macro();
+		
+		bool run_macro(int id, int x, int y, unsigned int repeat);
+		
+		bool cancel_macros();
+		
 		bool send_left_double_click();
     
     void search_for_hosts();
@@ -67,14 +127,31 @@
 		bool can_reconnect();
 		
 		bool send_message(const Message& message);
+		
+		bool send_text_message();
+    
+    void reset_timeout();
+    
+    unsigned int new_session();
     
     ISendSocket* socket_;
 		
 		std::string last_host_;
     StringList new_known_hosts_;
 		
-		float timeout_;
+		TimerWheel timers_;
+		int timeout_timer_;
+		unsigned int idle_timeout_;
+		unsigned int session_;
 		bool connected_;
+		
+		int scroll_x_;
+		int scroll_y_;
+		unsigned long long last_scroll_;
+		
+		std::string text_;
+		
+		double last_touch_;
 	};
 
 #endif
\ No newline at end of file
@@ -0,0 +1,518 @@
+#include "ClipboardChannel.h"
+
+#include <zmq.hpp>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "Lz4Compressor.h"
+#include "Reactor.h"
+#include "ZeroMQContext.hpp"
+
+ClipboardChannel::ClipboardChannel()
+  : socket_(0)
+  , inbox_(0)
+  , inbox_handler_(this)
+  , reactor_(0)
+  , listener_(0)
+  , timer_(0)
+  , routed_(false)
+  , digest_(0)
+  , offered_digest_(0)
+  , offered_size_(0)
+  , transferring_(false)
+{
+  inbox_ = ZeroMQContext::instance()->create_socket(ZMQ_PULL);
+  
+  try {
+    inbox_->bind(inbox_address().c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+ClipboardChannel::~ClipboardChannel()
+{
+  if (reactor_ != 0)
+  {
+    reactor_->cancel_timer(timer_);
+    reactor_->remove(this);
+    reactor_->remove(&inbox_handler_);
+  }
+  
+  delete socket_;
+  delete inbox_;
+}
+
+std::string ClipboardChannel::inbox_address()
+{
+  std::stringstream address;
+  address << "inproc://clipboard-" << this;
+  return address.str();
+}
+
+bool ClipboardChannel::bind(unsigned int port)
+{
+  std::stringstream address;
+  address << "tcp://*:" << port;
+  
+  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_XREP, ZeroMQContext::BULK_LANE);
+  routed_ = true;
+  
+  try {
+    socket_->bind(address.str().c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void ClipboardChannel::attach(Reactor* reactor, IClipboardListener* listener)
+{
+  reactor_ = reactor;
+  listener_ = listener;
+  
+  reactor->add_socket(*inbox_, &inbox_handler_);
+  timer_ = reactor->add_timer(CLIPBOARD_RETRY_INTERVAL, this);
+  
+  if (socket_ != 0)
+  {
+    reactor->add_socket(*socket_, this);
+  }
+}
+
+void ClipboardChannel::post(const ClipboardFrame& frame, const std::string& payload)
+{
+  try {
+    zmq::socket_t* socket = ZeroMQContext::instance()->create_socket(ZMQ_PUSH);
+    socket->connect(inbox_address().c_str());
+    
+    zmq::message_t message(sizeof(frame) + payload.size());
+    memcpy(message.data(), &frame, sizeof(frame));
+    memcpy((char*)message.data() + sizeof(frame), payload.data(), payload.size());
+    socket->send(message);
+    
+    delete socket;
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+void ClipboardChannel::connect_to(const std::string& host, unsigned int port)
+{
+  ClipboardFrame frame = { CLIPBOARD_CONNECT, 0, port, 0 };
+  post(frame, host);
+}
+
+void ClipboardChannel::offer(const std::string& content)
+{
+  ClipboardFrame frame = { CLIPBOARD_OFFER, 0, (unsigned int)content.size(), 0 };
+  post(frame, content);
+}
+
+void ClipboardChannel::fetch(unsigned long long digest)
+{
+  ClipboardFrame frame = { CLIPBOARD_FETCH, digest, 0, 0 };
+  post(frame, "");
+}
+
+void ClipboardChannel::set_compression(bool enabled)
+{
+  codec_.set_compressor(enabled ? new Lz4Compressor() : 0);
+}
+
+void ClipboardChannel::drain_inbox()
+{
+  zmq::message_t message;
+  
+  while (inbox_->recv(&message, ZMQ_NOBLOCK))
+  {
+    if (message.size() < sizeof(ClipboardFrame))
+    {
+      continue;
+    }
+    
+    ClipboardFrame frame;
+    memcpy(&frame, message.data(), sizeof(frame));
+    handle_command(frame, std::string((char*)message.data() + sizeof(frame), message.size() - sizeof(frame)));
+  }
+}
+
+void ClipboardChannel::handle_command(const ClipboardFrame& frame, const std::string& payload)
+{
+  switch (frame.type)
+  {
+    case CLIPBOARD_CONNECT:
+      open(payload, frame.size);
+      break;
+      
+    case CLIPBOARD_OFFER:
+      set_content(payload);
+      break;
+      
+    case CLIPBOARD_FETCH:
+    {
+      ContentCache::iterator cached = cache_.find(frame.digest);
+      
+      if (cached != cache_.end())
+      {
+        listener_->on_clipboard_ready(frame.digest, (*cached).second);
+      }
+      else if (frame.digest == offered_digest_)
+      {
+        if (!transferring_ || transfer_.digest != frame.digest)
+        {
+          transfer_.digest = offered_digest_;
+          transfer_.size = offered_size_;
+          transfer_.peer = offered_peer_;
+          transfer_.content.assign(offered_size_, '\0');
+          transfer_.chunks.assign(clipboard_chunks(offered_size_), false);
+          transfer_.received = 0;
+          transferring_ = true;
+        }
+        
+        // asking again restarts the window and the timeout
+        transfer_.stalled = 0;
+        restart_window();
+      }
+      break;
+    }
+  }
+}
+
+void ClipboardChannel::open(const std::string& host, unsigned int port)
+{
+  if (socket_ != 0)
+  {
+    if (reactor_ != 0)
+    {
+      reactor_->remove(this);
+    }
+    delete socket_;
+  }
+  
+  std::stringstream address;
+  address << "tcp://" << host << ":" << port;
+  
+  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_XREQ, ZeroMQContext::BULK_LANE);
+  routed_ = false;
+  
+  try {
+    socket_->connect(address.str().c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return;
+  }
+  
+  if (reactor_ != 0)
+  {
+    reactor_->add_socket(*socket_, this);
+  }
+  
+  // a fresh peer has not seen our current content yet, and needs to hear
+  // from us before it can offer its own
+  ClipboardFrame hello = { CLIPBOARD_HELLO, 0, 0, 0 };
+  send_frame(peer_, hello, 0, 0);
+  
+  if (!content_.empty())
+  {
+    ClipboardFrame frame = { CLIPBOARD_OFFER, digest_, (unsigned int)content_.size(), 0 };
+    send_frame(peer_, frame, 0, 0);
+  }
+}
+
+void ClipboardChannel::set_content(const std::string& content)
+{
+  unsigned long long digest = clipboard_digest(content);
+  
+  // unchanged, or just pulled from the peer, so there is nothing to announce
+  if (digest == digest_ || digest == offered_digest_)
+  {
+    return;
+  }
+  
+  digest_ = digest;
+  content_ = content;
+  
+  if (socket_ != 0 && (!routed_ || !peer_.empty()))
+  {
+    ClipboardFrame frame = { CLIPBOARD_OFFER, digest_, (unsigned int)content_.size(), 0 };
+    send_frame(peer_, frame, 0, 0);
+  }
+}
+
+bool ClipboardChannel::send_frame(const std::string& peer, const ClipboardFrame& frame, const char* payload, size_t size)
+{
+  try {
+    if (routed_)
+    {
+      zmq::message_t identity(peer.size());
+      memcpy(identity.data(), peer.data(), peer.size());
+      socket_->send(identity, ZMQ_SNDMORE);
+    }
+    
+    zmq::message_t message(sizeof(frame) + size);
+    memcpy(message.data(), &frame, sizeof(frame));
+    if (size > 0)
+    {
+      memcpy((char*)message.data() + sizeof(frame), payload, size);
+    }
+    return socket_->send(message, ZMQ_NOBLOCK);
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+  return false;
+}
+
+void ClipboardChannel::on_readable()
+{
+  zmq::message_t part;
+  std::string peer;
+  
+  while (socket_->recv(&part, ZMQ_NOBLOCK))
+  {
+    long long more = 0;
+    size_t more_size = sizeof(more);
+    socket_->getsockopt(ZMQ_RCVMORE, &more, &more_size);
+    
+    if (more)
+    {
+      peer.assign((char*)part.data(), part.size());
+      continue;
+    }
+    
+    if (part.size() >= sizeof(ClipboardFrame))
+    {
+      ClipboardFrame frame;
+      memcpy(&frame, part.data(), sizeof(frame));
+      handle_frame(peer, frame, (char*)part.data() + sizeof(frame), part.size() - sizeof(frame));
+    }
+    
+    peer.clear();
+  }
+}
+
+void ClipboardChannel::handle_frame(const std::string& peer, const ClipboardFrame& frame, const char* payload, size_t size)
+{
+  if (routed_)
+  {
+    peer_ = peer;
+  }
+  
+  switch (frame.type)
+  {
+    case CLIPBOARD_HELLO:
+      if (routed_ && !content_.empty())
+      {
+        ClipboardFrame offer = { CLIPBOARD_OFFER, digest_, (unsigned int)content_.size(), 0 };
+        send_frame(peer_, offer, 0, 0);
+      }
+      break;
+      
+    case CLIPBOARD_OFFER:
+      if (frame.digest == digest_ || frame.digest == offered_digest_ || frame.size > CLIPBOARD_MAX_SIZE)
+      {
+        return;
+      }
+      
+      offered_digest_ = frame.digest;
+      offered_size_ = frame.size;
+      offered_peer_ = peer;
+      
+      if (listener_ != 0)
+      {
+        listener_->on_clipboard_offered(frame.digest, frame.size);
+      }
+      break;
+      
+    case CLIPBOARD_FETCH:
+      serve(peer, frame);
+      break;
+      
+    case CLIPBOARD_CHUNK:
+    {
+      if (!transferring_ || frame.digest != transfer_.digest || frame.size != transfer_.size || frame.index >= transfer_.chunks.size() || transfer_.chunks[frame.index])
+      {
+        return;
+      }
+      
+      unsigned int offset = frame.index * CLIPBOARD_CHUNK_SIZE;
+      unsigned int expected = transfer_.size - offset;
+      expected = (expected > CLIPBOARD_CHUNK_SIZE) ? CLIPBOARD_CHUNK_SIZE : expected;
+      std::string unpacked;
+      
+      if (frame.codec != CODEC_NONE)
+      {
+        if (!BulkCodec::decode(frame.codec, payload, size, expected, unpacked))
+        {
+          return;
+        }
+        payload = unpacked.data();
+        size = unpacked.size();
+      }
+      
+      // only the last chunk may be short, and only by what the size says
+      if (size != expected)
+      {
+        return;
+      }
+      
+      memcpy(&transfer_.content[offset], payload, size);
+      transfer_.chunks[frame.index] = true;
+      transfer_.received++;
+      transfer_.stalled = 0;
+      
+      if (transfer_.in_flight > 0)
+      {
+        transfer_.in_flight--;
+      }
+      
+      if (transfer_.received < transfer_.chunks.size())
+      {
+        request_chunks();
+        return;
+      }
+      
+      transferring_ = false;
+      
+      if (clipboard_digest(transfer_.content) != transfer_.digest)
+      {
+        std::cerr << "clipboard digest mismatch" << std::endl;
+        return;
+      }
+      
+      remember(transfer_.digest, transfer_.content);
+      
+      if (listener_ != 0)
+      {
+        listener_->on_clipboard_ready(transfer_.digest, transfer_.content);
+      }
+      break;
+    }
+  }
+}
+
+void ClipboardChannel::serve(const std::string& peer, const ClipboardFrame& request)
+{
+  const std::string* content = 0;
+  
+  if (request.digest == digest_)
+  {
+    content = &content_;
+  }
+  else
+  {
+    ContentCache::iterator cached = cache_.find(request.digest);
+    if (cached != cache_.end())
+    {
+      content = &(*cached).second;
+    }
+  }
+  
+  if (content == 0 || request.index >= clipboard_chunks(content->size()))
+  {
+    return;
+  }
+  
+  unsigned int offset = request.index * CLIPBOARD_CHUNK_SIZE;
+  unsigned int size = (unsigned int)content->size() - offset;
+  if (size > CLIPBOARD_CHUNK_SIZE)
+  {
+    size = CLIPBOARD_CHUNK_SIZE;
+  }
+  
+  ClipboardFrame frame = { CLIPBOARD_CHUNK, request.digest, (unsigned int)content->size(), request.index };
+  
+  std::string packed;
+  frame.codec = codec_.encode(content->data() + offset, size, packed);
+  
+  if (frame.codec != CODEC_NONE)
+  {
+    send_frame(peer, frame, packed.data(), packed.size());
+    return;
+  }
+  
+  send_frame(peer, frame, content->data() + offset, size);
+}
+
+void ClipboardChannel::request_chunks()
+{
+  unsigned int count = (unsigned int)transfer_.chunks.size();
+  
+  if (count == 0)
+  {
+    transferring_ = false;
+    remember(transfer_.digest, transfer_.content);
+    listener_->on_clipboard_ready(transfer_.digest, transfer_.content);
+    return;
+  }
+  
+  while (transfer_.next < count && transfer_.in_flight < CLIPBOARD_WINDOW)
+  {
+    if (!transfer_.chunks[transfer_.next])
+    {
+      ClipboardFrame frame = { CLIPBOARD_FETCH, transfer_.digest, transfer_.size, transfer_.next };
+      
+      // a full queue is retried from the same chunk on the next timer tick
+      if (!send_frame(transfer_.peer, frame, 0, 0))
+      {
+        return;
+      }
+      transfer_.in_flight++;
+    }
+    transfer_.next++;
+  }
+}
+
+void ClipboardChannel::restart_window()
+{
+  transfer_.next = 0;
+  transfer_.in_flight = 0;
+  request_chunks();
+}
+
+void ClipboardChannel::on_timer(int timer_id)
+{
+  if (!transferring_)
+  {
+    return;
+  }
+  
+  transfer_.stalled++;
+  
+  if (transfer_.stalled * CLIPBOARD_RETRY_INTERVAL >= CLIPBOARD_FETCH_TIMEOUT)
+  {
+    std::cerr << "clipboard transfer timed out" << std::endl;
+    transferring_ = false;
+    return;
+  }
+  
+  // no chunk arrived for a whole interval, so ask again for what is missing
+  if (transfer_.stalled > 1)
+  {
+    restart_window();
+  }
+}
+
+void ClipboardChannel::remember(unsigned long long digest, const std::string& content)
+{
+  if (cache_.find(digest) != cache_.end())
+  {
+    return;
+  }
+  
+  if (cache_order_.size() >= CLIPBOARD_CACHE_SIZE)
+  {
+    cache_.erase(cache_order_.front());
+    cache_order_.pop_front();
+  }
+  
+  cache_[digest] = content;
+  cache_order_.push_back(digest);
+}
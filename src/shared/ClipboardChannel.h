@@ -0,0 +1,153 @@
+#ifndef CLIPBOARDCHANNEL_H_
+#define CLIPBOARDCHANNEL_H_
+
+  #include <deque>
+  #include <map>
+  #include <string>
+  #include <vector>
+
+  #include "BulkCodec.h"
+  #include "ClipboardProtocol.h"
+  #include "IReactorHandler.hpp"
+
+  namespace zmq { class socket_t; };
+
+  class Reactor;
+
+  class IClipboardListener
+  {
+    
+  public:
+    
+    virtual void on_clipboard_offered(unsigned long long digest, unsigned int size) = 0;
+    
+    virtual void on_clipboard_ready(unsigned long long digest, const std::string& content) = 0;
+    
+  };
+
+  /*
+   * Clipboard sync on its own socket next to the input stream.
+   *
+   * The bound side (the exit) uses XREP so it can answer whichever controller
+   * asked; the connecting side uses XREQ. Content is only ever announced by
+   * digest, fetched in CLIPBOARD_CHUNK_SIZE pieces with at most
+   * CLIPBOARD_WINDOW in flight, and kept in a small cache so the same content
+   * is never pulled twice. Either side may offer; a transfer that stops making
+   * progress re-requests its missing chunks every CLIPBOARD_RETRY_INTERVAL and
+   * is dropped after CLIPBOARD_FETCH_TIMEOUT.
+   *
+   * Like the Reactor it runs on, the channel must be created, bound and
+   * attached on the network thread. offer(), fetch() and connect_to() may be
+   * called from any thread.
+   */
+  class ClipboardChannel : public IReactorHandler, public ITimerHandler
+  {
+    
+    class Inbox : public IReactorHandler
+    {
+      
+    public:
+      
+      Inbox(ClipboardChannel* channel) : channel_(channel) { };
+      
+      void on_readable() { channel_->drain_inbox(); };
+      
+    private:
+      
+      ClipboardChannel* channel_;
+      
+    };
+    
+    struct Transfer
+    {
+      unsigned long long digest;
+      unsigned int size;
+      unsigned int next;
+      unsigned int received;
+      unsigned int in_flight;
+      unsigned int stalled;
+      std::vector<bool> chunks;
+      std::string content;
+      std::string peer;
+    };
+    
+    typedef std::map<unsigned long long, std::string> ContentCache;
+    
+  public:
+    
+    ClipboardChannel();
+    
+    ~ClipboardChannel();
+    
+    bool bind(unsigned int port);
+    
+    void attach(Reactor* reactor, IClipboardListener* listener);
+    
+    void on_readable();
+    
+    void on_timer(int timer_id);
+    
+    void connect_to(const std::string& host, unsigned int port);
+    
+    void offer(const std::string& content);
+    
+    void fetch(unsigned long long digest);
+    
+    // call before attach, it is not thread safe like offer and fetch
+    void set_compression(bool enabled);
+    
+  private:
+    
+    void drain_inbox();
+    
+    void post(const ClipboardFrame& frame, const std::string& payload);
+    
+    bool send_frame(const std::string& peer, const ClipboardFrame& frame, const char* payload, size_t size);
+    
+    void handle_command(const ClipboardFrame& frame, const std::string& payload);
+    
+    void handle_frame(const std::string& peer, const ClipboardFrame& frame, const char* payload, size_t size);
+    
+    void open(const std::string& host, unsigned int port);
+    
+    void set_content(const std::string& content);
+    
+    void serve(const std::string& peer, const ClipboardFrame& request);
+    
+    void request_chunks();
+    
+    void restart_window();
+    
+    void remember(unsigned long long digest, const std::string& content);
+    
+    std::string inbox_address();
+    
+    zmq::socket_t* socket_;
+    zmq::socket_t* inbox_;
+    Inbox inbox_handler_;
+    
+    Reactor* reactor_;
+    IClipboardListener* listener_;
+    int timer_;
+    
+    bool routed_;
+    std::string peer_;
+    
+    unsigned long long digest_;
+    std::string content_;
+    
+    unsigned long long offered_digest_;
+    unsigned int offered_size_;
+    std::string offered_peer_;
+    
+    Transfer transfer_;
+    bool transferring_;
+    
+    BulkCodec codec_;
+    
+    ContentCache cache_;
+    std::deque<unsigned long long> cache_order_;
+    
+  };
+
+#endif
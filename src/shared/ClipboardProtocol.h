@@ -0,0 +1,58 @@
+#ifndef CLIPBOARDPROTOCOL_H_
+#define CLIPBOARDPROTOCOL_H_
+
+  #include <string>
+
+  enum ClipboardFrameTypes
+  {
+    CLIPBOARD_OFFER = 1,
+    CLIPBOARD_FETCH = 2,
+    CLIPBOARD_CHUNK = 3,
+    CLIPBOARD_CONNECT = 4,
+    CLIPBOARD_HELLO = 5
+  };
+
+  /*
+   * Header of every frame on the clipboard channel. OFFER announces content by
+   * digest and size only; the bytes follow as CHUNK frames, and only when the
+   * other side asks for them with FETCH. A CHUNK's codec says how its bytes
+   * were compressed, see BulkCodec. HELLO is sent once on connect so the bound
+   * side learns who to offer its own content to.
+   */
+  struct ClipboardFrame
+  {
+    int type;
+    unsigned long long digest;
+    unsigned int size;
+    unsigned int index;
+    unsigned int codec;
+  };
+
+  static const unsigned int CLIPBOARD_PORT = 44200;
+  static const unsigned int CLIPBOARD_CHUNK_SIZE = 16384;
+  static const unsigned int CLIPBOARD_WINDOW = 8;
+  static const unsigned int CLIPBOARD_CACHE_SIZE = 16;
+  static const unsigned int CLIPBOARD_FETCH_TIMEOUT = 2000;
+  static const unsigned int CLIPBOARD_RETRY_INTERVAL = 250;
+  static const unsigned int CLIPBOARD_MAX_SIZE = 64 * 1024 * 1024;
+
+  // 64 bit FNV-1a, good enough to tell clipboard contents apart
+  inline unsigned long long clipboard_digest(const std::string& content)
+  {
+    unsigned long long digest = 14695981039346656037ULL;
+    
+    for (std::string::size_type i = 0; i < content.size(); i++)
+    {
+      digest ^= (unsigned char)content[i];
+      digest *= 1099511628211ULL;
+    }
+    
+    return digest;
+  }
+
+  inline unsigned int clipboard_chunks(unsigned int size)
+  {
+    return (size + CLIPBOARD_CHUNK_SIZE - 1) / CLIPBOARD_CHUNK_SIZE;
+  }
+
+#endif
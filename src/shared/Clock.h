@@ -0,0 +1,54 @@
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#ifdef _WIN32
+  #include <windows.h>
+#elif defined(__APPLE__)
+  #include <mach/mach_time.h>
+#else
+  #include <time.h>
+#endif
+
+  /*
+   * Monotonic clock for input timing. Unlike wall-clock time it never steps
+   * or wraps, so deltas between two readings are always safe to compare.
+   */
+  class Clock
+  {
+    
+  public:
+    
+    static unsigned long long now()
+    {
+#ifdef _WIN32
+      static LARGE_INTEGER frequency = { 0 };
+      if (frequency.QuadPart == 0)
+      {
+        QueryPerformanceFrequency(&frequency);
+      }
+      LARGE_INTEGER counter;
+      QueryPerformanceCounter(&counter);
+      return (unsigned long long)((counter.QuadPart / frequency.QuadPart) * 1000000000ULL +
+        ((counter.QuadPart % frequency.QuadPart) * 1000000000ULL) / frequency.QuadPart);
+#elif defined(__APPLE__)
+      static mach_timebase_info_data_t timebase = { 0, 0 };
+      if (timebase.denom == 0)
+      {
+        mach_timebase_info(&timebase);
+      }
+      return (mach_absolute_time() * timebase.numer) / timebase.denom;
+#else
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return ((unsigned long long)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+#endif
+    }
+    
+    static unsigned long long now_ms()
+    {
+      return now() / 1000000ULL;
+    }
+    
+  };
+
+#endif
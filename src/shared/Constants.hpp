@@ -4,5 +4,22 @@
 	static const unsigned int SERVER_PORT = 44199;
 	static const unsigned int DOUBLE_CLICK_THRESHOLD = 300;
 	static const unsigned int TIME_OUT = 5000;
+	static const unsigned int BROADCAST_HWM = 256;
+	static const unsigned int BROADCAST_DROP_LIMIT = 64;
+	static const unsigned int ARBITRATION_TIMEOUT = 2000;
+	static const unsigned int SESSION_QUEUE_LIMIT = 256;
+	static const unsigned int SESSION_EXPIRY = 60000;
+	static const unsigned int SCROLL_FRAME_INTERVAL = 16;
+	static const unsigned int MACRO_LIMIT = 64;
+	static const unsigned int MACRO_STEP_LIMIT = 4096;
+	static const unsigned int MACRO_REPEAT_LIMIT = 1000;
+	static const unsigned int MACRO_BATCH_LIMIT = 64;
+	static const unsigned int TOUCH_FRAME_INTERVAL = 16;
+	static const unsigned int TOUCH_STROKE_GAP = 100;
+	static const unsigned int TOUCH_INTERPOLATION_STEPS = 4;
+	static const unsigned int BULK_COMPRESS_MIN_SIZE = 256;
+	static const unsigned int BULK_COMPRESS_MIN_RATE = 50;
+	static const unsigned int BULK_COMPRESS_MAX_BACKOFF = 64;
+	static const unsigned int BULK_DECODE_LIMIT = 1 << 24;
 
 #endif
\ No newline at end of file
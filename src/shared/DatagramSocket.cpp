@@ -0,0 +1,159 @@
+#include "DatagramSocket.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+static const SOCKET NO_SOCKET = INVALID_SOCKET;
+#else
+static const int NO_SOCKET = -1;
+#endif
+
+DatagramSocket::DatagramSocket()
+  : socket_(NO_SOCKET)
+{
+  
+}
+
+DatagramSocket::~DatagramSocket()
+{
+  if (socket_ != NO_SOCKET)
+  {
+#ifdef _WIN32
+    closesocket(socket_);
+#else
+    close(socket_);
+#endif
+  }
+}
+
+bool DatagramSocket::open()
+{
+  if (socket_ != NO_SOCKET)
+  {
+    return true;
+  }
+  
+  socket_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+  if (socket_ == NO_SOCKET)
+  {
+    std::cerr << "can't open datagram socket" << std::endl;
+    return false;
+  }
+  
+#ifdef _WIN32
+  u_long non_blocking = 1;
+  ioctlsocket(socket_, FIONBIO, &non_blocking);
+#else
+  fcntl(socket_, F_SETFL, fcntl(socket_, F_GETFL, 0) | O_NONBLOCK);
+#endif
+  return true;
+}
+
+bool DatagramSocket::bind(unsigned int port)
+{
+  if (!open())
+  {
+    return false;
+  }
+  
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons((unsigned short)port);
+  
+  if (::bind(socket_, (sockaddr*)&address, sizeof(address)) != 0)
+  {
+    std::cerr << "can't bind datagram socket to " << port << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool DatagramSocket::add_target(const std::string& host, unsigned int port)
+{
+  if (!open())
+  {
+    return false;
+  }
+  
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  
+  addrinfo* result = 0;
+  if (getaddrinfo(host.c_str(), 0, &hints, &result) != 0 || result == 0)
+  {
+    std::cerr << "can't resolve " << host << std::endl;
+    return false;
+  }
+  
+  sockaddr_in target;
+  memcpy(&target, result->ai_addr, sizeof(target));
+  target.sin_port = htons((unsigned short)port);
+  freeaddrinfo(result);
+  
+  targets_.push_back(target);
+  return true;
+}
+
+void DatagramSocket::clear_targets()
+{
+  targets_.clear();
+}
+
+bool DatagramSocket::send(const void* data, size_t size)
+{
+  if (socket_ == NO_SOCKET || targets_.empty())
+  {
+    return false;
+  }
+  
+#if defined(__linux__)
+  std::vector<mmsghdr> messages(targets_.size());
+  std::vector<iovec> vectors(targets_.size());
+  
+  for (size_t i = 0; i < targets_.size(); i++)
+  {
+    vectors[i].iov_base = (void*)data;
+    vectors[i].iov_len = size;
+    memset(&messages[i], 0, sizeof(mmsghdr));
+    messages[i].msg_hdr.msg_name = &targets_[i];
+    messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    messages[i].msg_hdr.msg_iov = &vectors[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+  
+  return sendmmsg(socket_, &messages[0], messages.size(), 0) == (int)messages.size();
+#else
+  bool sent = true;
+  
+  for (size_t i = 0; i < targets_.size(); i++)
+  {
+    sent &= sendto(socket_, (const char*)data, (int)size, 0, (sockaddr*)&targets_[i], sizeof(sockaddr_in)) == (int)size;
+  }
+  return sent;
+#endif
+}
+
+int DatagramSocket::receive(void* buffer, size_t size)
+{
+  if (socket_ == NO_SOCKET)
+  {
+    return -1;
+  }
+  
+  return (int)recv(socket_, (char*)buffer, (int)size, 0);
+}
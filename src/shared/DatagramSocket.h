@@ -0,0 +1,53 @@
+#ifndef DATAGRAMSOCKET_H_
+#define DATAGRAMSOCKET_H_
+
+  #include <string>
+  #include <vector>
+
+  #ifdef _WIN32
+  #include <winsock2.h>
+  #else
+  #include <netinet/in.h>
+  #endif
+
+  /*
+   * Plain non-blocking UDP socket. send() goes to every target; where the
+   * platform has sendmmsg that is a single system call however many targets
+   * there are.
+   */
+  class DatagramSocket
+  {
+    
+  public:
+    
+    DatagramSocket();
+    
+    ~DatagramSocket();
+    
+    bool bind(unsigned int port);
+    
+    bool add_target(const std::string& host, unsigned int port);
+    
+    void clear_targets();
+    
+    bool send(const void* data, size_t size);
+    
+    int receive(void* buffer, size_t size);
+    
+    inline int handle() { return (int)socket_; };
+    
+  private:
+    
+    bool open();
+    
+#ifdef _WIN32
+    SOCKET socket_;
+#else
+    int socket_;
+#endif
+    
+    std::vector<sockaddr_in> targets_;
+    
+  };
+
+#endif
@@ -1,6 +1,9 @@
 #include "Exit.h"
 
+#include "Clock.h"
+#include "Constants.hpp"
 #include "Message.h"
+#include "Reactor.h"
 #include "ZeroMQRecvSocket.h" 
 
 #include "IExitCommand.hpp"
@@ -10,13 +13,22 @@
 #include "OSXExitCommands.hpp"
 #endif
 
-Exit::Exit() {
+Exit::Exit(ArbitrationPolicy policy) 
+  : arbiter_(policy, ARBITRATION_TIMEOUT)
+  , reactor_(0)
+  , arbitration_timer_(0)
+  , motion_handler_(this)
+  , motion_timer_(0)
+  , macro_timer_(0)
+  , touch_timer_(0)
+{
 #ifndef _WIN32
   message_types_[LEFT_DRAGGED]			= new LeftDraggedCommand();
   message_types_[RIGHT_DRAGGED]			= new RightDraggedCommand();
   message_types_[FLAGS_CHANGED]			= new FlagsChangedCommand();
-  message_types_[SCROLL_WHEEL]			= new ScrollWheelCommand();
 #endif
+  message_types_[SCROLL_WHEEL]			= new ScrollWheelCommand();
+  message_types_[TEXT]              = new TextCommand();
   message_types_[LEFT_UP]           = new LeftUpCommand();
   message_types_[LEFT_DOWN]         = new LeftDownCommand();
   message_types_[RIGHT_UP]          = new RightUpCommand();
@@ -24,9 +36,11 @@ Exit::Exit() {
   message_types_[KEY_UP]            = new KeyUpCommand();
   message_types_[KEY_DOWN]          = new KeyDownCommand();  
   message_types_[MOUSE_MOVE]				= new MouseMovedCommand();
+  message_types_[MOUSE_POSITION]		= new MousePositionCommand();
   message_types_[LEFT_DOUBLE_CLICK]	= new LeftDoubleClickCommand();  
 
   exit_socket_ = new ZeroMQRecvSocket();
+  motion_socket_.bind(MOTION_PORT);
 }
 
 void Exit::receive_search() 
@@ -36,17 +50,187 @@ void Exit::receive_search()
 
 #include <sstream>
 	
+void Exit::execute(const Message& message)
+{
+  if (message_types_.find(message.type) != message_types_.end())
+  {							
+    message_types_[message.type]->Execute(message);
+  }
+}
+	
 void Exit::receive_input() 
 { 
   Message* message = exit_socket_->receive();
+  MessageList ready;
+  receive(*message, ready);
+  exit_socket_->dispose(message);
+  accept(ready);
+  dispatch();
+};
 
-  if (message_types_.find(message->type) != message_types_.end())
-  {							
-    message_types_[message->type]->Execute(*message);
+void Exit::receive(const Message& message, MessageList& ready)
+{
+  // macro uploads are stored, not arbitrated; only running one needs control
+  if (!macros_.define(message))
+  {
+    // touch frames come back out of the smoother as ordinary moves
+    if (message.type == TOUCH_MOVE)
+    {
+      touch_.push(message, Clock::now_ms());
+    }
+    else
+    {
+      arbiter_.push(message, Clock::now_ms());
+    }
   }
   
-  exit_socket_->dispose(message);      
-};
+  merger_.reliable(message, ready);
+}
+
+void Exit::accept(const MessageList& messages)
+{
+  unsigned long long now = Clock::now_ms();
+  
+  for (MessageList::const_iterator i = messages.begin(); i != messages.end(); ++i)
+  {
+    arbiter_.push(*i, now);
+  }
+}
+
+int Exit::reschedule(int timer_id, long timeout)
+{
+  if (timer_id != 0)
+  {
+    reactor_->cancel_timer(timer_id);
+  }
+  
+  return (timeout >= 0) ? reactor_->add_timer(timeout, this, false) : 0;
+}
+
+void Exit::dispatch()
+{
+  Message message;
+  
+  while (arbiter_.pop(message, Clock::now_ms()))
+  {
+    if (message.type == MACRO_RUN)
+    {
+      macros_.run(message, Clock::now_ms());
+    }
+    else
+    {
+      execute(message);
+    }
+  }
+  
+  if (reactor_ == 0)
+  {
+    return;
+  }
+  
+  // wake up again when the current lock holder's claim runs out, or when
+  // held motion has waited long enough for its key or button event
+  unsigned long long now = Clock::now_ms();
+  arbitration_timer_ = reschedule(arbitration_timer_, arbiter_.next_timeout(now));
+  motion_timer_ = reschedule(motion_timer_, merger_.next_timeout(now));
+  macro_timer_ = reschedule(macro_timer_, macro_timeout(now));
+  touch_timer_ = reschedule(touch_timer_, touch_.next_timeout(now));
+}
+
+// a full queue only drains once its session has control again, so macro
+// steps wait for that instead of being pushed in to be dropped
+bool Exit::macros_blocked()
+{
+  return arbiter_.backlog() + MACRO_BATCH_LIMIT > SESSION_QUEUE_LIMIT;
+}
+
+long Exit::macro_timeout(unsigned long long now_ms)
+{
+  long timeout = macros_.next_timeout(now_ms);
+  
+  if (timeout < 0 || !macros_blocked())
+  {
+    return timeout;
+  }
+  
+  long unblocked = arbiter_.next_timeout(now_ms);
+  return (unblocked < 0) ? (long)ARBITRATION_TIMEOUT : unblocked;
+}
+
+void Exit::attach(Reactor* reactor)
+{
+  reactor_ = reactor;
+  reactor->add_socket(exit_socket_->poll_handle(), this);
+  reactor->add_fd(motion_socket_.handle(), &motion_handler_);
+}
+
+void Exit::on_readable()
+{
+  Message* message = 0;
+  
+  MessageList ready;
+  
+  while ((message = exit_socket_->try_receive()) != 0)
+  {
+    receive(*message, ready);
+    exit_socket_->dispose(message);
+  }
+  
+  accept(ready);
+  dispatch();
+}
+
+void Exit::receive_motion()
+{
+  MotionPacket packet;
+  MessageList ready;
+  int size = 0;
+  
+  while ((size = motion_socket_.receive(&packet, sizeof(packet))) >= 0)
+  {
+    if (size == sizeof(packet) && is_motion_message(packet.message.type))
+    {
+      merger_.motion(packet, Clock::now_ms(), ready);
+    }
+  }
+  
+  accept(ready);
+  dispatch();
+}
+
+void Exit::on_timer(int timer_id)
+{
+  if (timer_id == motion_timer_)
+  {
+    MessageList ready;
+    motion_timer_ = 0;
+    merger_.expire(Clock::now_ms(), ready);
+    accept(ready);
+  }
+  else if (timer_id == macro_timer_)
+  {
+    MessageList ready;
+    macro_timer_ = 0;
+    if (!macros_blocked())
+    {
+      macros_.due(Clock::now_ms(), ready);
+      accept(ready);
+    }
+  }
+  else if (timer_id == touch_timer_)
+  {
+    MessageList ready;
+    touch_timer_ = 0;
+    touch_.due(Clock::now_ms(), ready);
+    accept(ready);
+  }
+  else
+  {
+    arbitration_timer_ = 0;
+  }
+  
+  dispatch();
+}
 
 void Exit::shutdown()
 {
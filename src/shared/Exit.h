@@ -5,24 +5,82 @@
 
 	#include "IExitCommand.hpp"
   #include "IRecvSocket.hpp"
+  #include "IReactorHandler.hpp"
+  #include "SessionArbiter.h"
+  #include "DatagramSocket.h"
+  #include "LaneMerger.h"
+  #include "MacroEngine.h"
+  #include "TouchSmoother.h"
   
-	class Exit
+  class Reactor;
+  
+	/*
+	 * Several controllers may be pointed at one exit at once; their input is
+	 * passed through a SessionArbiter so only one of them drives it at a time.
+	 * Motion may also arrive over UDP, which a LaneMerger folds back in.
+	 * Macros and smoothed touch motion play back from the exit's own timers
+	 * through the same arbiter.
+	 */
+	class Exit : public IReactorHandler, public ITimerHandler
 	{
 		typedef std::map<int, IExitCommand*> MessageTypeList;
+		
+		class MotionHandler : public IReactorHandler
+		{
+			
+		public:
+			
+			MotionHandler(Exit* exit) : exit_(exit) { };
+			
+			void on_readable() { exit_->receive_motion(); };
+			
+		private:
+			
+			Exit* exit_;
+			
+		};
 				
 	public:
 		    
-    Exit();
+    Exit(ArbitrationPolicy policy = ARBITRATION_EXCLUSIVE);
 
 		void receive_input();
     void receive_search();
     
+    void attach(Reactor* reactor);
+    void on_readable();
+    void on_timer(int timer_id);
+    
     void shutdown();
 		
 	private:
 
+    void execute(const Message& message);
+    void dispatch();
+    void receive_motion();
+    void receive(const Message& message, MessageList& ready);
+    void accept(const MessageList& messages);
+    int reschedule(int timer_id, long timeout);
+    bool macros_blocked();
+    long macro_timeout(unsigned long long now_ms);
+
 		IRecvSocket* exit_socket_;
 		MessageTypeList message_types_;
+		
+		SessionArbiter arbiter_;
+		Reactor* reactor_;
+		int arbitration_timer_;
+		
+		DatagramSocket motion_socket_;
+		MotionHandler motion_handler_;
+		LaneMerger merger_;
+		int motion_timer_;
+		
+		MacroEngine macros_;
+		int macro_timer_;
+		
+		TouchSmoother touch_;
+		int touch_timer_;
 
 	};
 
@@ -0,0 +1,239 @@
+#include "FileReceiver.h"
+
+#include <zmq.hpp>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "BulkCodec.h"
+#include "Reactor.h"
+#include "ZeroMQContext.hpp"
+
+FileReceiver::FileReceiver(const std::string& directory)
+  : directory_(directory)
+  , socket_(0)
+  , listener_(0)
+{
+  
+}
+
+FileReceiver::~FileReceiver()
+{
+  for (IncomingList::iterator i = incoming_.begin(); i != incoming_.end(); ++i)
+  {
+    close((*i).second);
+  }
+  
+  delete socket_;
+}
+
+bool FileReceiver::bind(unsigned int port)
+{
+  std::stringstream address;
+  address << "tcp://*:" << port;
+  
+  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_XREP, ZeroMQContext::BULK_LANE);
+  
+  try {
+    socket_->bind(address.str().c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void FileReceiver::attach(Reactor* reactor, IFileListener* listener)
+{
+  listener_ = listener;
+  reactor->add_socket(*socket_, this);
+}
+
+void FileReceiver::close(Incoming& incoming)
+{
+  if (incoming.file != 0)
+  {
+    incoming.file->close();
+    delete incoming.file;
+    incoming.file = 0;
+  }
+}
+
+void FileReceiver::send_frame(const std::string& peer, int type, unsigned int id, unsigned long long offset)
+{
+  TransferFrame frame = { type, id, offset, 0 };
+  
+  try {
+    zmq::message_t identity(peer.size());
+    memcpy(identity.data(), peer.data(), peer.size());
+    socket_->send(identity, ZMQ_SNDMORE);
+    
+    zmq::message_t message(sizeof(frame));
+    memcpy(message.data(), &frame, sizeof(frame));
+    socket_->send(message, ZMQ_NOBLOCK);
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+void FileReceiver::on_readable()
+{
+  zmq::message_t identity;
+  
+  while (socket_->recv(&identity, ZMQ_NOBLOCK))
+  {
+    std::string peer((char*)identity.data(), identity.size());
+    
+    long long more = 0;
+    size_t more_size = sizeof(more);
+    socket_->getsockopt(ZMQ_RCVMORE, &more, &more_size);
+    
+    if (!more)
+    {
+      continue;
+    }
+    
+    zmq::message_t header;
+    socket_->recv(&header);
+    socket_->getsockopt(ZMQ_RCVMORE, &more, &more_size);
+    
+    TransferFrame frame;
+    bool valid = header.size() >= sizeof(frame);
+    if (valid)
+    {
+      memcpy(&frame, header.data(), sizeof(frame));
+    }
+    
+    if (valid && frame.type == TRANSFER_OFFER)
+    {
+      handle_offer(peer, frame, std::string((char*)header.data() + sizeof(frame), header.size() - sizeof(frame)));
+    }
+    
+    // a raw slice is written straight out of the zmq buffer
+    while (more)
+    {
+      zmq::message_t body;
+      socket_->recv(&body);
+      socket_->getsockopt(ZMQ_RCVMORE, &more, &more_size);
+      
+      if (valid && frame.type == TRANSFER_DATA && frame.codec == CODEC_NONE)
+      {
+        handle_data(peer, frame, (char*)body.data(), body.size());
+      }
+      else if (valid && frame.type == TRANSFER_DATA && frame.offset < frame.size)
+      {
+        unsigned long long expected = frame.size - frame.offset;
+        expected = (expected > TRANSFER_CHUNK_SIZE) ? TRANSFER_CHUNK_SIZE : expected;
+        
+        std::string unpacked;
+        if (BulkCodec::decode(frame.codec, (char*)body.data(), body.size(), (size_t)expected, unpacked))
+        {
+          handle_data(peer, frame, unpacked.data(), unpacked.size());
+        }
+      }
+    }
+  }
+}
+
+void FileReceiver::handle_offer(const std::string& peer, const TransferFrame& frame, const std::string& offered_name)
+{
+  // never let the sender pick anything but a plain name in our directory
+  std::string::size_type separator = offered_name.find_last_of("/\\:");
+  std::string name = (separator == std::string::npos) ? offered_name : offered_name.substr(separator + 1);
+  
+  if (name.empty() || name == "." || name == "..")
+  {
+    return;
+  }
+  
+  IncomingList::iterator existing = incoming_.find(peer);
+  if (existing != incoming_.end())
+  {
+    close((*existing).second);
+  }
+  
+  Incoming& incoming = incoming_[peer];
+  incoming.id = frame.id;
+  incoming.path = directory_ + "/" + name;
+  incoming.size = frame.size;
+  incoming.file = 0;
+  
+  std::string part = incoming.path + ".part";
+  
+  std::ifstream previous(part.c_str(), std::ios::binary | std::ios::ate);
+  unsigned long long held = previous ? (unsigned long long)previous.tellg() : 0;
+  previous.close();
+  
+  if (held > incoming.size)
+  {
+    held = 0;
+  }
+  
+  // only whole chunks count, the tail of an interrupted write may be torn
+  incoming.received = (held == incoming.size) ? held : held - held % TRANSFER_CHUNK_SIZE;
+  
+  std::ios::openmode mode = std::ios::binary | std::ios::out;
+  mode |= (incoming.received > 0) ? std::ios::in : std::ios::trunc;
+  incoming.file = new std::ofstream(part.c_str(), mode);
+  
+  if (!incoming.file->is_open())
+  {
+    std::cerr << "can't write " << part << std::endl;
+    close(incoming);
+    incoming_.erase(peer);
+    return;
+  }
+  
+  incoming.file->seekp((std::streamoff)incoming.received);
+  send_frame(peer, TRANSFER_RESUME, incoming.id, incoming.received);
+  
+  if (incoming.received == incoming.size)
+  {
+    handle_data(peer, frame, 0, 0);
+  }
+}
+
+void FileReceiver::handle_data(const std::string& peer, const TransferFrame& frame, const char* data, size_t size)
+{
+  IncomingList::iterator found = incoming_.find(peer);
+  if (found == incoming_.end() || (*found).second.id != frame.id)
+  {
+    return;
+  }
+  
+  Incoming& incoming = (*found).second;
+  
+  if (size > 0)
+  {
+    if (frame.offset != incoming.received || incoming.received + size > incoming.size)
+    {
+      send_frame(peer, TRANSFER_RESUME, incoming.id, incoming.received);
+      return;
+    }
+    
+    incoming.file->write(data, size);
+    incoming.received += size;
+    send_frame(peer, TRANSFER_ACK, incoming.id, incoming.received);
+  }
+  
+  if (incoming.received < incoming.size)
+  {
+    return;
+  }
+  
+  close(incoming);
+  
+  std::string part = incoming.path + ".part";
+  std::remove(incoming.path.c_str());
+  std::rename(part.c_str(), incoming.path.c_str());
+  
+  if (listener_ != 0)
+  {
+    listener_->on_file_received(incoming.path);
+  }
+  
+  incoming_.erase(found);
+}
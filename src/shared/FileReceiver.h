@@ -0,0 +1,75 @@
+#ifndef FILERECEIVER_H_
+#define FILERECEIVER_H_
+
+  #include <fstream>
+  #include <map>
+  #include <string>
+
+  #include "FileTransferProtocol.h"
+  #include "IReactorHandler.hpp"
+
+  namespace zmq { class socket_t; };
+
+  class Reactor;
+
+  class IFileListener
+  {
+    
+  public:
+    
+    virtual void on_file_received(const std::string& path) = 0;
+    
+  };
+
+  /*
+   * Receiving end of a FileSender. Incoming files are written to
+   * "<name>.part" in the target directory and renamed once complete; a
+   * partial file left over from an earlier attempt is resumed rather than
+   * started again.
+   */
+  class FileReceiver : public IReactorHandler
+  {
+    
+    struct Incoming
+    {
+      unsigned int id;
+      std::string path;
+      unsigned long long size;
+      unsigned long long received;
+      std::ofstream* file;
+    };
+    
+    typedef std::map<std::string, Incoming> IncomingList;
+    
+  public:
+    
+    FileReceiver(const std::string& directory);
+    
+    ~FileReceiver();
+    
+    bool bind(unsigned int port);
+    
+    void attach(Reactor* reactor, IFileListener* listener);
+    
+    void on_readable();
+    
+  private:
+    
+    void handle_offer(const std::string& peer, const TransferFrame& frame, const std::string& name);
+    
+    void handle_data(const std::string& peer, const TransferFrame& frame, const char* data, size_t size);
+    
+    void send_frame(const std::string& peer, int type, unsigned int id, unsigned long long offset);
+    
+    void close(Incoming& incoming);
+    
+    std::string directory_;
+    
+    zmq::socket_t* socket_;
+    IFileListener* listener_;
+    
+    IncomingList incoming_;
+    
+  };
+
+#endif
@@ -0,0 +1,428 @@
+#include "FileSender.h"
+
+#include <zmq.hpp>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Lz4Compressor.h"
+#include "Reactor.h"
+#include "ZeroMQContext.hpp"
+
+// views have to start on this boundary, so a slice at any other offset (a
+// RESUME can land anywhere) is mapped from the boundary below it
+static size_t map_granularity()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwAllocationGranularity;
+#else
+  return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+// called by zmq once a slice has been written out; the hint carries its length.
+// the view itself starts at the boundary at or below the slice
+static void unmap_slice(void* data, void* hint)
+{
+  char* view = (char*)((size_t)data & ~(map_granularity() - 1));
+  
+#ifdef _WIN32
+  UnmapViewOfFile(view);
+#else
+  munmap(view, ((char*)data - view) + (size_t)hint);
+#endif
+}
+
+FileSender::FileSender()
+  : socket_(0)
+  , inbox_(0)
+  , inbox_handler_(this)
+  , reactor_(0)
+  , next_id_(1)
+{
+  inbox_ = ZeroMQContext::instance()->create_socket(ZMQ_PULL);
+  
+  try {
+    inbox_->bind(inbox_address().c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+FileSender::~FileSender()
+{
+  while (!outgoing_.empty())
+  {
+    finish();
+  }
+  
+  if (reactor_ != 0)
+  {
+    reactor_->remove(this);
+    reactor_->remove(&inbox_handler_);
+  }
+  
+  delete socket_;
+  delete inbox_;
+}
+
+std::string FileSender::inbox_address()
+{
+  std::stringstream address;
+  address << "inproc://file-sender-" << this;
+  return address.str();
+}
+
+void FileSender::attach(Reactor* reactor)
+{
+  reactor_ = reactor;
+  reactor->add_socket(*inbox_, &inbox_handler_);
+}
+
+void FileSender::post(const TransferFrame& frame, const std::string& payload)
+{
+  try {
+    zmq::socket_t* socket = ZeroMQContext::instance()->create_socket(ZMQ_PUSH);
+    socket->connect(inbox_address().c_str());
+    
+    zmq::message_t message(sizeof(frame) + payload.size());
+    memcpy(message.data(), &frame, sizeof(frame));
+    memcpy((char*)message.data() + sizeof(frame), payload.data(), payload.size());
+    socket->send(message);
+    
+    delete socket;
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+void FileSender::connect_to(const std::string& host, unsigned int port)
+{
+  TransferFrame frame = { TRANSFER_CONNECT, 0, 0, port };
+  post(frame, host);
+}
+
+void FileSender::send(const std::string& path)
+{
+  TransferFrame frame = { TRANSFER_SEND, 0, 0, 0 };
+  post(frame, path);
+}
+
+void FileSender::drain_inbox()
+{
+  zmq::message_t message;
+  
+  while (inbox_->recv(&message, ZMQ_NOBLOCK))
+  {
+    if (message.size() < sizeof(TransferFrame))
+    {
+      continue;
+    }
+    
+    TransferFrame frame;
+    memcpy(&frame, message.data(), sizeof(frame));
+    std::string payload((char*)message.data() + sizeof(frame), message.size() - sizeof(frame));
+    
+    if (frame.type == TRANSFER_CONNECT)
+    {
+      open(payload, (unsigned int)frame.size);
+    }
+    else if (frame.type == TRANSFER_SEND)
+    {
+      Outgoing outgoing;
+      outgoing.id = next_id_++;
+      outgoing.path = payload;
+      outgoing.size = 0;
+      outgoing.next = 0;
+      outgoing.acked = 0;
+      outgoing.streaming = false;
+#ifdef _WIN32
+      outgoing.file = INVALID_HANDLE_VALUE;
+      outgoing.mapping = NULL;
+#else
+      outgoing.file = -1;
+#endif
+      outgoing_.push_back(outgoing);
+      
+      if (outgoing_.size() == 1)
+      {
+        offer();
+      }
+    }
+  }
+}
+
+void FileSender::open(const std::string& host, unsigned int port)
+{
+  if (socket_ != 0)
+  {
+    if (reactor_ != 0)
+    {
+      reactor_->remove(this);
+    }
+    delete socket_;
+  }
+  
+  std::stringstream address;
+  address << "tcp://" << host << ":" << port;
+  
+  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_XREQ, ZeroMQContext::BULK_LANE);
+  
+  try {
+    socket_->connect(address.str().c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return;
+  }
+  
+  if (reactor_ != 0)
+  {
+    reactor_->add_socket(*socket_, this);
+  }
+  
+  // the new receiver tells us where to pick up from
+  if (!outgoing_.empty())
+  {
+    outgoing_.front().streaming = false;
+    offer();
+  }
+}
+
+bool FileSender::start(Outgoing& outgoing)
+{
+#ifdef _WIN32
+  if (outgoing.file != INVALID_HANDLE_VALUE)
+  {
+    return true;
+  }
+  
+  outgoing.file = CreateFileA(outgoing.path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (outgoing.file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+  
+  LARGE_INTEGER size;
+  GetFileSizeEx(outgoing.file, &size);
+  outgoing.size = size.QuadPart;
+  
+  // an empty file cannot be mapped, and has nothing to map anyway
+  if (outgoing.size > 0)
+  {
+    outgoing.mapping = CreateFileMapping(outgoing.file, NULL, PAGE_READONLY, 0, 0, NULL);
+    return outgoing.mapping != NULL;
+  }
+  return true;
+#else
+  if (outgoing.file >= 0)
+  {
+    return true;
+  }
+  
+  outgoing.file = ::open(outgoing.path.c_str(), O_RDONLY);
+  if (outgoing.file < 0)
+  {
+    return false;
+  }
+  
+  struct stat status;
+  fstat(outgoing.file, &status);
+  outgoing.size = status.st_size;
+  return true;
+#endif
+}
+
+void FileSender::finish()
+{
+  Outgoing& outgoing = outgoing_.front();
+  
+  // slices still queued in zmq keep their own mappings alive
+#ifdef _WIN32
+  if (outgoing.mapping != NULL)
+  {
+    CloseHandle(outgoing.mapping);
+  }
+  if (outgoing.file != INVALID_HANDLE_VALUE)
+  {
+    CloseHandle(outgoing.file);
+  }
+#else
+  if (outgoing.file >= 0)
+  {
+    close(outgoing.file);
+  }
+#endif
+  
+  outgoing_.pop_front();
+}
+
+void FileSender::offer()
+{
+  while (!outgoing_.empty() && socket_ != 0)
+  {
+    Outgoing& outgoing = outgoing_.front();
+    
+    if (!start(outgoing))
+    {
+      std::cerr << "can't open " << outgoing.path << std::endl;
+      finish();
+      continue;
+    }
+    
+    std::string::size_type separator = outgoing.path.find_last_of("/\\");
+    std::string name = (separator == std::string::npos) ? outgoing.path : outgoing.path.substr(separator + 1);
+    
+    TransferFrame frame = { TRANSFER_OFFER, outgoing.id, 0, outgoing.size };
+    send_frame(frame, name);
+    return;
+  }
+}
+
+void FileSender::pump()
+{
+  Outgoing& outgoing = outgoing_.front();
+  unsigned long long window = (unsigned long long)TRANSFER_WINDOW * TRANSFER_CHUNK_SIZE;
+  
+  while (outgoing.streaming && outgoing.next < outgoing.size && outgoing.next - outgoing.acked < window)
+  {
+    if (!send_slice(outgoing))
+    {
+      outgoing.streaming = false;
+      return;
+    }
+  }
+}
+
+void FileSender::set_compression(bool enabled)
+{
+  codec_.set_compressor(enabled ? new Lz4Compressor() : 0);
+}
+
+bool FileSender::send_slice(Outgoing& outgoing)
+{
+  unsigned long long remaining = outgoing.size - outgoing.next;
+  size_t length = (remaining < TRANSFER_CHUNK_SIZE) ? (size_t)remaining : TRANSFER_CHUNK_SIZE;
+  
+  unsigned long long base = outgoing.next & ~(unsigned long long)(map_granularity() - 1);
+  size_t skip = (size_t)(outgoing.next - base);
+  
+#ifdef _WIN32
+  void* view = MapViewOfFile(outgoing.mapping, FILE_MAP_READ, (DWORD)(base >> 32), (DWORD)base, skip + length);
+  if (view == NULL)
+  {
+    std::cerr << "could not map " << outgoing.path << std::endl;
+    return false;
+  }
+#else
+  void* view = mmap(0, skip + length, PROT_READ, MAP_SHARED, outgoing.file, (off_t)base);
+  if (view == MAP_FAILED)
+  {
+    std::cerr << "could not map " << outgoing.path << std::endl;
+    return false;
+  }
+#endif
+  
+  void* slice = (char*)view + skip;
+  
+  TransferFrame frame = { TRANSFER_DATA, outgoing.id, outgoing.next, outgoing.size };
+  
+  std::string packed;
+  frame.codec = codec_.encode((const char*)slice, length, packed);
+  
+  try {
+    zmq::message_t header(sizeof(frame));
+    memcpy(header.data(), &frame, sizeof(frame));
+    socket_->send(header, ZMQ_SNDMORE);
+    
+    if (frame.codec != CODEC_NONE)
+    {
+      unmap_slice(slice, (void*)length);
+      zmq::message_t body(packed.size());
+      memcpy(body.data(), packed.data(), packed.size());
+      socket_->send(body);
+    }
+    else
+    {
+      // zmq owns the mapping from here on and unmaps it after the write
+      zmq::message_t body(slice, length, unmap_slice, (void*)length);
+      socket_->send(body);
+    }
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  
+  outgoing.next += length;
+  return true;
+}
+
+void FileSender::send_frame(const TransferFrame& frame, const std::string& payload)
+{
+  try {
+    zmq::message_t message(sizeof(frame) + payload.size());
+    memcpy(message.data(), &frame, sizeof(frame));
+    memcpy((char*)message.data() + sizeof(frame), payload.data(), payload.size());
+    socket_->send(message);
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+void FileSender::on_readable()
+{
+  zmq::message_t message;
+  
+  while (socket_->recv(&message, ZMQ_NOBLOCK))
+  {
+    if (message.size() < sizeof(TransferFrame) || outgoing_.empty())
+    {
+      continue;
+    }
+    
+    TransferFrame frame;
+    memcpy(&frame, message.data(), sizeof(frame));
+    
+    Outgoing& outgoing = outgoing_.front();
+    if (frame.id != outgoing.id || frame.offset > outgoing.size)
+    {
+      continue;
+    }
+    
+    if (frame.type == TRANSFER_RESUME)
+    {
+      outgoing.next = frame.offset;
+      outgoing.acked = frame.offset;
+      outgoing.streaming = true;
+    }
+    else if (frame.type == TRANSFER_ACK && frame.offset > outgoing.acked)
+    {
+      outgoing.acked = frame.offset;
+    }
+    
+    if (outgoing.acked == outgoing.size)
+    {
+      finish();
+      offer();
+    }
+    else
+    {
+      pump();
+    }
+  }
+}
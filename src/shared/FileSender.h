@@ -0,0 +1,111 @@
+#ifndef FILESENDER_H_
+#define FILESENDER_H_
+
+  #include <deque>
+  #include <string>
+
+  #include "BulkCodec.h"
+  #include "FileTransferProtocol.h"
+  #include "IReactorHandler.hpp"
+
+  namespace zmq { class socket_t; };
+
+  class Reactor;
+
+  /*
+   * Streams files to a FileReceiver without copying them through user space:
+   * each TRANSFER_CHUNK_SIZE slice is mapped on its own and handed to zmq,
+   * which unmaps it once the bytes are on the wire. At most TRANSFER_WINDOW
+   * slices are unacknowledged at a time.
+   *
+   * Meant to run on a reactor of its own, on a thread of its own, so a large
+   * transfer never sits in front of the input stream. connect_to() and send()
+   * may be called from any thread.
+   */
+  class FileSender : public IReactorHandler
+  {
+    
+    class Inbox : public IReactorHandler
+    {
+      
+    public:
+      
+      Inbox(FileSender* sender) : sender_(sender) { };
+      
+      void on_readable() { sender_->drain_inbox(); };
+      
+    private:
+      
+      FileSender* sender_;
+      
+    };
+    
+    struct Outgoing
+    {
+      unsigned int id;
+      std::string path;
+      unsigned long long size;
+      unsigned long long next;
+      unsigned long long acked;
+      bool streaming;
+#ifdef _WIN32
+      void* file;
+      void* mapping;
+#else
+      int file;
+#endif
+    };
+    
+  public:
+    
+    FileSender();
+    
+    ~FileSender();
+    
+    void attach(Reactor* reactor);
+    
+    void on_readable();
+    
+    void connect_to(const std::string& host, unsigned int port);
+    
+    void send(const std::string& path);
+    
+    // call before attach, it is not thread safe like send
+    void set_compression(bool enabled);
+    
+  private:
+    
+    void drain_inbox();
+    
+    void post(const TransferFrame& frame, const std::string& payload);
+    
+    void open(const std::string& host, unsigned int port);
+    
+    bool start(Outgoing& outgoing);
+    
+    void finish();
+    
+    void offer();
+    
+    void pump();
+    
+    bool send_slice(Outgoing& outgoing);
+    
+    void send_frame(const TransferFrame& frame, const std::string& payload);
+    
+    std::string inbox_address();
+    
+    zmq::socket_t* socket_;
+    zmq::socket_t* inbox_;
+    Inbox inbox_handler_;
+    
+    Reactor* reactor_;
+    
+    std::deque<Outgoing> outgoing_;
+    unsigned int next_id_;
+    
+    BulkCodec codec_;
+    
+  };
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef FILETRANSFERPROTOCOL_H_
+#define FILETRANSFERPROTOCOL_H_
+
+  enum TransferFrameTypes
+  {
+    TRANSFER_OFFER = 1,
+    TRANSFER_RESUME = 2,
+    TRANSFER_DATA = 3,
+    TRANSFER_ACK = 4,
+    TRANSFER_CONNECT = 5,
+    TRANSFER_SEND = 6
+  };
+
+  /*
+   * OFFER carries the file name after the header. The receiver answers with
+   * RESUME and the offset it already holds, the sender streams DATA frames
+   * (header, then the slice as a second part) and the receiver ACKs the
+   * offset it has written up to. A DATA slice may be compressed, as its
+   * codec says, see BulkCodec.
+   */
+  struct TransferFrame
+  {
+    int type;
+    unsigned int id;
+    unsigned long long offset;
+    unsigned long long size;
+    unsigned int codec;
+  };
+
+  static const unsigned int TRANSFER_PORT = 44201;
+
+  // a multiple of both the page size and the Windows allocation granularity,
+  // so every slice can be mapped on its own
+  static const unsigned int TRANSFER_CHUNK_SIZE = 1 << 20;
+  static const unsigned int TRANSFER_WINDOW = 8;
+
+#endif
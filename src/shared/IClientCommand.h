@@ -4,11 +4,12 @@
 	#include <ApplicationServices/ApplicationServices.h>
 	#include <Carbon/Carbon.h>
 
-	#include "Time.h"
+	#include "Clock.h"
 	#include "Constants.hpp"
 	#include "Client.h"
 
 	#include "KeyCodes.hpp"
+	#include "ScrollAccumulator.h"
 
 	class IClientCommand
 	{
@@ -19,6 +20,55 @@
 			
 	};
 
+	/*
+	 * Key events posted by software rather than the keyboard, such as a
+	 * password manager typing a password, are sent as batched TEXT instead of
+	 * a key down and up per character. Anything with a command, control or
+	 * option modifier stays a key event so shortcuts keep working.
+	 */
+	inline bool typed_text(CGEventRef event, std::string& utf8)
+	{
+		if (CGEventGetIntegerValueField(event, kCGEventSourceStateID) == kCGEventSourceStateHIDSystemState)
+		{
+			return false;
+		}
+		
+		if (CGEventGetFlags(event) & (kCGEventFlagMaskCommand | kCGEventFlagMaskControl | kCGEventFlagMaskAlternate))
+		{
+			return false;
+		}
+		
+		UniChar chars[MESSAGE_TEXT_SIZE];
+		UniCharCount length = 0;
+		CGEventKeyboardGetUnicodeString(event, MESSAGE_TEXT_SIZE, &length, chars);
+		
+		if (length == 0)
+		{
+			return false;
+		}
+		
+		// control characters, and the private use range OS X reports arrows
+		// and function keys in, have to stay key events
+		for (UniCharCount i = 0; i < length; i++)
+		{
+			if (chars[i] < 0x20 || chars[i] == 0x7F || (chars[i] >= 0xF700 && chars[i] <= 0xF8FF))
+			{
+				return false;
+			}
+		}
+		
+		CFStringRef text = CFStringCreateWithCharacters(NULL, chars, length);
+		char buffer[MESSAGE_TEXT_SIZE * 3 + 1];
+		bool converted = CFStringGetCString(text, buffer, sizeof(buffer), kCFStringEncodingUTF8);
+		CFRelease(text);
+		
+		if (converted)
+		{
+			utf8 = buffer;
+		}
+		return converted;
+	}
+
 	class KeyDownClientCommand : public IClientCommand
 	{
 		
@@ -28,7 +78,12 @@
 		
 		bool Execute(CGEventRef event, Client* client)
 		{
-      
+			std::string text;
+			if (typed_text(event, text))
+			{
+				return client->send_text(text);
+			}
+			
 			CGEventFlags flags = CGEventGetFlags(event);
 			CGKeyCode keycode = (CGKeyCode)CGEventGetIntegerValueField(event, kCGKeyboardEventKeycode);
 			return client->send_key_down(flags, KeyCodes().osx_to_generic(keycode));
@@ -43,6 +98,13 @@
 		
 		bool Execute(CGEventRef event, Client* client)
 		{
+			// the matching key down already went out as text
+			std::string text;
+			if (typed_text(event, text))
+			{
+				return true;
+			}
+			
 			CGEventFlags flags = CGEventGetFlags(event);
 			CGKeyCode keycode = (CGKeyCode)CGEventGetIntegerValueField(event, kCGKeyboardEventKeycode);			
 			return client->send_key_up(flags, KeyCodes().osx_to_generic(keycode));
@@ -80,13 +142,13 @@
 		
 		LeftMouseDownClientCommand()
 		{
-			last_click_ = Time::get();
+			last_click_ = Clock::now_ms();
 		}
 		
 		bool Execute(CGEventRef event, Client* client)
 		{	
-			unsigned int time_now = Time::get();
-			unsigned int delta = time_now - last_click_;
+			unsigned long long time_now = Clock::now_ms();
+			unsigned long long delta = time_now - last_click_;
 					
 			last_click_ = time_now;
 			
@@ -102,7 +164,7 @@
 		
 	private:
 		
-		unsigned int last_click_;
+		unsigned long long last_click_;
 	};
 
 	class LeftMouseDraggedClientCommand : public IClientCommand
@@ -173,9 +235,22 @@
 		
 		bool Execute(CGEventRef event, Client* client)
 		{
-			int x = CGEventGetIntegerValueField(event, kCGScrollWheelEventDeltaAxis2);
-			int y = CGEventGetIntegerValueField(event, kCGScrollWheelEventDeltaAxis1);
-			return client->send_scroll_wheel(x, y);
+			double x, y;
+			
+			if (CGEventGetIntegerValueField(event, kCGScrollWheelEventIsContinuous))
+			{
+				// trackpads report exact pixel travel
+				x = CGEventGetDoubleValueField(event, kCGScrollWheelEventPointDeltaAxis2);
+				y = CGEventGetDoubleValueField(event, kCGScrollWheelEventPointDeltaAxis1);
+			}
+			else
+			{
+				// wheels report lines, fractional once acceleration kicks in
+				x = CGEventGetDoubleValueField(event, kCGScrollWheelEventFixedPtDeltaAxis2) * SCROLL_PIXELS_PER_LINE;
+				y = CGEventGetDoubleValueField(event, kCGScrollWheelEventFixedPtDeltaAxis1) * SCROLL_PIXELS_PER_LINE;
+			}
+			
+			return client->send_scroll_wheel((int)(x * SCROLL_FIXED_ONE), (int)(y * SCROLL_FIXED_ONE));
 		}
 	};
 
@@ -0,0 +1,31 @@
+#ifndef ICOMPRESSOR_HPP
+#define ICOMPRESSOR_HPP
+
+  #include <cstddef>
+
+  enum CompressionCodecs
+  {
+    CODEC_NONE = 0,
+    CODEC_LZ4 = 1
+  };
+
+  class ICompressor
+  {
+    
+  public:
+    
+    virtual ~ICompressor() { };
+    
+    virtual int codec() = 0;
+    
+    virtual size_t bound(size_t size) = 0;
+    
+    // returns the compressed size, or 0 if it would not fit in capacity
+    virtual size_t compress(const char* data, size_t size, char* out, size_t capacity) = 0;
+    
+    // only succeeds when exactly size bytes come out
+    virtual bool decompress(const char* data, size_t data_size, char* out, size_t size) = 0;
+    
+  };
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef IREACTORHANDLER_HPP
+#define IREACTORHANDLER_HPP
+
+  class IReactorHandler
+  {
+    
+  public:
+    
+    virtual void on_readable() = 0;
+    
+  };
+
+  class ITimerHandler
+  {
+    
+  public:
+    
+    virtual void on_timer(int timer_id) = 0;
+    
+  };
+
+#endif
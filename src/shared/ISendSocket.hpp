@@ -14,6 +14,9 @@
     
     virtual bool send(void *data, size_t data_size) = 0;
     
+    // true once the connection is known to have dropped, ahead of any timeout
+    virtual bool link_lost() { return false; }
+    
   };
 
 #endif
\ No newline at end of file
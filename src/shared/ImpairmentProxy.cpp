@@ -0,0 +1,178 @@
+#include "ImpairmentProxy.h"
+
+#include <zmq.hpp>
+#include <cstring>
+#include <iostream>
+
+#include "Clock.h"
+#include "Reactor.h"
+#include "ZeroMQContext.hpp"
+
+ImpairmentProxy::ImpairmentProxy(const Impairment& impairment, unsigned int seed)
+  : impairment_(impairment)
+  , state_(seed ? seed : 1)
+  , front_(0)
+  , back_(0)
+  , reactor_(0)
+  , timer_(0)
+  , sequence_(0)
+  , link_free_(0)
+  , forwarded_(0)
+  , dropped_(0)
+{
+  
+}
+
+ImpairmentProxy::~ImpairmentProxy()
+{
+  if (reactor_ != 0)
+  {
+    reactor_->remove(this);
+    
+    if (timer_ != 0)
+    {
+      reactor_->cancel_timer(timer_);
+    }
+  }
+  
+  delete front_;
+  delete back_;
+}
+
+bool ImpairmentProxy::bind(const std::string& address)
+{
+  front_ = ZeroMQContext::instance()->create_socket(ZMQ_PULL);
+  
+  try {
+    front_->bind(address.c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ImpairmentProxy::connect(const std::string& address)
+{
+  back_ = ZeroMQContext::instance()->create_socket(ZMQ_PUSH);
+  
+  try {
+    back_->connect(address.c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void ImpairmentProxy::attach(Reactor* reactor)
+{
+  reactor_ = reactor;
+  reactor->add_socket(*front_, this);
+}
+
+double ImpairmentProxy::random()
+{
+  // xorshift32: small, fast and the same on every platform, unlike rand()
+  state_ ^= state_ << 13;
+  state_ ^= state_ >> 17;
+  state_ ^= state_ << 5;
+  return state_ / 4294967296.0;
+}
+
+void ImpairmentProxy::on_readable()
+{
+  zmq::message_t message;
+  
+  while (front_->recv(&message, ZMQ_NOBLOCK))
+  {
+    // draw every number for every message so one setting never shifts the
+    // random sequence seen by the others
+    double loss = random();
+    double jitter = random();
+    double reorder = random();
+    
+    if (loss < impairment_.loss)
+    {
+      dropped_++;
+      continue;
+    }
+    
+    unsigned long long now = Clock::now_ms();
+    unsigned long long departure = now;
+    
+    // a capped link serialises messages one after the other, and only then
+    // does the path add its delay, so jitter can still reorder them
+    if (impairment_.bandwidth_bps > 0)
+    {
+      unsigned long long start = (link_free_ > now) ? link_free_ : now;
+      link_free_ = start + (message.size() * 8ULL * 1000) / impairment_.bandwidth_bps;
+      departure = link_free_;
+    }
+    
+    long delay = (long)impairment_.delay_ms + (long)((jitter * 2 - 1) * impairment_.jitter_ms);
+    departure += (delay > 0) ? delay : 0;
+    
+    if (reorder < impairment_.reorder)
+    {
+      departure += impairment_.reorder_ms;
+    }
+    
+    pending_[Departure(departure, sequence_++)] = std::string((char*)message.data(), message.size());
+  }
+  
+  forward_due();
+}
+
+void ImpairmentProxy::on_timer(int timer_id)
+{
+  timer_ = 0;
+  forward_due();
+}
+
+void ImpairmentProxy::forward_due()
+{
+  unsigned long long now = Clock::now_ms();
+  
+  while (!pending_.empty() && (*pending_.begin()).first.first <= now)
+  {
+    const std::string& payload = (*pending_.begin()).second;
+    
+    try {
+      zmq::message_t message(payload.size());
+      memcpy(message.data(), payload.data(), payload.size());
+      back_->send(message, ZMQ_NOBLOCK);
+      forwarded_++;
+    }
+    catch (zmq::error_t e) {
+      std::cerr << e.what() << std::endl;
+    }
+    
+    pending_.erase(pending_.begin());
+  }
+  
+  schedule();
+}
+
+void ImpairmentProxy::schedule()
+{
+  if (reactor_ == 0)
+  {
+    return;
+  }
+  
+  if (timer_ != 0)
+  {
+    reactor_->cancel_timer(timer_);
+    timer_ = 0;
+  }
+  
+  if (!pending_.empty())
+  {
+    unsigned long long now = Clock::now_ms();
+    unsigned long long due = (*pending_.begin()).first.first;
+    timer_ = reactor_->add_timer((due > now) ? (unsigned int)(due - now) : 0, this, false);
+  }
+}
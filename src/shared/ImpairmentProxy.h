@@ -0,0 +1,85 @@
+#ifndef IMPAIRMENTPROXY_H_
+#define IMPAIRMENTPROXY_H_
+
+  #include <map>
+  #include <string>
+  #include <utility>
+
+  #include "IReactorHandler.hpp"
+
+  namespace zmq { class socket_t; };
+
+  class Reactor;
+
+  struct Impairment
+  {
+    unsigned int delay_ms;
+    unsigned int jitter_ms;
+    double loss;
+    double reorder;
+    unsigned int reorder_ms;
+    unsigned int bandwidth_bps;
+  };
+
+  /*
+   * Stand-in for a bad network, for tests and benchmarks. Senders connect to
+   * the bound address instead of the real exit; every message is then dropped
+   * or delayed according to the Impairment and forwarded to the connected
+   * address. A reordered message is held back reorder_ms longer, so the ones
+   * after it overtake it. bandwidth_bps of 0 means unlimited.
+   *
+   * All randomness comes from the seed, so a run can be repeated exactly.
+   */
+  class ImpairmentProxy : public IReactorHandler, public ITimerHandler
+  {
+    
+    typedef std::pair<unsigned long long, unsigned long long> Departure;
+    typedef std::map<Departure, std::string> PendingList;
+    
+  public:
+    
+    ImpairmentProxy(const Impairment& impairment, unsigned int seed);
+    
+    ~ImpairmentProxy();
+    
+    bool bind(const std::string& address);
+    
+    bool connect(const std::string& address);
+    
+    void attach(Reactor* reactor);
+    
+    void on_readable();
+    
+    void on_timer(int timer_id);
+    
+    inline unsigned int forwarded() { return forwarded_; };
+    
+    inline unsigned int dropped() { return dropped_; };
+    
+  private:
+    
+    double random();
+    
+    void forward_due();
+    
+    void schedule();
+    
+    Impairment impairment_;
+    unsigned int state_;
+    
+    zmq::socket_t* front_;
+    zmq::socket_t* back_;
+    
+    Reactor* reactor_;
+    int timer_;
+    
+    PendingList pending_;
+    unsigned long long sequence_;
+    unsigned long long link_free_;
+    
+    unsigned int forwarded_;
+    unsigned int dropped_;
+    
+  };
+
+#endif
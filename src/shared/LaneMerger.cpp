@@ -0,0 +1,121 @@
+#include "LaneMerger.h"
+
+// sequence numbers compare modulo 2^32
+static bool is_newer(unsigned int sequence, unsigned int than)
+{
+  return (int)(sequence - than) > 0;
+}
+
+void LaneMerger::release(Lane& lane, MessageList& ready)
+{
+  ready.insert(ready.end(), lane.held.begin(), lane.held.end());
+  lane.held.clear();
+  lane.waiting_for = 0;
+}
+
+void LaneMerger::reliable(const Message& message, MessageList& ready)
+{
+  // messages from a peer without a motion lane carry no sequence
+  if (message.sequence == 0)
+  {
+    return;
+  }
+  
+  Lane& lane = lanes_[message.session];
+  
+  if (is_newer(message.sequence, lane.reliable))
+  {
+    lane.reliable = message.sequence;
+  }
+  
+  if (!lane.held.empty() && !is_newer(lane.waiting_for, lane.reliable))
+  {
+    release(lane, ready);
+  }
+}
+
+void LaneMerger::motion(const MotionPacket& packet, unsigned long long now_ms, MessageList& ready)
+{
+  Lane& lane = lanes_[packet.message.session];
+  
+  if (lane.motion != 0 && !is_newer(packet.sequence, lane.motion))
+  {
+    return;
+  }
+  
+  // totals wrap like the sequences, only their difference matters. The first
+  // packet seen from a controller that was already running moves by itself
+  // alone rather than by everything it ever sent
+  Message message = packet.message;
+  bool relative = is_relative_motion(message.type);
+  
+  if (lane.motion == 0)
+  {
+    lane.applied_x = packet.total_x - (relative ? (unsigned int)message.x : 0);
+    lane.applied_y = packet.total_y - (relative ? (unsigned int)message.y : 0);
+  }
+  
+  if (relative)
+  {
+    message.x = (int)(packet.total_x - lane.applied_x);
+    message.y = (int)(packet.total_y - lane.applied_y);
+    lane.applied_x = packet.total_x;
+    lane.applied_y = packet.total_y;
+  }
+  lane.motion = packet.sequence;
+  
+  if (!is_newer(packet.reliable, lane.reliable) && lane.held.empty())
+  {
+    ready.push_back(message);
+    return;
+  }
+  
+  if (lane.held.empty())
+  {
+    lane.held_since = now_ms;
+  }
+  
+  if (is_newer(packet.reliable, lane.waiting_for))
+  {
+    lane.waiting_for = packet.reliable;
+  }
+  lane.held.push_back(message);
+}
+
+void LaneMerger::expire(unsigned long long now_ms, MessageList& ready)
+{
+  for (LaneList::iterator i = lanes_.begin(); i != lanes_.end(); ++i)
+  {
+    Lane& lane = (*i).second;
+    
+    if (!lane.held.empty() && now_ms - lane.held_since >= MOTION_HOLD_TIMEOUT)
+    {
+      release(lane, ready);
+    }
+  }
+}
+
+long LaneMerger::next_timeout(unsigned long long now_ms)
+{
+  long timeout = -1;
+  
+  for (LaneList::iterator i = lanes_.begin(); i != lanes_.end(); ++i)
+  {
+    Lane& lane = (*i).second;
+    
+    if (lane.held.empty())
+    {
+      continue;
+    }
+    
+    unsigned long long expiry = lane.held_since + MOTION_HOLD_TIMEOUT;
+    long remaining = (expiry <= now_ms) ? 0 : (long)(expiry - now_ms);
+    
+    if (timeout < 0 || remaining < timeout)
+    {
+      timeout = remaining;
+    }
+  }
+  
+  return timeout;
+}
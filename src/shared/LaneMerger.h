@@ -0,0 +1,55 @@
+#ifndef LANEMERGER_H_
+#define LANEMERGER_H_
+
+  #include <map>
+  #include <vector>
+
+  #include "MotionLane.h"
+
+  typedef std::vector<Message> MessageList;
+
+  /*
+   * Puts the UDP motion lane back in order with the reliable stream, per
+   * session. Motion older than what was already applied is dropped; motion
+   * sent after a key or button event that has not arrived yet is held until
+   * it does, or until MOTION_HOLD_TIMEOUT passes. A relative delta is
+   * rewritten from the packet's running total, so it also carries whatever
+   * the dropped or lost packets before it moved.
+   */
+  class LaneMerger
+  {
+    
+    struct Lane
+    {
+      unsigned int reliable;
+      unsigned int motion;
+      unsigned int waiting_for;
+      unsigned int applied_x;
+      unsigned int applied_y;
+      unsigned long long held_since;
+      MessageList held;
+      
+      Lane() : reliable(0), motion(0), waiting_for(0), applied_x(0), applied_y(0), held_since(0) { };
+    };
+    
+    typedef std::map<unsigned int, Lane> LaneList;
+    
+  public:
+    
+    void reliable(const Message& message, MessageList& ready);
+    
+    void motion(const MotionPacket& packet, unsigned long long now_ms, MessageList& ready);
+    
+    void expire(unsigned long long now_ms, MessageList& ready);
+    
+    long next_timeout(unsigned long long now_ms);
+    
+  private:
+    
+    void release(Lane& lane, MessageList& ready);
+    
+    LaneList lanes_;
+    
+  };
+
+#endif
@@ -0,0 +1,220 @@
+#include "Lz4Compressor.h"
+
+#include <cstring>
+
+// the format leaves the last bytes of a block as literals so a decoder can
+// copy matches in whole words without running off the end
+static const size_t MIN_MATCH = 4;
+static const size_t LAST_LITERALS = 5;
+static const size_t MATCH_FIND_LIMIT = 12;
+static const size_t MAX_DISTANCE = 65535;
+
+static unsigned int read32(const char* p)
+{
+  unsigned int value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+static char* write_length(char* op, const char* end, size_t length)
+{
+  while (length >= 255)
+  {
+    if (op >= end)
+    {
+      return 0;
+    }
+    *op++ = (char)255;
+    length -= 255;
+  }
+  
+  if (op >= end)
+  {
+    return 0;
+  }
+  *op++ = (char)length;
+  return op;
+}
+
+static char* write_sequence(char* op, const char* end, const char* literals, size_t literal_length, size_t offset, size_t match_length)
+{
+  if (op >= end)
+  {
+    return 0;
+  }
+  
+  char* token = op++;
+  *token = (char)(((literal_length < 15) ? literal_length : 15) << 4);
+  
+  if (literal_length >= 15 && (op = write_length(op, end, literal_length - 15)) == 0)
+  {
+    return 0;
+  }
+  
+  if ((size_t)(end - op) < literal_length)
+  {
+    return 0;
+  }
+  memcpy(op, literals, literal_length);
+  op += literal_length;
+  
+  // the final sequence is literals only
+  if (match_length == 0)
+  {
+    return op;
+  }
+  
+  if (end - op < 2)
+  {
+    return 0;
+  }
+  *op++ = (char)(offset & 0xFF);
+  *op++ = (char)(offset >> 8);
+  
+  match_length -= MIN_MATCH;
+  *token |= (char)((match_length < 15) ? match_length : 15);
+  
+  if (match_length >= 15)
+  {
+    op = write_length(op, end, match_length - 15);
+  }
+  return op;
+}
+
+int Lz4Compressor::codec()
+{
+  return CODEC_LZ4;
+}
+
+size_t Lz4Compressor::bound(size_t size)
+{
+  return size + size / 255 + 16;
+}
+
+size_t Lz4Compressor::compress(const char* data, size_t size, char* out, size_t capacity)
+{
+  const char* end = out + capacity;
+  char* op = out;
+  size_t anchor = 0;
+  
+  if (size > MATCH_FIND_LIMIT)
+  {
+    memset(table_, 0, sizeof(table_));
+    
+    size_t limit = size - MATCH_FIND_LIMIT;
+    size_t match_limit = size - LAST_LITERALS;
+    size_t position = 1;
+    
+    while (position < limit)
+    {
+      unsigned int sequence = read32(data + position);
+      unsigned int hash = (sequence * 2654435761U) >> (32 - HASH_BITS);
+      size_t candidate = table_[hash];
+      table_[hash] = (unsigned int)position;
+      
+      if (position - candidate > MAX_DISTANCE || read32(data + candidate) != sequence)
+      {
+        // skip faster through data that keeps failing to match
+        position += 1 + ((position - anchor) >> 6);
+        continue;
+      }
+      
+      size_t length = MIN_MATCH;
+      while (position + length < match_limit && data[candidate + length] == data[position + length])
+      {
+        length++;
+      }
+      
+      op = write_sequence(op, end, data + anchor, position - anchor, position - candidate, length);
+      if (op == 0)
+      {
+        return 0;
+      }
+      
+      position += length;
+      anchor = position;
+    }
+  }
+  
+  op = write_sequence(op, end, data + anchor, size - anchor, 0, 0);
+  return (op == 0) ? 0 : (size_t)(op - out);
+}
+
+static bool read_length(const char*& ip, const char* end, size_t& length)
+{
+  unsigned char byte = 255;
+  
+  while (byte == 255)
+  {
+    if (ip >= end)
+    {
+      return false;
+    }
+    byte = (unsigned char)*ip++;
+    length += byte;
+  }
+  return true;
+}
+
+bool Lz4Compressor::decompress(const char* data, size_t data_size, char* out, size_t size)
+{
+  const char* ip = data;
+  const char* end = data + data_size;
+  size_t written = 0;
+  
+  while (ip < end)
+  {
+    unsigned char token = (unsigned char)*ip++;
+    
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !read_length(ip, end, literal_length))
+    {
+      return false;
+    }
+    
+    if ((size_t)(end - ip) < literal_length || size - written < literal_length)
+    {
+      return false;
+    }
+    if (literal_length > 0)
+    {
+      memcpy(out + written, ip, literal_length);
+    }
+    ip += literal_length;
+    written += literal_length;
+    
+    if (ip == end)
+    {
+      break;
+    }
+    
+    if (end - ip < 2)
+    {
+      return false;
+    }
+    size_t offset = (unsigned char)ip[0] | ((size_t)(unsigned char)ip[1] << 8);
+    ip += 2;
+    
+    size_t match_length = token & 15;
+    if (match_length == 15 && !read_length(ip, end, match_length))
+    {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    
+    if (offset == 0 || offset > written || size - written < match_length)
+    {
+      return false;
+    }
+    
+    // byte by byte, as a match may overlap the bytes it is producing
+    const char* match = out + written - offset;
+    for (size_t i = 0; i < match_length; i++)
+    {
+      out[written + i] = match[i];
+    }
+    written += match_length;
+  }
+  
+  return written == size;
+}
@@ -0,0 +1,33 @@
+#ifndef LZ4COMPRESSOR_H_
+#define LZ4COMPRESSOR_H_
+
+  #include "ICompressor.hpp"
+
+  /*
+   * The LZ4 block format: a greedy single-probe hash match over a 64K
+   * window, no entropy stage. Output decodes with any LZ4 block decoder,
+   * it is just tuned for the short frames of the bulk channels rather than
+   * for ratio.
+   */
+  class Lz4Compressor : public ICompressor
+  {
+    
+  public:
+    
+    int codec();
+    
+    size_t bound(size_t size);
+    
+    size_t compress(const char* data, size_t size, char* out, size_t capacity);
+    
+    bool decompress(const char* data, size_t data_size, char* out, size_t size);
+    
+  private:
+    
+    static const int HASH_BITS = 12;
+    
+    unsigned int table_[1 << HASH_BITS];
+    
+  };
+
+#endif
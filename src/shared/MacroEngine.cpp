@@ -0,0 +1,182 @@
+#include "MacroEngine.h"
+
+#include <iostream>
+
+#include "Constants.hpp"
+
+bool MacroEngine::define(const Message& message)
+{
+  switch (message.type)
+  {
+    case MACRO_BEGIN:
+      recordings_[message.session] = std::make_pair(message.key_code, Macro());
+      return true;
+
+    case MACRO_END:
+      store(message.session);
+      return true;
+
+    case MACRO_CANCEL:
+      cancel(message.session);
+      return true;
+
+    case MACRO_RUN:
+      return false;
+  }
+
+  RecordingList::iterator recording = recordings_.find(message.session);
+
+  if (recording == recordings_.end())
+  {
+    return (message.type == MACRO_WAIT);
+  }
+
+  Macro& macro = recording->second.second;
+
+  // waits add up until the next step, which then carries them as its delay
+  if (message.type == MACRO_WAIT)
+  {
+    macro.tail += (message.x > 0) ? message.x : 0;
+    return true;
+  }
+
+  if (macro.steps.size() >= MACRO_STEP_LIMIT)
+  {
+    std::cerr << "macro " << recording->second.first << " is too long, dropped" << std::endl;
+    recordings_.erase(recording);
+    return true;
+  }
+
+  Step step;
+  step.message = message;
+  step.delay = macro.tail;
+  macro.steps.push_back(step);
+  macro.tail = 0;
+  return true;
+}
+
+void MacroEngine::store(unsigned int session)
+{
+  RecordingList::iterator recording = recordings_.find(session);
+
+  if (recording == recordings_.end())
+  {
+    return;
+  }
+
+  int id = recording->second.first;
+
+  if (macros_.find(id) == macros_.end() && macros_.size() >= MACRO_LIMIT)
+  {
+    std::cerr << "too many macros, " << id << " dropped" << std::endl;
+    recordings_.erase(recording);
+    return;
+  }
+
+  // runs index into the steps, so nothing may keep playing the old version
+  for (RunList::iterator run = runs_.begin(); run != runs_.end();)
+  {
+    run = (run->id == id) ? runs_.erase(run) : ++run;
+  }
+
+  macros_[id] = recording->second.second;
+  recordings_.erase(recording);
+}
+
+void MacroEngine::run(const Message& message, unsigned long long now_ms)
+{
+  MacroList::iterator macro = macros_.find(message.key_code);
+
+  if (macro == macros_.end() || macro->second.steps.empty())
+  {
+    return;
+  }
+
+  Run run;
+  run.id = message.key_code;
+  run.session = message.session;
+  run.repeat = (message.flags == 0) ? 1 : message.flags;
+  run.repeat = (run.repeat > MACRO_REPEAT_LIMIT) ? MACRO_REPEAT_LIMIT : run.repeat;
+  run.x = message.x;
+  run.y = message.y;
+  run.step = 0;
+  run.due = now_ms + macro->second.steps[0].delay;
+  runs_.push_back(run);
+}
+
+void MacroEngine::cancel(unsigned int session)
+{
+  recordings_.erase(session);
+
+  for (RunList::iterator run = runs_.begin(); run != runs_.end();)
+  {
+    run = (run->session == session) ? runs_.erase(run) : ++run;
+  }
+}
+
+void MacroEngine::due(unsigned long long now_ms, MessageList& ready)
+{
+  size_t budget = MACRO_BATCH_LIMIT;
+
+  for (RunList::iterator run = runs_.begin(); run != runs_.end();)
+  {
+    const Macro& macro = macros_[run->id];
+    bool finished = false;
+
+    while (!finished && run->due <= now_ms)
+    {
+      // out of budget: this run goes last next time so the others get a turn
+      if (budget == 0)
+      {
+        runs_.splice(runs_.end(), runs_, run);
+        return;
+      }
+      budget--;
+
+      Message message = macro.steps[run->step].message;
+      message.session = run->session;
+      message.sequence = 0;
+
+      if (message.type == MOUSE_POSITION)
+      {
+        message.x += run->x;
+        message.y += run->y;
+      }
+
+      ready.push_back(message);
+
+      if (++run->step < macro.steps.size())
+      {
+        run->due += macro.steps[run->step].delay;
+      }
+      else if (--run->repeat > 0)
+      {
+        run->step = 0;
+        run->due += macro.tail + macro.steps[0].delay;
+      }
+      else
+      {
+        finished = true;
+      }
+    }
+
+    run = finished ? runs_.erase(run) : ++run;
+  }
+}
+
+long MacroEngine::next_timeout(unsigned long long now_ms)
+{
+  long timeout = -1;
+
+  for (RunList::iterator run = runs_.begin(); run != runs_.end(); ++run)
+  {
+    long remaining = (run->due > now_ms) ? (long)(run->due - now_ms) : 0;
+
+    if (timeout < 0 || remaining < timeout)
+    {
+      timeout = remaining;
+    }
+  }
+
+  return timeout;
+}
@@ -0,0 +1,82 @@
+#ifndef MACROENGINE_H_
+#define MACROENGINE_H_
+
+  #include <cstddef>
+  #include <list>
+  #include <map>
+  #include <vector>
+
+  #include "Message.h"
+  #include "LaneMerger.h"
+
+  /*
+   * Named input macros stored on the exit. A controller uploads one as
+   * MACRO_BEGIN (key_code is the id), ordinary messages with MACRO_WAIT
+   * (x is milliseconds) between them, then MACRO_END. MACRO_RUN plays it back
+   * from the exit's own timers: key_code picks the macro, x and y offset any
+   * absolute positions and flags is the repeat count. MACRO_CANCEL stops
+   * every run belonging to the sender.
+   *
+   * Steps are due on a schedule measured from when the run started, not from
+   * when the last step happened to fire, so timer latency does not add up.
+   * due() hands out at most MACRO_BATCH_LIMIT steps per call and reports a
+   * zero timeout while more are due, so a macro with no waits in it is
+   * played out over several passes of the loop instead of all at once.
+   */
+  class MacroEngine
+  {
+    
+    struct Step
+    {
+      Message message;
+      unsigned int delay;
+    };
+    
+    typedef std::vector<Step> StepList;
+    
+    struct Macro
+    {
+      StepList steps;
+      unsigned int tail;
+      
+      Macro() : tail(0) { };
+    };
+    
+    struct Run
+    {
+      int id;
+      unsigned int session;
+      unsigned int repeat;
+      int x;
+      int y;
+      size_t step;
+      unsigned long long due;
+    };
+    
+    typedef std::map<int, Macro> MacroList;
+    typedef std::map<unsigned int, std::pair<int, Macro> > RecordingList;
+    typedef std::list<Run> RunList;
+    
+  public:
+    
+    bool define(const Message& message);
+    
+    void run(const Message& message, unsigned long long now_ms);
+    
+    void cancel(unsigned int session);
+    
+    void due(unsigned long long now_ms, MessageList& ready);
+    
+    long next_timeout(unsigned long long now_ms);
+    
+  private:
+    
+    void store(unsigned int session);
+    
+    MacroList macros_;
+    RecordingList recordings_;
+    RunList runs_;
+    
+  };
+
+#endif
@@ -16,17 +16,44 @@ enum MessageTypes
 	SCROLL_WHEEL = 10,
 	LEFT_DOUBLE_CLICK = 11,
 	KEY_UP = 12,
-	MESSAGETYPE_MAX = 13
+	MOUSE_POSITION = 13,
+	TEXT = 14,
+	MACRO_BEGIN = 15,
+	MACRO_WAIT = 16,
+	MACRO_END = 17,
+	MACRO_RUN = 18,
+	MACRO_CANCEL = 19,
+	TOUCH_MOVE = 20,
+	MESSAGETYPE_MAX = 21
 };
 
+/*
+ * A TEXT message carries up to MESSAGE_TEXT_SIZE bytes of UTF-8 in text,
+ * NUL terminated when shorter. Twenty bytes is as much as one OS X keyboard
+ * event will type, so each message injects in a single call.
+ */
+static const int MESSAGE_TEXT_SIZE = 20;
+
 struct Message 
 {  
 	int type;
 	int x;
 	int y;
 	int key_code;
-	char key_text;
+	char text[MESSAGE_TEXT_SIZE];
 	unsigned int flags;
+	unsigned int session;
+	unsigned int sequence;
 };
 
+inline int text_length(const Message& message)
+{
+	int length = 0;
+	while (length < MESSAGE_TEXT_SIZE && message.text[length] != 0)
+	{
+		length++;
+	}
+	return length;
+}
+
 #endif
\ No newline at end of file
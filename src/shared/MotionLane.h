@@ -0,0 +1,38 @@
+#ifndef MOTIONLANE_H_
+#define MOTIONLANE_H_
+
+  #include "Message.h"
+
+  /*
+   * Motion travelling over UDP instead of the zmq stream. sequence orders the
+   * motion lane itself; reliable is the Message::sequence of the last event
+   * sent on the zmq stream before it, so the exit can keep the two lanes in
+   * causal order. total_x and total_y add up every relative delta sent on the
+   * lane so far, this one included, so the exit can make up for packets that
+   * were lost or overtaken instead of letting the cursor drift.
+   */
+  struct MotionPacket
+  {
+    unsigned int sequence;
+    unsigned int reliable;
+    unsigned int total_x;
+    unsigned int total_y;
+    Message message;
+  };
+
+  static const unsigned int MOTION_PORT = 44203;
+
+  // how long motion waits for a key or button event it was sent after
+  static const unsigned int MOTION_HOLD_TIMEOUT = 50;
+
+  inline bool is_motion_message(int type)
+  {
+    return type == MOUSE_MOVE || type == LEFT_DRAGGED || type == RIGHT_DRAGGED || type == MOUSE_POSITION;
+  }
+
+  inline bool is_relative_motion(int type)
+  {
+    return type == MOUSE_MOVE || type == LEFT_DRAGGED || type == RIGHT_DRAGGED;
+  }
+
+#endif
@@ -0,0 +1,75 @@
+#include "MotionLaneSocket.h"
+
+#include <cstring>
+
+#include "MotionLane.h"
+
+MotionLaneSocket::MotionLaneSocket(ISendSocket* reliable, bool broadcast)
+  : reliable_(reliable)
+  , broadcast_(broadcast)
+  , defining_(false)
+  , reliable_sequence_(0)
+  , motion_sequence_(0)
+  , total_x_(0)
+  , total_y_(0)
+{
+  
+}
+
+bool MotionLaneSocket::connect_to(const std::string& host, unsigned int port)
+{
+  if (!broadcast_)
+  {
+    datagrams_.clear_targets();
+  }
+  
+  datagrams_.add_target(host, MOTION_PORT);
+  return reliable_->connect_to(host, port);
+}
+
+bool MotionLaneSocket::link_lost()
+{
+  return reliable_->link_lost();
+}
+
+void MotionLaneSocket::terminate()
+{
+  datagrams_.clear_targets();
+  reliable_->terminate();
+}
+
+bool MotionLaneSocket::send(void *data, size_t data_size)
+{
+  if (data_size != sizeof(Message))
+  {
+    return reliable_->send(data, data_size);
+  }
+  
+  Message* message = (Message*)data;
+  
+  if (message->type == MACRO_BEGIN || message->type == MACRO_END)
+  {
+    defining_ = (message->type == MACRO_BEGIN);
+  }
+  
+  if (defining_ || !is_motion_message(message->type))
+  {
+    message->sequence = ++reliable_sequence_;
+    return reliable_->send(data, data_size);
+  }
+  
+  if (is_relative_motion(message->type))
+  {
+    total_x_ += (unsigned int)message->x;
+    total_y_ += (unsigned int)message->y;
+  }
+  
+  MotionPacket packet;
+  packet.sequence = ++motion_sequence_;
+  packet.reliable = reliable_sequence_;
+  packet.total_x = total_x_;
+  packet.total_y = total_y_;
+  memcpy(&packet.message, message, sizeof(Message));
+  
+  return datagrams_.send(&packet, sizeof(packet));
+}
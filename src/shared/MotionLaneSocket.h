@@ -0,0 +1,44 @@
+#ifndef MOTIONLANESOCKET_H_
+#define MOTIONLANESOCKET_H_
+
+  #include "ISendSocket.hpp"
+  #include "DatagramSocket.h"
+
+  /*
+   * Wraps a reliable ISendSocket and diverts motion to UDP, so a lost TCP
+   * segment no longer holds up every later delta. Everything else still goes
+   * through the wrapped socket. With broadcast set every connect_to() adds a
+   * target instead of replacing it, matching ZeroMQBroadcastSocket.
+   * Between MACRO_BEGIN and MACRO_END motion is being stored rather than
+   * played, so it stays on the reliable socket where none of it can be lost.
+   */
+  class MotionLaneSocket : public ISendSocket
+  {
+    
+  public:
+    
+    MotionLaneSocket(ISendSocket* reliable, bool broadcast = false);
+    
+    bool connect_to(const std::string& host, unsigned int port);
+    
+    void terminate();
+    
+    bool send(void *data, size_t data_size);
+    
+    bool link_lost();
+    
+  private:
+    
+    ISendSocket* reliable_;
+    DatagramSocket datagrams_;
+    
+    bool broadcast_;
+    bool defining_;
+    unsigned int reliable_sequence_;
+    unsigned int motion_sequence_;
+    unsigned int total_x_;
+    unsigned int total_y_;
+    
+  };
+
+#endif
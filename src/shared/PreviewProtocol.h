@@ -0,0 +1,48 @@
+#ifndef PREVIEWPROTOCOL_H_
+#define PREVIEWPROTOCOL_H_
+
+  /*
+   * Every preview message starts with a PreviewEnvelope, which says how the
+   * rest was compressed (see BulkCodec) and how long it is once expanded.
+   */
+  struct PreviewEnvelope
+  {
+    unsigned int codec;
+    unsigned int size;
+  };
+
+  /*
+   * One preview message is a PreviewHeader followed by tile_count tiles, each
+   * a PreviewTile and its run-length encoded RGB565 pixels. Tiles are
+   * addressed in full resolution tile coordinates; their pixels are already
+   * scaled down by the header's scale.
+   */
+  struct PreviewHeader
+  {
+    unsigned int frame;
+    unsigned short width;
+    unsigned short height;
+    unsigned short scale;
+    unsigned short tile_count;
+  };
+
+  struct PreviewTile
+  {
+    unsigned short x;
+    unsigned short y;
+    unsigned short width;
+    unsigned short height;
+    unsigned int size;
+  };
+
+  static const unsigned int PREVIEW_PORT = 44202;
+  static const unsigned int PREVIEW_TILE_SIZE = 32;
+  static const unsigned int PREVIEW_SCALE = 4;
+  static const unsigned int PREVIEW_INTERVAL = 500;
+  static const unsigned int PREVIEW_HWM = 2;
+
+  // every tile is resent at least this often, so a subscriber that joined
+  // late or lost a message catches up by itself
+  static const unsigned int PREVIEW_REFRESH_FRAMES = 8;
+
+#endif
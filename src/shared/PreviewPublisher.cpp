@@ -0,0 +1,106 @@
+#include "PreviewPublisher.h"
+
+#include <zmq.hpp>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "Lz4Compressor.h"
+#include "Reactor.h"
+#include "ZeroMQContext.hpp"
+
+PreviewPublisher::PreviewPublisher(IFrameSource* source)
+  : source_(source)
+  , socket_(0)
+  , subscribers_(0)
+  , idle_(true)
+{
+  
+}
+
+PreviewPublisher::~PreviewPublisher()
+{
+  delete socket_;
+}
+
+bool PreviewPublisher::bind(unsigned int port)
+{
+  std::stringstream address;
+  address << "tcp://*:" << port;
+  
+  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_PUB, ZeroMQContext::BULK_LANE);
+  
+  try {
+    unsigned long long hwm = PREVIEW_HWM;
+    socket_->setsockopt(ZMQ_HWM, &hwm, sizeof(hwm));
+#ifdef ZMQ_HAVE_MONITOR_CALLBACK
+    socket_->monitor(&PreviewPublisher::on_event, this, ZMQ_EVENT_ACCEPTED | ZMQ_EVENT_DISCONNECTED);
+#endif
+    socket_->bind(address.str().c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void PreviewPublisher::attach(Reactor* reactor)
+{
+  reactor->add_timer(PREVIEW_INTERVAL, this);
+}
+
+void PreviewPublisher::set_compression(bool enabled)
+{
+  codec_.set_compressor(enabled ? new Lz4Compressor() : 0);
+}
+
+void PreviewPublisher::on_event(void* socket, int event, const char* endpoint, int err, void* hint)
+{
+  PreviewPublisher* publisher = reinterpret_cast<PreviewPublisher*>(hint);
+  publisher->subscribers_ += (event == ZMQ_EVENT_ACCEPTED) ? 1 : -1;
+}
+
+void PreviewPublisher::on_timer(int timer_id)
+{
+  Frame frame;
+  
+#ifdef ZMQ_HAVE_MONITOR_CALLBACK
+  // nobody is watching, and whoever connects next needs a whole frame
+  if (subscribers_ <= 0)
+  {
+    idle_ = true;
+    return;
+  }
+#endif
+  
+  if (socket_ == 0 || !source_->capture(frame))
+  {
+    return;
+  }
+  
+  if (idle_)
+  {
+    encoder_.reset();
+    idle_ = false;
+  }
+  
+  std::string encoded;
+  encoder_.encode(frame, encoded);
+  source_->release(frame);
+  
+  std::string packed;
+  PreviewEnvelope envelope = { CODEC_NONE, (unsigned int)encoded.size() };
+  envelope.codec = codec_.encode(encoded.data(), encoded.size(), packed);
+  const std::string& body = (envelope.codec != CODEC_NONE) ? packed : encoded;
+  
+  try {
+    zmq::message_t message(sizeof(envelope) + body.size());
+    memcpy(message.data(), &envelope, sizeof(envelope));
+    memcpy((char*)message.data() + sizeof(envelope), body.data(), body.size());
+    socket_->send(message, ZMQ_NOBLOCK);
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
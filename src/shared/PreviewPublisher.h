@@ -0,0 +1,64 @@
+#ifndef PREVIEWPUBLISHER_H_
+#define PREVIEWPUBLISHER_H_
+
+  #include "BulkCodec.h"
+  #include "IReactorHandler.hpp"
+  #include "TileEncoder.h"
+
+  namespace zmq { class socket_t; };
+
+  class Reactor;
+
+  class IFrameSource
+  {
+    
+  public:
+    
+    virtual bool capture(Frame& frame) = 0;
+    
+    virtual void release(Frame& frame) = 0;
+    
+  };
+
+  /*
+   * Publishes a low rate, tile-diffed preview of the exit's screen. The PUB
+   * socket keeps at most PREVIEW_HWM messages per subscriber and drops the
+   * rest, so a slow controller only ever sees a stale thumbnail. Where the
+   * socket can report its connections the screen is only captured while
+   * someone is connected.
+   */
+  class PreviewPublisher : public ITimerHandler
+  {
+    
+  public:
+    
+    PreviewPublisher(IFrameSource* source);
+    
+    ~PreviewPublisher();
+    
+    bool bind(unsigned int port);
+    
+    void attach(Reactor* reactor);
+    
+    void on_timer(int timer_id);
+    
+    // call before attach, frames are encoded on the reactor's thread
+    void set_compression(bool enabled);
+    
+  private:
+    
+    static void on_event(void* socket, int event, const char* endpoint, int err, void* hint);
+    
+    IFrameSource* source_;
+    TileEncoder encoder_;
+    BulkCodec codec_;
+    
+    zmq::socket_t* socket_;
+    
+    // only ever changed from the bulk lane's I/O thread
+    volatile int subscribers_;
+    bool idle_;
+    
+  };
+
+#endif
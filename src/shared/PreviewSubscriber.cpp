@@ -0,0 +1,146 @@
+#include "PreviewSubscriber.h"
+
+#include <zmq.hpp>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "BulkCodec.h"
+#include "Reactor.h"
+#include "ZeroMQContext.hpp"
+
+PreviewSubscriber::PreviewSubscriber()
+  : socket_(0)
+  , inbox_(0)
+  , inbox_handler_(this)
+  , reactor_(0)
+  , listener_(0)
+{
+  inbox_ = ZeroMQContext::instance()->create_socket(ZMQ_PULL);
+  
+  try {
+    inbox_->bind(inbox_address().c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+PreviewSubscriber::~PreviewSubscriber()
+{
+  if (reactor_ != 0)
+  {
+    reactor_->remove(this);
+    reactor_->remove(&inbox_handler_);
+  }
+  
+  delete socket_;
+  delete inbox_;
+}
+
+std::string PreviewSubscriber::inbox_address()
+{
+  std::stringstream address;
+  address << "inproc://preview-" << this;
+  return address.str();
+}
+
+void PreviewSubscriber::attach(Reactor* reactor, IPreviewListener* listener)
+{
+  reactor_ = reactor;
+  listener_ = listener;
+  reactor->add_socket(*inbox_, &inbox_handler_);
+}
+
+void PreviewSubscriber::connect_to(const std::string& host, unsigned int port)
+{
+  std::stringstream address;
+  address << "tcp://" << host << ":" << port;
+  std::string final_address = address.str();
+  
+  try {
+    zmq::socket_t* socket = ZeroMQContext::instance()->create_socket(ZMQ_PUSH);
+    socket->connect(inbox_address().c_str());
+    
+    zmq::message_t message(final_address.size());
+    memcpy(message.data(), final_address.data(), final_address.size());
+    socket->send(message);
+    
+    delete socket;
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+void PreviewSubscriber::drain_inbox()
+{
+  zmq::message_t message;
+  
+  while (inbox_->recv(&message, ZMQ_NOBLOCK))
+  {
+    open(std::string((char*)message.data(), message.size()));
+  }
+}
+
+void PreviewSubscriber::open(const std::string& address)
+{
+  if (socket_ != 0)
+  {
+    reactor_->remove(this);
+    delete socket_;
+  }
+  
+  // a new exit starts from a blank canvas
+  decoder_ = TileDecoder();
+  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_SUB, ZeroMQContext::BULK_LANE);
+  
+  try {
+    unsigned long long hwm = PREVIEW_HWM;
+    socket_->setsockopt(ZMQ_HWM, &hwm, sizeof(hwm));
+    socket_->setsockopt(ZMQ_SUBSCRIBE, "", 0);
+    socket_->connect(address.c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    return;
+  }
+  
+  reactor_->add_socket(*socket_, this);
+}
+
+void PreviewSubscriber::on_readable()
+{
+  zmq::message_t message;
+  bool updated = false;
+  
+  while (socket_->recv(&message, ZMQ_NOBLOCK))
+  {
+    PreviewEnvelope envelope;
+    if (message.size() < sizeof(envelope))
+    {
+      continue;
+    }
+    memcpy(&envelope, message.data(), sizeof(envelope));
+    
+    const char* body = (char*)message.data() + sizeof(envelope);
+    size_t body_size = message.size() - sizeof(envelope);
+    
+    if (envelope.codec == CODEC_NONE)
+    {
+      updated |= decoder_.decode(body, body_size);
+      continue;
+    }
+    
+    std::string unpacked;
+    if (BulkCodec::decode(envelope.codec, body, body_size, envelope.size, unpacked))
+    {
+      updated |= decoder_.decode(unpacked.data(), unpacked.size());
+    }
+  }
+  
+  if (updated && listener_ != 0)
+  {
+    listener_->on_preview(decoder_.width(), decoder_.height(), decoder_.pixels());
+  }
+}
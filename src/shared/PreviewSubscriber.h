@@ -0,0 +1,75 @@
+#ifndef PREVIEWSUBSCRIBER_H_
+#define PREVIEWSUBSCRIBER_H_
+
+  #include <string>
+
+  #include "IReactorHandler.hpp"
+  #include "TileEncoder.h"
+
+  namespace zmq { class socket_t; };
+
+  class Reactor;
+
+  class IPreviewListener
+  {
+    
+  public:
+    
+    virtual void on_preview(int width, int height, const unsigned char* pixels) = 0;
+    
+  };
+
+  /*
+   * Follows the preview stream of one exit at a time. connect_to() may be
+   * called from any thread; everything else runs on the reactor's.
+   */
+  class PreviewSubscriber : public IReactorHandler
+  {
+    
+    class Inbox : public IReactorHandler
+    {
+      
+    public:
+      
+      Inbox(PreviewSubscriber* subscriber) : subscriber_(subscriber) { };
+      
+      void on_readable() { subscriber_->drain_inbox(); };
+      
+    private:
+      
+      PreviewSubscriber* subscriber_;
+      
+    };
+    
+  public:
+    
+    PreviewSubscriber();
+    
+    ~PreviewSubscriber();
+    
+    void attach(Reactor* reactor, IPreviewListener* listener);
+    
+    void on_readable();
+    
+    void connect_to(const std::string& host, unsigned int port);
+    
+  private:
+    
+    void drain_inbox();
+    
+    void open(const std::string& address);
+    
+    std::string inbox_address();
+    
+    zmq::socket_t* socket_;
+    zmq::socket_t* inbox_;
+    Inbox inbox_handler_;
+    
+    Reactor* reactor_;
+    IPreviewListener* listener_;
+    
+    TileDecoder decoder_;
+    
+  };
+
+#endif
@@ -0,0 +1,148 @@
+#include "Reactor.h"
+
+#include <zmq.hpp>
+#include <iostream>
+#include <sstream>
+
+#include "Clock.h"
+#include "ZeroMQContext.hpp"
+
+Reactor::Reactor()
+  : timers_(Clock::now_ms())
+  , wake_socket_(0)
+  , stopped_(false)
+{
+  wake_socket_ = ZeroMQContext::instance()->create_socket(ZMQ_PULL);
+  
+  try {
+    wake_socket_->bind(wake_address().c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
+
+Reactor::~Reactor()
+{
+  delete wake_socket_;
+}
+
+std::string Reactor::wake_address()
+{
+  std::stringstream address;
+  address << "inproc://reactor-" << this;
+  return address.str();
+}
+
+void Reactor::add_socket(void* socket, IReactorHandler* handler)
+{
+  Source source;
+  source.socket = socket;
+  source.fd = 0;
+  source.handler = handler;
+  sources_.push_back(source);
+}
+
+void Reactor::add_fd(int fd, IReactorHandler* handler)
+{
+  Source source;
+  source.socket = 0;
+  source.fd = fd;
+  source.handler = handler;
+  sources_.push_back(source);
+}
+
+void Reactor::remove(IReactorHandler* handler)
+{
+  for (SourceList::iterator i = sources_.begin(); i != sources_.end();)
+  {
+    if ((*i).handler == handler)
+    {
+      i = sources_.erase(i);
+    }
+    else
+    {
+      ++i;
+    }
+  }
+}
+
+int Reactor::add_timer(unsigned int interval_ms, ITimerHandler* handler, bool repeat)
+{
+  return timers_.schedule(Clock::now_ms(), interval_ms, handler, repeat);
+}
+
+void Reactor::cancel_timer(int timer_id)
+{
+  timers_.cancel(timer_id);
+}
+
+void Reactor::run()
+{
+  std::vector<zmq::pollitem_t> items;
+  
+  while (!stopped_)
+  {
+    items.resize(sources_.size() + 1);
+    
+    items[0].socket = *wake_socket_;
+    items[0].fd = 0;
+    items[0].events = ZMQ_POLLIN;
+    
+    for (SourceList::size_type i = 0; i != sources_.size(); i++)
+    {
+      items[i + 1].socket = sources_[i].socket;
+      items[i + 1].fd = sources_[i].fd;
+      items[i + 1].events = ZMQ_POLLIN;
+    }
+    
+    long timeout = timers_.next_timeout(Clock::now_ms());
+    
+    try {
+      // zmq_poll takes its timeout in microseconds
+      zmq::poll(&items[0], items.size(), (timeout < 0) ? -1 : timeout * 1000);
+    }
+    catch (zmq::error_t e) {
+      std::cerr << e.what() << std::endl;
+      break;
+    }
+    
+    if (items[0].revents & ZMQ_POLLIN)
+    {
+      zmq::message_t message;
+      while (wake_socket_->recv(&message, ZMQ_NOBLOCK));
+    }
+    
+    SourceList ready;
+    for (SourceList::size_type i = 0; i != sources_.size(); i++)
+    {
+      if (items[i + 1].revents & (ZMQ_POLLIN | ZMQ_POLLERR))
+      {
+        ready.push_back(sources_[i]);
+      }
+    }
+    
+    for (SourceList::iterator i = ready.begin(); i != ready.end() && !stopped_; ++i)
+    {
+      (*i).handler->on_readable();
+    }
+    
+    timers_.advance(Clock::now_ms());
+  }
+}
+
+void Reactor::stop()
+{
+  stopped_ = true;
+  
+  try {
+    zmq::socket_t* socket = ZeroMQContext::instance()->create_socket(ZMQ_PUSH);
+    socket->connect(wake_address().c_str());
+    zmq::message_t message;
+    socket->send(message, ZMQ_NOBLOCK);
+    delete socket;
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+  }
+}
@@ -0,0 +1,64 @@
+#ifndef REACTOR_H_
+#define REACTOR_H_
+
+  #include <string>
+  #include <vector>
+
+  #include "IReactorHandler.hpp"
+  #include "TimerWheel.h"
+
+  namespace zmq { class socket_t; };
+
+  /*
+   * Single network loop shared by the exit, discovery and timers.
+   *
+   * Everything registered here is serviced from the thread that calls run(),
+   * which must also be the thread that created the zmq sockets handed to
+   * add_socket(). stop() is the only call that is safe from other threads.
+   */
+  class Reactor
+  {
+    
+    struct Source
+    {
+      void* socket;
+      int fd;
+      IReactorHandler* handler;
+    };
+    
+    typedef std::vector<Source> SourceList;
+    
+  public:
+    
+    Reactor();
+    
+    ~Reactor();
+    
+    void add_socket(void* socket, IReactorHandler* handler);
+    
+    void add_fd(int fd, IReactorHandler* handler);
+    
+    void remove(IReactorHandler* handler);
+    
+    int add_timer(unsigned int interval_ms, ITimerHandler* handler, bool repeat = true);
+    
+    void cancel_timer(int timer_id);
+    
+    void run();
+    
+    void stop();
+    
+  private:
+    
+    std::string wake_address();
+    
+    SourceList sources_;
+    TimerWheel timers_;
+    
+    zmq::socket_t* wake_socket_;
+    
+    volatile bool stopped_;
+    
+  };
+
+#endif
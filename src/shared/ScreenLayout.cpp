@@ -0,0 +1,184 @@
+#include "ScreenLayout.h"
+
+#include <sstream>
+#include <iostream>
+
+static const char* EDGE_NAMES[EDGE_COUNT] = { "left", "right", "up", "down" };
+static const ScreenEdge OPPOSITE[EDGE_COUNT] = { EDGE_RIGHT, EDGE_LEFT, EDGE_DOWN, EDGE_UP };
+
+bool ScreenLayout::load(std::istream& input)
+{
+  std::string line;
+  
+  while (std::getline(input, line))
+  {
+    std::stringstream tokens(line);
+    std::string command;
+    tokens >> command;
+    
+    if (command.length() == 0 || command[0] == '#')
+    {
+      continue;
+    }
+    
+    if (command == "screen")
+    {
+      std::string name;
+      int width = 0;
+      int height = 0;
+      
+      if (!(tokens >> name >> width >> height) || width <= 0 || height <= 0)
+      {
+        std::cerr << "bad screen in layout: " << line << std::endl;
+        return false;
+      }
+      
+      add_screen(name, width, height);
+    }
+    else if (command == "link")
+    {
+      std::string from, edge_name, to;
+      int offset = 0;
+      
+      if (!(tokens >> from >> edge_name >> to))
+      {
+        std::cerr << "bad link in layout: " << line << std::endl;
+        return false;
+      }
+      
+      tokens >> offset;
+      
+      int edge = 0;
+      while (edge < EDGE_COUNT && edge_name != EDGE_NAMES[edge])
+      {
+        edge++;
+      }
+      
+      if (edge == EDGE_COUNT || !link(from, (ScreenEdge)edge, to, offset))
+      {
+        std::cerr << "bad link in layout: " << line << std::endl;
+        return false;
+      }
+    }
+  }
+  
+  return screens_.size() > 0;
+}
+
+int ScreenLayout::add_screen(const std::string& name, int width, int height)
+{
+  Screen screen;
+  screen.name = name;
+  screen.width = width;
+  screen.height = height;
+  
+  for (int edge = 0; edge < EDGE_COUNT; edge++)
+  {
+    screen.neighbours[edge] = -1;
+    screen.offsets[edge] = 0;
+  }
+  
+  screens_.push_back(screen);
+  return (int)screens_.size() - 1;
+}
+
+bool ScreenLayout::link(const std::string& from, ScreenEdge edge, const std::string& to, int offset)
+{
+  int from_index = find(from);
+  int to_index = find(to);
+  
+  if (from_index < 0 || to_index < 0 || from_index == to_index)
+  {
+    return false;
+  }
+  
+  screens_[from_index].neighbours[edge] = to_index;
+  screens_[from_index].offsets[edge] = offset;
+  
+  Screen& reverse = screens_[to_index];
+  if (reverse.neighbours[OPPOSITE[edge]] < 0)
+  {
+    reverse.neighbours[OPPOSITE[edge]] = from_index;
+    reverse.offsets[OPPOSITE[edge]] = -offset;
+  }
+  
+  return true;
+}
+
+int ScreenLayout::find(const std::string& name)
+{
+  for (ScreenList::size_type i = 0; i != screens_.size(); i++)
+  {
+    if (screens_[i].name == name)
+    {
+      return (int)i;
+    }
+  }
+  
+  return -1;
+}
+
+ScreenRouter::ScreenRouter(ScreenLayout* layout)
+  : layout_(layout)
+  , active_(0)
+  , x_(0)
+  , y_(0)
+{
+  
+}
+
+void ScreenRouter::enter(int screen, int x, int y)
+{
+  active_ = screen;
+  x_ = x;
+  y_ = y;
+}
+
+bool ScreenRouter::cross(ScreenEdge edge, int along)
+{
+  const Screen& from = layout_->screen(active_);
+  int index = from.neighbours[edge];
+  
+  if (index < 0)
+  {
+    return false;
+  }
+  
+  const Screen& to = layout_->screen(index);
+  int position = along - from.offsets[edge];
+  int extent = (edge == EDGE_LEFT || edge == EDGE_RIGHT) ? to.height : to.width;
+  
+  // the neighbour may only cover part of this edge
+  if (position < 0 || position >= extent)
+  {
+    return false;
+  }
+  
+  switch (edge)
+  {
+    case EDGE_LEFT:  enter(index, to.width - 1, position); break;
+    case EDGE_RIGHT: enter(index, 0, position); break;
+    case EDGE_UP:    enter(index, position, to.height - 1); break;
+    default:         enter(index, position, 0); break;
+  }
+  
+  return true;
+}
+
+bool ScreenRouter::move(int dx, int dy)
+{
+  const Screen& screen = layout_->screen(active_);
+  
+  x_ += dx;
+  y_ += dy;
+  
+  if (x_ < 0 && cross(EDGE_LEFT, y_)) return true;
+  if (x_ >= screen.width && cross(EDGE_RIGHT, y_)) return true;
+  if (y_ < 0 && cross(EDGE_UP, x_)) return true;
+  if (y_ >= screen.height && cross(EDGE_DOWN, x_)) return true;
+  
+  x_ = (x_ < 0) ? 0 : (x_ >= screen.width) ? screen.width - 1 : x_;
+  y_ = (y_ < 0) ? 0 : (y_ >= screen.height) ? screen.height - 1 : y_;
+  
+  return false;
+}
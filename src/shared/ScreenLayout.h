@@ -0,0 +1,96 @@
+#ifndef SCREENLAYOUT_H_
+#define SCREENLAYOUT_H_
+
+  #include <istream>
+  #include <string>
+  #include <vector>
+
+  enum ScreenEdge
+  {
+    EDGE_LEFT = 0,
+    EDGE_RIGHT = 1,
+    EDGE_UP = 2,
+    EDGE_DOWN = 3,
+    EDGE_COUNT = 4
+  };
+
+  struct Screen
+  {
+    std::string name;
+    int width;
+    int height;
+    int neighbours[EDGE_COUNT];
+    int offsets[EDGE_COUNT];
+  };
+
+  /*
+   * Which machine sits beside which. The first screen is the entrance itself.
+   *
+   * Layout files are line based:
+   *
+   *   screen <name> <width> <height>
+   *   link <name> <left|right|up|down> <name> [offset]
+   *
+   * The offset is where the neighbour's edge starts along ours, in our
+   * pixels, so screens of different sizes can be lined up. Links are made
+   * in both directions unless the reverse link is given explicitly.
+   */
+  class ScreenLayout
+  {
+    
+    typedef std::vector<Screen> ScreenList;
+    
+  public:
+    
+    bool load(std::istream& input);
+    
+    int add_screen(const std::string& name, int width, int height);
+    
+    bool link(const std::string& from, ScreenEdge edge, const std::string& to, int offset = 0);
+    
+    int find(const std::string& name);
+    
+    inline const Screen& screen(int index) { return screens_[index]; };
+    
+    inline int count() { return (int)screens_.size(); };
+    
+    inline int home() { return 0; };
+    
+  private:
+    
+    ScreenList screens_;
+    
+  };
+
+  /*
+   * Tracks a virtual cursor across the layout so the entrance can hand off
+   * to the neighbouring exit the moment the pointer crosses an edge.
+   */
+  class ScreenRouter
+  {
+    
+  public:
+    
+    ScreenRouter(ScreenLayout* layout);
+    
+    void enter(int screen, int x, int y);
+    
+    bool move(int dx, int dy);
+    
+    inline int active() { return active_; };
+    inline int x() { return x_; };
+    inline int y() { return y_; };
+    
+  private:
+    
+    bool cross(ScreenEdge edge, int along);
+    
+    ScreenLayout* layout_;
+    
+    int active_;
+    int x_;
+    int y_;
+    
+  };
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef SCROLL_ACCUMULATOR_H_
+#define SCROLL_ACCUMULATOR_H_
+
+  /*
+   * SCROLL_WHEEL carries pixel deltas in 24.8 fixed point, horizontal in x
+   * and vertical in y, positive meaning up and left as on OS X. A line is
+   * SCROLL_PIXELS_PER_LINE pixels, so notched wheels and trackpads share one
+   * unit on the wire.
+   */
+  static const int SCROLL_FIXED_SHIFT = 8;
+  static const int SCROLL_FIXED_ONE = 1 << SCROLL_FIXED_SHIFT;
+  static const int SCROLL_PIXELS_PER_LINE = 10;
+
+  /*
+   * Turns a stream of fixed point deltas into whole output steps of
+   * step_size fixed point units each, carrying the remainder forward so
+   * slow trackpad motion still adds up instead of rounding away to zero.
+   */
+  class ScrollAccumulator
+  {
+
+  public:
+
+    ScrollAccumulator(int step_size)
+      : step_size_(step_size)
+      , remainder_(0)
+    { };
+
+    int add(int delta)
+    {
+      // a reversal throws away travel owed in the old direction
+      if ((delta > 0 && remainder_ < 0) || (delta < 0 && remainder_ > 0))
+      {
+        remainder_ = 0;
+      }
+
+      remainder_ += delta;
+      int steps = remainder_ / step_size_;
+      remainder_ -= steps * step_size_;
+      return steps;
+    }
+
+    void reset() { remainder_ = 0; };
+
+  private:
+
+    int step_size_;
+    int remainder_;
+
+  };
+
+#endif
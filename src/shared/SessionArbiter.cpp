@@ -0,0 +1,278 @@
+#include "SessionArbiter.h"
+
+#include <cstring>
+
+#include "Constants.hpp"
+
+static const unsigned int LEFT_BUTTON = 1;
+static const unsigned int RIGHT_BUTTON = 2;
+
+SessionArbiter::SessionArbiter(ArbitrationPolicy policy, unsigned int lock_timeout_ms)
+  : policy_(policy)
+  , lock_timeout_(lock_timeout_ms)
+  , owned_(false)
+  , owner_(0)
+  , sequence_(0)
+{
+  
+}
+
+void SessionArbiter::push(const Message& message, unsigned long long now_ms)
+{
+  Session& session = sessions_[message.session];
+  
+  // a controller that floods faster than it is served loses its oldest input
+  if (session.queue.size() >= SESSION_QUEUE_LIMIT)
+  {
+    session.queue.pop_front();
+  }
+  
+  Pending pending;
+  pending.message = message;
+  pending.arrived = now_ms;
+  pending.sequence = sequence_++;
+  session.queue.push_back(pending);
+  session.last_active = now_ms;
+  session.last_sequence = pending.sequence;
+}
+
+bool SessionArbiter::earliest(unsigned int& session)
+{
+  bool found = false;
+  unsigned long long sequence = 0;
+  
+  for (SessionList::iterator i = sessions_.begin(); i != sessions_.end(); ++i)
+  {
+    if (!(*i).second.queue.empty() && (!found || (*i).second.queue.front().sequence < sequence))
+    {
+      found = true;
+      session = (*i).first;
+      sequence = (*i).second.queue.front().sequence;
+    }
+  }
+  
+  return found;
+}
+
+bool SessionArbiter::latest(unsigned int& session)
+{
+  bool found = false;
+  unsigned long long sequence = 0;
+  
+  for (SessionList::iterator i = sessions_.begin(); i != sessions_.end(); ++i)
+  {
+    if (!(*i).second.queue.empty() && (!found || (*i).second.last_sequence > sequence))
+    {
+      found = true;
+      session = (*i).first;
+      sequence = (*i).second.last_sequence;
+    }
+  }
+  
+  return found;
+}
+
+void SessionArbiter::expire(unsigned long long now_ms)
+{
+  SessionList::iterator i = sessions_.begin();
+  
+  while (i != sessions_.end())
+  {
+    // held keys of a session are released when it loses control, so one
+    // that is neither in control nor queued has nothing left to remember
+    bool owner = owned_ && (*i).first == owner_;
+    
+    if (!owner && (*i).second.queue.empty() && now_ms - (*i).second.last_active >= SESSION_EXPIRY)
+    {
+      sessions_.erase(i++);
+    }
+    else
+    {
+      ++i;
+    }
+  }
+}
+
+size_t SessionArbiter::backlog()
+{
+  size_t count = 0;
+  
+  for (SessionList::iterator i = sessions_.begin(); i != sessions_.end(); ++i)
+  {
+    count += (*i).second.queue.size();
+  }
+  
+  return count;
+}
+
+bool SessionArbiter::waiting()
+{
+  for (SessionList::iterator i = sessions_.begin(); i != sessions_.end(); ++i)
+  {
+    if ((!owned_ || (*i).first != owner_) && !(*i).second.queue.empty())
+    {
+      return true;
+    }
+  }
+  
+  return false;
+}
+
+void SessionArbiter::release(Session& session)
+{
+  for (std::set<int>::iterator i = session.keys.begin(); i != session.keys.end(); ++i)
+  {
+    Message message;
+    memset(&message, 0, sizeof(message));
+    message.type = KEY_UP;
+    message.key_code = *i;
+    releases_.push_back(message);
+  }
+  session.keys.clear();
+  
+  if (session.buttons & LEFT_BUTTON)
+  {
+    Message message;
+    memset(&message, 0, sizeof(message));
+    message.type = LEFT_UP;
+    releases_.push_back(message);
+  }
+  
+  if (session.buttons & RIGHT_BUTTON)
+  {
+    Message message;
+    memset(&message, 0, sizeof(message));
+    message.type = RIGHT_UP;
+    releases_.push_back(message);
+  }
+  session.buttons = 0;
+  
+  if (session.flags != 0)
+  {
+    Message message;
+    memset(&message, 0, sizeof(message));
+    message.type = FLAGS_CHANGED;
+    message.key_code = session.flags_key;
+    releases_.push_back(message);
+    session.flags = 0;
+  }
+}
+
+void SessionArbiter::hand_over(unsigned int session, unsigned long long now_ms)
+{
+  if (owned_ && sessions_.find(owner_) != sessions_.end())
+  {
+    release(sessions_[owner_]);
+  }
+  
+  owned_ = true;
+  owner_ = session;
+  
+  if (policy_ == ARBITRATION_EXCLUSIVE)
+  {
+    // whatever queued up while someone else held the lock is stale by now
+    std::deque<Pending>& queue = sessions_[session].queue;
+    while (queue.size() > 1 && now_ms - queue.front().arrived > lock_timeout_)
+    {
+      queue.pop_front();
+    }
+  }
+}
+
+void SessionArbiter::track(Session& session, const Message& message)
+{
+  switch (message.type)
+  {
+    case KEY_DOWN:      session.keys.insert(message.key_code); break;
+    case KEY_UP:        session.keys.erase(message.key_code); break;
+    case LEFT_DOWN:     session.buttons |= LEFT_BUTTON; break;
+    case LEFT_UP:       session.buttons &= ~LEFT_BUTTON; break;
+    case RIGHT_DOWN:    session.buttons |= RIGHT_BUTTON; break;
+    case RIGHT_UP:      session.buttons &= ~RIGHT_BUTTON; break;
+    case FLAGS_CHANGED: session.flags = message.flags; session.flags_key = message.key_code; break;
+  }
+}
+
+bool SessionArbiter::pop(Message& message, unsigned long long now_ms)
+{
+  if (!releases_.empty())
+  {
+    message = releases_.front();
+    releases_.pop_front();
+    return true;
+  }
+  
+  expire(now_ms);
+  
+  unsigned int next = 0;
+  bool found = false;
+  
+  if (policy_ == ARBITRATION_LAST_ACTIVE)
+  {
+    found = latest(next);
+    
+    // everyone else's input is older than the latest sender's, so it is
+    // superseded rather than played after it
+    for (SessionList::iterator i = sessions_.begin(); found && i != sessions_.end(); ++i)
+    {
+      if ((*i).first != next)
+      {
+        (*i).second.queue.clear();
+      }
+    }
+  }
+  else
+  {
+    SessionList::iterator owner = owned_ ? sessions_.find(owner_) : sessions_.end();
+    
+    if (owner != sessions_.end() && !(*owner).second.queue.empty())
+    {
+      next = owner_;
+      found = true;
+    }
+    else if (owner == sessions_.end() || now_ms - (*owner).second.last_active >= lock_timeout_)
+    {
+      found = earliest(next);
+    }
+  }
+  
+  if (!found)
+  {
+    return false;
+  }
+  
+  if (!owned_ || next != owner_)
+  {
+    hand_over(next, now_ms);
+    
+    if (!releases_.empty())
+    {
+      return pop(message, now_ms);
+    }
+  }
+  
+  Session& session = sessions_[next];
+  message = session.queue.front().message;
+  session.queue.pop_front();
+  track(session, message);
+  
+  return true;
+}
+
+long SessionArbiter::next_timeout(unsigned long long now_ms)
+{
+  if (policy_ != ARBITRATION_EXCLUSIVE || !waiting())
+  {
+    return -1;
+  }
+  
+  SessionList::iterator owner = owned_ ? sessions_.find(owner_) : sessions_.end();
+  
+  if (owner == sessions_.end())
+  {
+    return 0;
+  }
+  
+  unsigned long long expiry = (*owner).second.last_active + lock_timeout_;
+  return (expiry <= now_ms) ? 0 : (long)(expiry - now_ms);
+}
@@ -0,0 +1,100 @@
+#ifndef SESSIONARBITER_H_
+#define SESSIONARBITER_H_
+
+  #include <cstddef>
+  #include <deque>
+  #include <map>
+  #include <set>
+
+  #include "Message.h"
+
+  enum ArbitrationPolicy
+  {
+    ARBITRATION_EXCLUSIVE = 0,
+    ARBITRATION_LAST_ACTIVE = 1
+  };
+
+  /*
+   * Decides which controller gets to drive the exit when several are
+   * connected. Every session keeps its own queue and its own record of held
+   * keys and buttons, so handing control over releases whatever the previous
+   * controller was holding instead of leaving it stuck down.
+   *
+   * EXCLUSIVE keeps control with one session until it has been quiet for the
+   * lock timeout; the others queue behind it. LAST_ACTIVE hands control to
+   * whichever session sent the most recent event, and whatever the others
+   * still had queued is dropped as superseded.
+   *
+   * Senders that don't stamp a session share session 0. Sessions that stay
+   * quiet for SESSION_EXPIRY are forgotten.
+   */
+  class SessionArbiter
+  {
+    
+    struct Pending
+    {
+      Message message;
+      unsigned long long arrived;
+      unsigned long long sequence;
+    };
+    
+    struct Session
+    {
+      std::deque<Pending> queue;
+      std::set<int> keys;
+      unsigned int buttons;
+      unsigned int flags;
+      int flags_key;
+      unsigned long long last_active;
+      unsigned long long last_sequence;
+      
+      Session() : buttons(0), flags(0), flags_key(0), last_active(0), last_sequence(0) {};
+    };
+    
+    typedef std::map<unsigned int, Session> SessionList;
+    
+  public:
+    
+    SessionArbiter(ArbitrationPolicy policy, unsigned int lock_timeout_ms);
+    
+    void push(const Message& message, unsigned long long now_ms);
+    
+    bool pop(Message& message, unsigned long long now_ms);
+    
+    long next_timeout(unsigned long long now_ms);
+    
+    // messages queued across every session, waiting for control or a pop
+    size_t backlog();
+    
+    inline bool owned() { return owned_; };
+    
+    inline unsigned int owner() { return owner_; };
+    
+  private:
+    
+    void hand_over(unsigned int session, unsigned long long now_ms);
+    
+    void release(Session& session);
+    
+    void track(Session& session, const Message& message);
+    
+    bool waiting();
+    
+    bool earliest(unsigned int& session);
+    
+    bool latest(unsigned int& session);
+    
+    void expire(unsigned long long now_ms);
+    
+    SessionList sessions_;
+    std::deque<Message> releases_;
+    
+    ArbitrationPolicy policy_;
+    unsigned int lock_timeout_;
+    bool owned_;
+    unsigned int owner_;
+    unsigned long long sequence_;
+    
+  };
+
+#endif
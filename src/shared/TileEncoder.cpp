@@ -0,0 +1,290 @@
+#include "TileEncoder.h"
+
+#include <cstring>
+
+static const unsigned int HASH_LANES = 8;
+static const unsigned int HASH_PRIME = 16777619u;
+
+static unsigned short to_rgb565(unsigned int red, unsigned int green, unsigned int blue)
+{
+  return (unsigned short)(((red >> 3) << 11) | ((green >> 2) << 5) | (blue >> 3));
+}
+
+TileEncoder::TileEncoder()
+  : width_(0)
+  , height_(0)
+  , frame_(0)
+  , refresh_(0)
+{
+  
+}
+
+void TileEncoder::reset()
+{
+  width_ = 0;
+  height_ = 0;
+  hashes_.clear();
+}
+
+unsigned int TileEncoder::hash_tile(const Frame& frame, int x, int y, int width, int height)
+{
+  // independent lanes over whole pixels so the inner loop vectorises
+  unsigned int lanes[HASH_LANES];
+  for (unsigned int k = 0; k < HASH_LANES; k++)
+  {
+    lanes[k] = 2166136261u + k;
+  }
+  
+  for (int row = 0; row < height; row++)
+  {
+    const unsigned char* pixels = frame.pixels + (y + row) * frame.stride + x * 4;
+    int i = 0;
+    
+    for (; i + (int)HASH_LANES <= width; i += HASH_LANES)
+    {
+      unsigned int values[HASH_LANES];
+      memcpy(values, pixels + i * 4, sizeof(values));
+      
+      for (unsigned int k = 0; k < HASH_LANES; k++)
+      {
+        lanes[k] = (lanes[k] ^ values[k]) * HASH_PRIME;
+      }
+    }
+    
+    for (; i < width; i++)
+    {
+      unsigned int value;
+      memcpy(&value, pixels + i * 4, sizeof(value));
+      lanes[i % HASH_LANES] = (lanes[i % HASH_LANES] ^ value) * HASH_PRIME;
+    }
+  }
+  
+  unsigned int hash = 2166136261u;
+  for (unsigned int k = 0; k < HASH_LANES; k++)
+  {
+    hash = (hash ^ lanes[k]) * HASH_PRIME;
+  }
+  return hash;
+}
+
+unsigned int TileEncoder::encode(const Frame& frame, std::string& message)
+{
+  int tiles_x = (frame.width + PREVIEW_TILE_SIZE - 1) / PREVIEW_TILE_SIZE;
+  int tiles_y = (frame.height + PREVIEW_TILE_SIZE - 1) / PREVIEW_TILE_SIZE;
+  bool resized = (frame.width != width_ || frame.height != height_);
+  
+  if (resized)
+  {
+    width_ = frame.width;
+    height_ = frame.height;
+    hashes_.assign(tiles_x * tiles_y, 0);
+    refresh_ = 0;
+  }
+  
+  message.resize(sizeof(PreviewHeader));
+  unsigned int window = (unsigned int)(hashes_.size() + PREVIEW_REFRESH_FRAMES - 1) / PREVIEW_REFRESH_FRAMES;
+  unsigned int count = 0;
+  unsigned int refreshed = 0;
+  
+  for (int tile_y = 0; tile_y < tiles_y; tile_y++)
+  {
+    for (int tile_x = 0; tile_x < tiles_x; tile_x++)
+    {
+      int x = tile_x * PREVIEW_TILE_SIZE;
+      int y = tile_y * PREVIEW_TILE_SIZE;
+      int width = (frame.width - x < (int)PREVIEW_TILE_SIZE) ? frame.width - x : PREVIEW_TILE_SIZE;
+      int height = (frame.height - y < (int)PREVIEW_TILE_SIZE) ? frame.height - y : PREVIEW_TILE_SIZE;
+      
+      unsigned int index = tile_y * tiles_x + tile_x;
+      unsigned int hash = hash_tile(frame, x, y, width, height);
+      
+      // tiles in the rotating refresh window go out whether dirty or not
+      unsigned int distance = (index + hashes_.size() - refresh_) % hashes_.size();
+      bool refresh = distance < window;
+      
+      if (!resized && hash == hashes_[index] && !refresh)
+      {
+        continue;
+      }
+      
+      hashes_[index] = hash;
+      encode_tile(frame, tile_x, tile_y, message);
+      count++;
+      refreshed += refresh ? 1 : 0;
+    }
+  }
+  
+  // a 0x0 frame has no tiles to rotate through
+  if (!hashes_.empty())
+  {
+    refresh_ = (refresh_ + window) % hashes_.size();
+  }
+  
+  PreviewHeader header;
+  header.frame = frame_++;
+  header.width = (unsigned short)frame.width;
+  header.height = (unsigned short)frame.height;
+  header.scale = PREVIEW_SCALE;
+  header.tile_count = (unsigned short)count;
+  memcpy(&message[0], &header, sizeof(header));
+  
+  return count - refreshed;
+}
+
+void TileEncoder::encode_tile(const Frame& frame, int tile_x, int tile_y, std::string& message)
+{
+  int x = tile_x * PREVIEW_TILE_SIZE;
+  int y = tile_y * PREVIEW_TILE_SIZE;
+  int width = (frame.width - x < (int)PREVIEW_TILE_SIZE) ? frame.width - x : PREVIEW_TILE_SIZE;
+  int height = (frame.height - y < (int)PREVIEW_TILE_SIZE) ? frame.height - y : PREVIEW_TILE_SIZE;
+  
+  PreviewTile tile;
+  tile.x = (unsigned short)tile_x;
+  tile.y = (unsigned short)tile_y;
+  tile.width = (unsigned short)((width + PREVIEW_SCALE - 1) / PREVIEW_SCALE);
+  tile.height = (unsigned short)((height + PREVIEW_SCALE - 1) / PREVIEW_SCALE);
+  tile.size = 0;
+  
+  std::string::size_type header = message.size();
+  message.append((const char*)&tile, sizeof(tile));
+  
+  unsigned short run_pixel = 0;
+  unsigned int run_length = 0;
+  
+  for (int scaled_y = 0; scaled_y < tile.height; scaled_y++)
+  {
+    for (int scaled_x = 0; scaled_x < tile.width; scaled_x++)
+    {
+      // box filter over the block, clipped at the edge of the screen
+      unsigned int blue = 0, green = 0, red = 0, samples = 0;
+      
+      for (int dy = 0; dy < (int)PREVIEW_SCALE && scaled_y * (int)PREVIEW_SCALE + dy < height; dy++)
+      {
+        const unsigned char* pixels = frame.pixels + (y + scaled_y * PREVIEW_SCALE + dy) * frame.stride + (x + scaled_x * PREVIEW_SCALE) * 4;
+        
+        for (int dx = 0; dx < (int)PREVIEW_SCALE && scaled_x * (int)PREVIEW_SCALE + dx < width; dx++)
+        {
+          blue += pixels[dx * 4];
+          green += pixels[dx * 4 + 1];
+          red += pixels[dx * 4 + 2];
+          samples++;
+        }
+      }
+      
+      unsigned short pixel = to_rgb565(red / samples, green / samples, blue / samples);
+      
+      if (run_length > 0 && (pixel != run_pixel || run_length == 255))
+      {
+        message.push_back((char)run_length);
+        message.push_back((char)(run_pixel & 0xff));
+        message.push_back((char)(run_pixel >> 8));
+        run_length = 0;
+      }
+      
+      run_pixel = pixel;
+      run_length++;
+    }
+  }
+  
+  message.push_back((char)run_length);
+  message.push_back((char)(run_pixel & 0xff));
+  message.push_back((char)(run_pixel >> 8));
+  
+  tile.size = (unsigned int)(message.size() - header - sizeof(tile));
+  memcpy(&message[header], &tile, sizeof(tile));
+}
+
+TileDecoder::TileDecoder()
+  : width_(0)
+  , height_(0)
+{
+  
+}
+
+bool TileDecoder::decode(const char* data, size_t size)
+{
+  if (size < sizeof(PreviewHeader))
+  {
+    return false;
+  }
+  
+  PreviewHeader header;
+  memcpy(&header, data, sizeof(header));
+  
+  if (header.scale == 0 || PREVIEW_TILE_SIZE % header.scale != 0)
+  {
+    return false;
+  }
+  
+  int width = (header.width + header.scale - 1) / header.scale;
+  int height = (header.height + header.scale - 1) / header.scale;
+  
+  if (width != width_ || height != height_)
+  {
+    width_ = width;
+    height_ = height;
+    pixels_.assign(width * height * 4, 0);
+  }
+  
+  size_t offset = sizeof(header);
+  
+  for (unsigned int i = 0; i < header.tile_count; i++)
+  {
+    if (size - offset < sizeof(PreviewTile))
+    {
+      return false;
+    }
+    
+    PreviewTile tile;
+    memcpy(&tile, data + offset, sizeof(tile));
+    offset += sizeof(tile);
+    
+    if (size - offset < tile.size || tile.size % 3 != 0)
+    {
+      return false;
+    }
+    
+    if (!decode_tile(tile, header.scale, (const unsigned char*)data + offset))
+    {
+      return false;
+    }
+    offset += tile.size;
+  }
+  
+  return true;
+}
+
+bool TileDecoder::decode_tile(const PreviewTile& tile, int scale, const unsigned char* data)
+{
+  int left = tile.x * (PREVIEW_TILE_SIZE / scale);
+  int top = tile.y * (PREVIEW_TILE_SIZE / scale);
+  
+  if (left + tile.width > width_ || top + tile.height > height_)
+  {
+    return false;
+  }
+  
+  int pixel = 0;
+  int total = tile.width * tile.height;
+  
+  for (unsigned int i = 0; i < tile.size && pixel < total; i += 3)
+  {
+    unsigned int run = data[i];
+    unsigned int value = data[i + 1] | (data[i + 2] << 8);
+    
+    unsigned char red = (unsigned char)(((value >> 11) & 0x1f) << 3);
+    unsigned char green = (unsigned char)(((value >> 5) & 0x3f) << 2);
+    unsigned char blue = (unsigned char)((value & 0x1f) << 3);
+    
+    for (unsigned int j = 0; j < run && pixel < total; j++, pixel++)
+    {
+      unsigned char* target = &pixels_[((top + pixel / tile.width) * width_ + left + pixel % tile.width) * 4];
+      target[0] = red;
+      target[1] = green;
+      target[2] = blue;
+      target[3] = 255;
+    }
+  }
+  
+  return pixel == total;
+}
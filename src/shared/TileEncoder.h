@@ -0,0 +1,80 @@
+#ifndef TILEENCODER_H_
+#define TILEENCODER_H_
+
+  #include <string>
+  #include <vector>
+
+  #include "PreviewProtocol.h"
+
+  /*
+   * A captured screen: 32 bit BGRA pixels, rows stride bytes apart.
+   */
+  struct Frame
+  {
+    int width;
+    int height;
+    int stride;
+    const unsigned char* pixels;
+  };
+
+  /*
+   * Turns successive frames into preview messages holding only the tiles
+   * whose hash changed since the previous frame, plus a few unchanged ones in
+   * rotation so a receiver that missed a message catches up.
+   */
+  class TileEncoder
+  {
+    
+  public:
+    
+    TileEncoder();
+    
+    // returns how many tiles actually changed, refreshed ones not counted
+    unsigned int encode(const Frame& frame, std::string& message);
+    
+    // forget the previous frame, so the next one goes out whole
+    void reset();
+    
+    static unsigned int hash_tile(const Frame& frame, int x, int y, int width, int height);
+    
+  private:
+    
+    void encode_tile(const Frame& frame, int tile_x, int tile_y, std::string& message);
+    
+    std::vector<unsigned int> hashes_;
+    int width_;
+    int height_;
+    unsigned int frame_;
+    unsigned int refresh_;
+    
+  };
+
+  /*
+   * Receiving side: applies preview messages to a scaled down RGBA canvas.
+   */
+  class TileDecoder
+  {
+    
+  public:
+    
+    TileDecoder();
+    
+    bool decode(const char* data, size_t size);
+    
+    inline int width() { return width_; };
+    
+    inline int height() { return height_; };
+    
+    inline const unsigned char* pixels() { return pixels_.empty() ? 0 : &pixels_[0]; };
+    
+  private:
+    
+    bool decode_tile(const PreviewTile& tile, int scale, const unsigned char* data);
+    
+    std::vector<unsigned char> pixels_;
+    int width_;
+    int height_;
+    
+  };
+
+#endif
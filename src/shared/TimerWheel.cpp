@@ -0,0 +1,233 @@
+#include "TimerWheel.h"
+
+static const int NONE = -1;
+static const int INDEX_BITS = 16;
+static const int INDEX_MASK = (1 << INDEX_BITS) - 1;
+
+TimerWheel::TimerWheel(unsigned long long now_ms, unsigned int tick_ms, unsigned int slots)
+  : slots_(slots, NONE)
+  , current_(now_ms / tick_ms)
+  , tick_(tick_ms)
+  , active_(0)
+{
+  
+}
+
+void TimerWheel::link(int index)
+{
+  Entry& entry = entries_[index];
+  entry.slot = (int)((entry.deadline / tick_) % slots_.size());
+  entry.prev = NONE;
+  entry.next = slots_[entry.slot];
+  
+  if (entry.next != NONE)
+  {
+    entries_[entry.next].prev = index;
+  }
+  
+  slots_[entry.slot] = index;
+}
+
+void TimerWheel::unlink(int index)
+{
+  Entry& entry = entries_[index];
+  
+  if (entry.prev != NONE)
+  {
+    entries_[entry.prev].next = entry.next;
+  }
+  else
+  {
+    slots_[entry.slot] = entry.next;
+  }
+  
+  if (entry.next != NONE)
+  {
+    entries_[entry.next].prev = entry.prev;
+  }
+  
+  // advance() unlinks due timers before running handlers, which may still
+  // cancel them; this keeps cancel from unlinking them a second time
+  entry.slot = NONE;
+}
+
+int TimerWheel::schedule(unsigned long long now_ms, unsigned int delay_ms, ITimerHandler* handler, bool repeat)
+{
+  int index = 0;
+  
+  if (!free_.empty())
+  {
+    index = free_.back();
+    free_.pop_back();
+  }
+  else
+  {
+    if (entries_.size() >= INDEX_MASK)
+    {
+      return 0;
+    }
+    
+    Entry entry;
+    entry.generation = 0;
+    entries_.push_back(entry);
+    index = (int)entries_.size() - 1;
+  }
+  
+  unsigned int interval = (delay_ms < tick_) ? tick_ : delay_ms;
+  
+  Entry& entry = entries_[index];
+  entry.generation = (entry.generation + 1) & 0x7fff;
+  entry.deadline = (now_ms + interval) / tick_ * tick_;
+  entry.interval = interval;
+  entry.repeat = repeat;
+  entry.active = true;
+  entry.handler = handler;
+  
+  // never let a timer land in a slot that has already been swept
+  if (entry.deadline / tick_ <= current_)
+  {
+    entry.deadline = (current_ + 1) * tick_;
+  }
+  
+  link(index);
+  active_++;
+  
+  return (entry.generation << INDEX_BITS) | (index + 1);
+}
+
+void TimerWheel::cancel(int timer_id)
+{
+  int index = (timer_id & INDEX_MASK) - 1;
+  
+  if (index < 0 || index >= (int)entries_.size())
+  {
+    return;
+  }
+  
+  Entry& entry = entries_[index];
+  
+  if (!entry.active || entry.generation != (timer_id >> INDEX_BITS))
+  {
+    return;
+  }
+  
+  if (entry.slot != NONE)
+  {
+    unlink(index);
+  }
+  
+  entry.active = false;
+  free_.push_back(index);
+  active_--;
+}
+
+void TimerWheel::advance(unsigned long long now_ms)
+{
+  unsigned long long target = now_ms / tick_;
+  
+  if (target <= current_)
+  {
+    return;
+  }
+  
+  unsigned long long steps = target - current_;
+  if (steps > slots_.size())
+  {
+    steps = slots_.size();
+  }
+  
+  std::vector<int> due;
+  
+  for (unsigned long long step = 1; step <= steps; step++)
+  {
+    int slot = (int)((current_ + step) % slots_.size());
+    
+    for (int index = slots_[slot]; index != NONE; index = entries_[index].next)
+    {
+      if (entries_[index].deadline / tick_ <= target)
+      {
+        due.push_back((entries_[index].generation << INDEX_BITS) | (index + 1));
+      }
+    }
+  }
+  
+  current_ = target;
+  
+  for (std::vector<int>::iterator i = due.begin(); i != due.end(); ++i)
+  {
+    unlink((*i & INDEX_MASK) - 1);
+  }
+  
+  for (std::vector<int>::iterator i = due.begin(); i != due.end(); ++i)
+  {
+    int timer_id = *i;
+    int index = (timer_id & INDEX_MASK) - 1;
+    Entry& entry = entries_[index];
+    
+    // an earlier handler in this batch may have cancelled it, and maybe
+    // scheduled a new timer in the same entry
+    if (!entry.active || entry.generation != (timer_id >> INDEX_BITS))
+    {
+      continue;
+    }
+    
+    ITimerHandler* handler = entry.handler;
+    
+    if (entry.repeat)
+    {
+      entry.deadline = (current_ * tick_) + entry.interval;
+      link(index);
+    }
+    else
+    {
+      entry.active = false;
+      free_.push_back(index);
+      active_--;
+    }
+    
+    handler->on_timer(timer_id);
+  }
+}
+
+long TimerWheel::next_timeout(unsigned long long now_ms)
+{
+  if (active_ == 0)
+  {
+    return -1;
+  }
+  
+  unsigned long long earliest = 0;
+  
+  for (unsigned int step = 1; step <= slots_.size(); step++)
+  {
+    int slot = (int)((current_ + step) % slots_.size());
+    
+    for (int index = slots_[slot]; index != NONE; index = entries_[index].next)
+    {
+      if (entries_[index].deadline / tick_ == current_ + step)
+      {
+        earliest = entries_[index].deadline;
+        break;
+      }
+    }
+    
+    if (earliest != 0)
+    {
+      break;
+    }
+  }
+  
+  // nothing due within one revolution, find the nearest far-off timer
+  if (earliest == 0)
+  {
+    for (std::vector<Entry>::iterator i = entries_.begin(); i != entries_.end(); ++i)
+    {
+      if ((*i).active && (earliest == 0 || (*i).deadline < earliest))
+      {
+        earliest = (*i).deadline;
+      }
+    }
+  }
+  
+  return (earliest <= now_ms) ? 0 : (long)(earliest - now_ms);
+}
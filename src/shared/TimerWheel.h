@@ -0,0 +1,63 @@
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+  #include <vector>
+
+  #include "IReactorHandler.hpp"
+
+  /*
+   * Hashed timer wheel. Timers hash into one of a fixed ring of slots by
+   * their expiry tick, so schedule and cancel are O(1) and advance() only
+   * visits the slots that elapsed since the last call. Timers further out
+   * than one revolution simply stay in their slot until their tick comes up.
+   *
+   * The wheel does not read the clock itself; the owner passes Clock::now_ms()
+   * in, which keeps it single-threaded and easy to drive from any loop.
+   */
+  class TimerWheel
+  {
+    
+    struct Entry
+    {
+      unsigned long long deadline;
+      unsigned int interval;
+      bool repeat;
+      bool active;
+      int generation;
+      ITimerHandler* handler;
+      int slot;
+      int prev;
+      int next;
+    };
+    
+  public:
+    
+    TimerWheel(unsigned long long now_ms, unsigned int tick_ms = 1, unsigned int slots = 512);
+    
+    int schedule(unsigned long long now_ms, unsigned int delay_ms, ITimerHandler* handler, bool repeat = false);
+    
+    void cancel(int timer_id);
+    
+    void advance(unsigned long long now_ms);
+    
+    long next_timeout(unsigned long long now_ms);
+    
+    inline bool empty() { return active_ == 0; };
+    
+  private:
+    
+    void link(int index);
+    
+    void unlink(int index);
+    
+    std::vector<Entry> entries_;
+    std::vector<int> slots_;
+    std::vector<int> free_;
+    
+    unsigned long long current_;
+    unsigned int tick_;
+    unsigned int active_;
+    
+  };
+
+#endif
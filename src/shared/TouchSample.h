@@ -0,0 +1,26 @@
+#ifndef TOUCHSAMPLE_H_
+#define TOUCHSAMPLE_H_
+
+  #include <vector>
+
+  /*
+   * One finger movement as reported by the touch screen, a delta in points
+   * and the time it was seen in seconds.
+   */
+  struct TouchSample
+  {
+    float x;
+    float y;
+    double timestamp;
+  };
+
+  typedef std::vector<TouchSample> TouchSampleList;
+
+  /*
+   * A TOUCH_MOVE carries every sample of one display frame summed into a
+   * 24.8 fixed point delta in x and y, the time the samples span in
+   * microseconds in key_code and the sample count in flags.
+   */
+  static const int TOUCH_FIXED_ONE = 256;
+
+#endif
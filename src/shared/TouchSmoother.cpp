@@ -0,0 +1,97 @@
+#include "TouchSmoother.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "Constants.hpp"
+
+static const double TOUCH_GAIN_MIN = 1.0;
+static const double TOUCH_GAIN_MAX = 3.0;
+static const double TOUCH_GAIN_VELOCITY = 1.5;
+
+double TouchSmoother::gain(double points_per_ms)
+{
+  // slow movement stays precise, a flick ramps up to the full gain
+  double ramp = points_per_ms / TOUCH_GAIN_VELOCITY;
+  ramp = (ramp > 1.0) ? 1.0 : ramp;
+  return TOUCH_GAIN_MIN + (TOUCH_GAIN_MAX - TOUCH_GAIN_MIN) * ramp;
+}
+
+void TouchSmoother::push(const Message& message, unsigned long long now_ms)
+{
+  Stroke& stroke = strokes_[message.session];
+  
+  double span_ms = message.key_code / 1000.0;
+  span_ms = (span_ms < 1.0) ? 1.0 : span_ms;
+  
+  double x = (double)message.x / TOUCH_FIXED_ONE;
+  double y = (double)message.y / TOUCH_FIXED_ONE;
+  double scale = gain(sqrt(x * x + y * y) / span_ms);
+  
+  // whatever the last frame had not played yet is folded into this one
+  stroke.remaining_x += (int)(message.x * scale);
+  stroke.remaining_y += (int)(message.y * scale);
+  stroke.steps = TOUCH_INTERPOLATION_STEPS;
+  stroke.due = now_ms;
+}
+
+void TouchSmoother::due(unsigned long long now_ms, MessageList& ready)
+{
+  for (StrokeList::iterator i = strokes_.begin(); i != strokes_.end(); ++i)
+  {
+    Stroke& stroke = i->second;
+    
+    while (stroke.steps > 0 && stroke.due <= now_ms)
+    {
+      int step_x = stroke.remaining_x / (int)stroke.steps;
+      int step_y = stroke.remaining_y / (int)stroke.steps;
+      stroke.remaining_x -= step_x;
+      stroke.remaining_y -= step_y;
+      stroke.steps--;
+      stroke.due += TOUCH_FRAME_INTERVAL / TOUCH_INTERPOLATION_STEPS;
+      
+      // sub-pixel leftovers carry into the next step rather than being lost
+      stroke.carry_x += step_x;
+      stroke.carry_y += step_y;
+      int x = stroke.carry_x / TOUCH_FIXED_ONE;
+      int y = stroke.carry_y / TOUCH_FIXED_ONE;
+      stroke.carry_x -= x * TOUCH_FIXED_ONE;
+      stroke.carry_y -= y * TOUCH_FIXED_ONE;
+      
+      if (x == 0 && y == 0)
+      {
+        continue;
+      }
+      
+      Message message;
+      memset(&message, 0, sizeof(message));
+      message.type = MOUSE_MOVE;
+      message.x = x;
+      message.y = y;
+      message.session = i->first;
+      ready.push_back(message);
+    }
+  }
+}
+
+long TouchSmoother::next_timeout(unsigned long long now_ms)
+{
+  long timeout = -1;
+  
+  for (StrokeList::iterator i = strokes_.begin(); i != strokes_.end(); ++i)
+  {
+    if (i->second.steps == 0)
+    {
+      continue;
+    }
+    
+    long remaining = (i->second.due > now_ms) ? (long)(i->second.due - now_ms) : 0;
+    
+    if (timeout < 0 || remaining < timeout)
+    {
+      timeout = remaining;
+    }
+  }
+  
+  return timeout;
+}
@@ -0,0 +1,50 @@
+#ifndef TOUCHSMOOTHER_H_
+#define TOUCHSMOOTHER_H_
+
+  #include <map>
+  #include <vector>
+
+  #include "Message.h"
+  #include "LaneMerger.h"
+  #include "TouchSample.h"
+
+  /*
+   * Turns TOUCH_MOVE frames back into pointer motion on the exit. The gain
+   * follows how fast the finger actually moved, so it no longer depends on
+   * how often the controller happened to report, and each frame is spread
+   * over TOUCH_INTERPOLATION_STEPS moves instead of landing as one jump.
+   */
+  class TouchSmoother
+  {
+    
+    struct Stroke
+    {
+      int remaining_x;
+      int remaining_y;
+      int carry_x;
+      int carry_y;
+      unsigned int steps;
+      unsigned long long due;
+      
+      Stroke() : remaining_x(0), remaining_y(0), carry_x(0), carry_y(0), steps(0), due(0) { };
+    };
+    
+    typedef std::map<unsigned int, Stroke> StrokeList;
+    
+  public:
+    
+    static double gain(double points_per_ms);
+    
+    void push(const Message& message, unsigned long long now_ms);
+    
+    void due(unsigned long long now_ms, MessageList& ready);
+    
+    long next_timeout(unsigned long long now_ms);
+    
+  private:
+    
+    StrokeList strokes_;
+    
+  };
+
+#endif
@@ -0,0 +1,214 @@
+#include "ZeroMQBroadcastSocket.h"
+
+#include <zmq.hpp>
+#include <sstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "ZeroMQContext.hpp"
+#include "Constants.hpp"
+
+std::string ZeroMQBroadcastSocket::final_host(const std::string& host, unsigned int port)
+{
+  std::stringstream final_host;
+  final_host << "tcp://" << host << ":" << port;
+  return final_host.str();
+};
+
+ZeroMQBroadcastSocket::ZeroMQBroadcastSocket()
+{
+  
+};
+
+ZeroMQBroadcastSocket::~ZeroMQBroadcastSocket()
+{
+  terminate();
+}
+
+bool ZeroMQBroadcastSocket::open(Target& target)
+{
+  if (target.socket != 0)
+  {
+    return true;
+  }
+  
+  target.socket = ZeroMQContext::instance()->create_socket(ZMQ_PUSH, ZeroMQContext::INPUT_LANE);
+  target.consecutive_drops = 0;
+  
+  try {
+    unsigned long long hwm = BROADCAST_HWM;
+    target.socket->setsockopt(ZMQ_HWM, &hwm, sizeof(hwm));
+    target.socket->connect(final_host(target.host, target.port).c_str());
+  }
+  catch (zmq::error_t e) {
+    std::cerr << e.what() << std::endl;
+    delete target.socket;
+    target.socket = 0;
+    return false;
+  }
+  return true;
+}
+
+bool ZeroMQBroadcastSocket::connect_to(const std::string& host, unsigned int port)
+{
+  bool known = false;
+  
+  for (TargetList::iterator i = targets_.begin(); i != targets_.end(); ++i)
+  {
+    if ((*i).host == host && (*i).port == port)
+    {
+      known = true;
+    }
+  }
+  
+  if (!known)
+  {
+    Target target;
+    target.host = host;
+    target.port = port;
+    target.socket = 0;
+    target.sent = 0;
+    target.dropped = 0;
+    target.consecutive_drops = 0;
+    targets_.push_back(target);
+  }
+  
+  // reconnecting after a terminate brings the whole wall back, not just one host
+  bool result = false;
+  for (TargetList::iterator i = targets_.begin(); i != targets_.end(); ++i)
+  {
+    bool opened = open(*i);
+    if ((*i).host == host && (*i).port == port)
+    {
+      result = opened;
+    }
+  }
+  
+  return result;
+};
+
+void ZeroMQBroadcastSocket::remove_target(const std::string& host)
+{
+  for (TargetList::iterator i = targets_.begin(); i != targets_.end(); ++i)
+  {
+    if ((*i).host == host)
+    {
+      delete (*i).socket;
+      targets_.erase(i);
+      return;
+    }
+  }
+}
+
+void ZeroMQBroadcastSocket::terminate()
+{
+  bool open_targets = false;
+  
+  for (TargetList::iterator i = targets_.begin(); i != targets_.end(); ++i)
+  {
+    open_targets = open_targets || ((*i).socket != 0);
+  }
+  
+  if (!open_targets)
+  {
+    return;
+  }
+  
+  // one grace period for the whole wall rather than one per exit
+#ifdef _WIN32
+  Sleep(1000);
+#else
+  sleep(1);
+#endif
+  
+  for (TargetList::iterator i = targets_.begin(); i != targets_.end(); ++i)
+  {
+    try {
+      delete (*i).socket;
+    }
+    catch (zmq::error_t e) {
+      std::cerr << e.what() << std::endl;
+    }
+    (*i).socket = 0;
+  }
+};
+
+bool ZeroMQBroadcastSocket::send(void *data, size_t data_size)
+{
+  zmq::message_t message(data_size);
+  memcpy(message.data(), data, data_size);
+  
+  bool delivered = false;
+  
+  for (TargetList::iterator i = targets_.begin(); i != targets_.end(); ++i)
+  {
+    Target& target = *i;
+    
+    if (target.socket == 0)
+    {
+      continue;
+    }
+    
+    // copies share the encoded content, only the reference count changes
+    zmq::message_t copy;
+    copy.copy(&message);
+    
+    bool queued = false;
+    try {
+      queued = target.socket->send(copy, ZMQ_NOBLOCK);
+    }
+    catch (zmq::error_t e) {
+      std::cerr << e.what() << std::endl;
+    }
+    
+    if (queued)
+    {
+      target.sent++;
+      target.consecutive_drops = 0;
+      delivered = true;
+    }
+    else
+    {
+      target.dropped++;
+      target.consecutive_drops++;
+    }
+  }
+  
+  return delivered;
+};
+
+unsigned int ZeroMQBroadcastSocket::target_count()
+{
+  return targets_.size();
+}
+
+unsigned int ZeroMQBroadcastSocket::healthy_count()
+{
+  unsigned int count = 0;
+  
+  for (TargetList::iterator i = targets_.begin(); i != targets_.end(); ++i)
+  {
+    if ((*i).socket != 0 && (*i).consecutive_drops < BROADCAST_DROP_LIMIT)
+    {
+      count++;
+    }
+  }
+  
+  return count;
+}
+
+bool ZeroMQBroadcastSocket::is_healthy(const std::string& host)
+{
+  for (TargetList::iterator i = targets_.begin(); i != targets_.end(); ++i)
+  {
+    if ((*i).host == host)
+    {
+      return (*i).socket != 0 && (*i).consecutive_drops < BROADCAST_DROP_LIMIT;
+    }
+  }
+  
+  return false;
+}
@@ -0,0 +1,61 @@
+#ifndef ZEROMQBROADCASTSOCKET_HPP
+#define ZEROMQBROADCASTSOCKET_HPP
+
+  #include <string>
+  #include <vector>
+
+  #include "ISendSocket.hpp"
+
+  namespace zmq { class socket_t; };
+
+  /*
+   * Fans every send out to a set of exits. Each exit has its own PUSH socket
+   * with a bounded queue and is written without blocking, so a slow or dead
+   * machine drops its own events instead of stalling the rest of the wall.
+   */
+  class ZeroMQBroadcastSocket : public ISendSocket
+  {
+    
+    struct Target
+    {
+      std::string host;
+      unsigned int port;
+      zmq::socket_t* socket;
+      unsigned long long sent;
+      unsigned long long dropped;
+      unsigned int consecutive_drops;
+    };
+    
+    typedef std::vector<Target> TargetList;
+    
+  public:
+    
+    ZeroMQBroadcastSocket();
+    
+    ~ZeroMQBroadcastSocket();
+    
+    bool connect_to(const std::string& host, unsigned int port);
+    
+    void remove_target(const std::string& host);
+    
+    void terminate();
+    
+    bool send(void *data, size_t data_size);
+    
+    unsigned int target_count();
+    
+    unsigned int healthy_count();
+    
+    bool is_healthy(const std::string& host);
+    
+  private:
+    
+    bool open(Target& target);
+    
+    std::string final_host(const std::string& host, unsigned int port);
+    
+    TargetList targets_;
+    
+  };
+
+#endif
@@ -12,13 +12,22 @@ class ZeroMQContext
   
 public:
   
+  // zmq I/O thread a socket is pinned to, so bulk transfers never queue
+  // behind (or in front of) input events
+  enum Lane
+  {
+    ANY_LANE = 0,
+    INPUT_LANE = 1,
+    BULK_LANE = 2
+  };
+  
   static void init();
   
   static void destroy();
   
   static ZeroMQContext* instance();
   
-  zmq::socket_t* create_socket(int type);
+  zmq::socket_t* create_socket(int type, Lane lane = ANY_LANE);
 
 };
 
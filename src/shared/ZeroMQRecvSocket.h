@@ -14,6 +14,10 @@
     
     Message* receive();
     
+    Message* try_receive();
+    
+    void* poll_handle();
+    
     void dispose(Message* message);
     
     void terminate();
@@ -5,6 +5,10 @@
 #include <iostream>
 #include <string>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 #include "ZeroMQContext.hpp"
 
 std::string ZeroMQSendSocket::final_host(const std::string& host, unsigned int port)
@@ -16,6 +20,7 @@ std::string ZeroMQSendSocket::final_host(const std::string& host, unsigned int p
 
 ZeroMQSendSocket::ZeroMQSendSocket() 
   : socket_(0) 
+  , link_lost_(false)
 { 
 
 };
@@ -30,9 +35,16 @@ bool ZeroMQSendSocket::connect_to(const std::string& host, unsigned int port)
 {
   
 //  terminate();
-  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_PUSH); 
+  socket_ = ZeroMQContext::instance()->create_socket(ZMQ_PUSH, ZeroMQContext::INPUT_LANE); 
+  link_lost_ = false;
 
   try {
+#ifdef ZMQ_HAVE_MONITOR_CALLBACK
+    // only a dropped connection counts, an exit that never answered is
+    // still left to the idle timeout so a dead host can't cause a
+    // disconnect for every event sent to it
+    socket_->monitor(&ZeroMQSendSocket::on_event, this, ZMQ_EVENT_DISCONNECTED);
+#endif
     socket_->connect(final_host(host, port).c_str());
   }
   catch (zmq::error_t e) {
@@ -63,6 +75,16 @@ void ZeroMQSendSocket::terminate()
   }
 };
 
+void ZeroMQSendSocket::on_event(void *socket, int event, const char *endpoint, int err, void *hint)
+{
+  reinterpret_cast<ZeroMQSendSocket*>(hint)->link_lost_ = true;
+}
+
+bool ZeroMQSendSocket::link_lost()
+{
+  return socket_ != 0 && link_lost_;
+}
+
 bool ZeroMQSendSocket::send(void *data, size_t data_size)
 {
   zmq::message_t message(data_size);
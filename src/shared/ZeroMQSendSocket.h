@@ -20,12 +20,19 @@
     
     bool send(void *data, size_t data_size);
     
+    bool link_lost();
+    
   private:
     
+    static void on_event(void *socket, int event, const char *endpoint, int err, void *hint);
+    
     std::string final_host(const std::string& host, unsigned int port);
     
     zmq::socket_t* socket_;
     
+    // set from a zmq I/O thread
+    volatile bool link_lost_;
+    
   };
 
 #endif
\ No newline at end of file
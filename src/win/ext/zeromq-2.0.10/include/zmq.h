@@ -125,7 +125,10 @@ ZMQ_EXPORT const char *zmq_strerror (int errnum);
 /*  Message flags. ZMQ_MSG_SHARED is strictly speaking not a message flag     */
 /*  (it has no equivalent in the wire format), however, making  it a flag     */
 /*  allows us to pack the stucture tigher and thus improve performance.       */
+/*  The same goes for ZMQ_MSG_SLAB, which marks messages whose content lives  */
+/*  in a receive buffer shared with other messages.                           */
 #define ZMQ_MSG_MORE 1
+#define ZMQ_MSG_SLAB 64
 #define ZMQ_MSG_SHARED 128
 
 /*  A message. Note that 'content' is not a pointer to the raw data.          */
@@ -188,6 +191,7 @@ ZMQ_EXPORT int zmq_term (void *context);
 #define ZMQ_SNDBUF 11
 #define ZMQ_RCVBUF 12
 #define ZMQ_RCVMORE 13
+#define ZMQ_STATS 14
 
 /*  Send/recv options.                                                        */
 #define ZMQ_NOBLOCK 1
@@ -204,6 +208,63 @@ ZMQ_EXPORT int zmq_connect (void *s, const char *addr);
 ZMQ_EXPORT int zmq_send (void *s, zmq_msg_t *msg, int flags);
 ZMQ_EXPORT int zmq_recv (void *s, zmq_msg_t *msg, int flags);
 
+/******************************************************************************/
+/*  Statistics.                                                               */
+/******************************************************************************/
+
+/*  Statistics of a socket (ZMQ_STATS socket option) or of all the sockets    */
+/*  in a context, including the closed ones (zmq_ctx_stats). Counters count   */
+/*  message parts. HWM hits count the sends that found no pipe able to take   */
+/*  the message and the times a connection stopped reading because the        */
+/*  socket's inbound pipe was full. The fields following 'reconnects'         */
+/*  describe the current state of a socket and are not reported for           */
+/*  a context.                                                                */
+typedef struct
+{
+    unsigned long long msgs_sent;
+    unsigned long long bytes_sent;
+    unsigned long long msgs_received;
+    unsigned long long bytes_received;
+    unsigned long long send_hwm_hits;
+    unsigned long long recv_hwm_hits;
+    unsigned long long reconnects;
+    unsigned long long pipes;
+    unsigned long long queued_in;
+    unsigned long long queued_out;
+    unsigned long long swap_bytes;
+} zmq_stats_t;
+
+ZMQ_EXPORT int zmq_ctx_stats (void *context, zmq_stats_t *stats);
+
+/******************************************************************************/
+/*  Socket monitoring.                                                        */
+/******************************************************************************/
+
+/*  Lifecycle events of a socket's connections.                               */
+#define ZMQ_EVENT_CONNECTED 1
+#define ZMQ_EVENT_CONNECT_RETRIED 2
+#define ZMQ_EVENT_DISCONNECTED 4
+#define ZMQ_EVENT_ACCEPTED 8
+#define ZMQ_EVENT_BIND_FAILED 16
+#define ZMQ_EVENT_ALL 31
+
+/*  The monitor is invoked with the socket, the event, the endpoint it        */
+/*  relates to ("tcp://host:port") and the error that caused it, or zero.     */
+/*  Retries are reported when a reconnection is scheduled, i.e. after         */
+/*  a failed connection attempt or after a disconnection. The monitor runs    */
+/*  in a 0MQ I/O thread (in the caller's thread for a failed bind) so it      */
+/*  should return quickly and it must not use 0MQ sockets. Passing NULL       */
+/*  monitor removes it; once zmq_monitor returns the old one is not invoked   */
+/*  any more.                                                                 */
+typedef void (zmq_monitor_fn) (void *s, int event, const char *endpoint,
+    int err, void *hint);
+
+/*  Other libzmq releases reuse the event names for a different monitoring  */
+/*  API, so test this macro rather than the events to find zmq_monitor.       */
+#define ZMQ_HAVE_MONITOR_CALLBACK
+ZMQ_EXPORT int zmq_monitor (void *s, zmq_monitor_fn *monitor, void *hint,
+    int events);
+
 /******************************************************************************/
 /*  I/O multiplexing.                                                         */
 /******************************************************************************/
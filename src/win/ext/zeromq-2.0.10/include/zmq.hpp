@@ -241,6 +241,16 @@ namespace zmq
                 throw error_t ();
         }
 
+#ifdef ZMQ_HAVE_MONITOR_CALLBACK
+        inline void monitor (zmq_monitor_fn *monitor_, void *hint_,
+            int events_ = ZMQ_EVENT_ALL)
+        {
+            int rc = zmq_monitor (ptr, monitor_, hint_, events_);
+            if (rc != 0)
+                throw error_t ();
+        }
+#endif
+
         inline bool send (message_t &msg_, int flags_ = 0)
         {
             int rc = zmq_send (ptr, &msg_, flags_);
@@ -0,0 +1,108 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//  Measures how fast commands travel between threads through a mailbox.
+//  Several sender threads push commands into a single mailbox while the main
+//  thread receives them, the way I/O threads and application threads feed
+//  each other. Uses library internals, so it's built in-tree only.
+
+#include "../include/zmq.h"
+#include "../include/zmq_utils.h"
+#include "../src/mailbox.hpp"
+#include "../src/thread.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static zmq::mailbox_t mailbox;
+static int command_count;
+
+static void sender_routine (void *arg_)
+{
+    zmq::command_t cmd;
+    memset (&cmd, 0, sizeof (cmd));
+    cmd.type = zmq::command_t::revive;
+    for (int i = 0; i != command_count; i++)
+        mailbox.send (cmd);
+}
+
+int main (int argc, char *argv [])
+{
+    int sender_count;
+    zmq::thread_t *senders;
+    zmq::command_t cmd;
+    void *watch;
+    unsigned long elapsed;
+    unsigned long throughput;
+    int total;
+    int i;
+
+    if (argc != 3) {
+        printf ("usage: command_thr <sender-count> <command-count>\n");
+        return 1;
+    }
+    sender_count = atoi (argv [1]);
+    command_count = atoi (argv [2]);
+    if (sender_count < 1 || command_count < 1) {
+        printf ("sender and command count have to be positive\n");
+        return 1;
+    }
+
+    senders = new zmq::thread_t [sender_count];
+    total = sender_count * command_count;
+
+    watch = zmq_stopwatch_start ();
+
+    for (i = 0; i != sender_count; i++)
+        senders [i].start (sender_routine, NULL);
+
+    for (i = 0; i != total; i++) {
+        if (!mailbox.recv (&cmd, true)) {
+            printf ("error in mailbox_t::recv\n");
+            return -1;
+        }
+        if (cmd.type != zmq::command_t::revive) {
+            printf ("command of incorrect type received\n");
+            return -1;
+        }
+    }
+
+    elapsed = zmq_stopwatch_stop (watch);
+    if (elapsed == 0)
+        elapsed = 1;
+
+    for (i = 0; i != sender_count; i++)
+        senders [i].stop ();
+    delete [] senders;
+
+    //  Nothing may be left over once every command was accounted for.
+    if (mailbox.recv (&cmd, false)) {
+        printf ("unexpected command received\n");
+        return -1;
+    }
+
+    throughput = (unsigned long)
+        ((double) total / (double) elapsed * 1000000);
+
+    printf ("sender count: %d\n", sender_count);
+    printf ("command count: %d\n", total);
+    printf ("mean throughput: %d [cmd/s]\n", (int) throughput);
+
+    return 0;
+}
@@ -32,6 +32,8 @@ int main (int argc, char *argv [])
     int rc;
     int i;
     zmq_msg_t msg;
+    zmq_stats_t stats;
+    size_t stats_size;
     void *watch;
     unsigned long elapsed;
     unsigned long throughput;
@@ -121,6 +123,16 @@ int main (int argc, char *argv [])
     printf ("mean throughput: %d [msg/s]\n", (int) throughput);
     printf ("mean throughput: %.3f [Mb/s]\n", (double) megabits);
 
+    stats_size = sizeof (stats);
+    rc = zmq_getsockopt (s, ZMQ_STATS, &stats, &stats_size);
+    if (rc != 0) {
+        printf ("error in zmq_getsockopt: %s\n", zmq_strerror (errno));
+        return -1;
+    }
+    printf ("received: %llu [msg], %llu [B]\n", stats.msgs_received,
+        stats.bytes_received);
+    printf ("receive hwm hits: %llu\n", stats.recv_hwm_hits);
+
     rc = zmq_close (s);
     if (rc != 0) {
         printf ("error in zmq_close: %s\n", zmq_strerror (errno));
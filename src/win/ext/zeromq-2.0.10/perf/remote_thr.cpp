@@ -32,6 +32,8 @@ int main (int argc, char *argv [])
     int rc;
     int i;
     zmq_msg_t msg;
+    zmq_stats_t stats;
+    size_t stats_size;
 
     if (argc != 4) {
         printf ("usage: remote_thr <connect-to> <message-size> "
@@ -81,6 +83,18 @@ int main (int argc, char *argv [])
         }
     }
 
+    stats_size = sizeof (stats);
+    rc = zmq_getsockopt (s, ZMQ_STATS, &stats, &stats_size);
+    if (rc != 0) {
+        printf ("error in zmq_getsockopt: %s\n", zmq_strerror (errno));
+        return -1;
+    }
+    printf ("sent: %llu [msg], %llu [B]\n", stats.msgs_sent,
+        stats.bytes_sent);
+    printf ("send hwm hits: %llu\n", stats.send_hwm_hits);
+    printf ("queued: %llu [msg], swapped: %llu [B]\n", stats.queued_out,
+        stats.swap_bytes);
+
     zmq_sleep (10);
 
     rc = zmq_close (s);
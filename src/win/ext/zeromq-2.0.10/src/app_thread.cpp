@@ -26,9 +26,6 @@
 
 #if defined ZMQ_HAVE_WINDOWS
 #include "windows.hpp"
-#if defined _MSC_VER
-#include <intrin.h>
-#endif
 #else
 #include <unistd.h>
 #endif
@@ -49,18 +46,9 @@
 #include "pull.hpp"
 #include "push.hpp"
 
-//  If the RDTSC is available we use it to prevent excessive
-//  polling for commands. The nice thing here is that it will work on any
-//  system with x86 architecture and gcc or MSVC compiler.
-#if (defined __GNUC__ && (defined __i386__ || defined __x86_64__)) ||\
-    (defined _MSC_VER && (defined _M_IX86 || defined _M_X64))
-#define ZMQ_DELAY_COMMANDS
-#endif
-
 zmq::app_thread_t::app_thread_t (ctx_t *ctx_,
         uint32_t thread_slot_) :
     object_t (ctx_, thread_slot_),
-    last_processing_time (0),
     terminated (false)
 {
 }
@@ -75,60 +63,34 @@ void zmq::app_thread_t::stop ()
     send_stop ();
 }
 
-zmq::signaler_t *zmq::app_thread_t::get_signaler ()
+zmq::mailbox_t *zmq::app_thread_t::get_mailbox ()
 {
-    return &signaler;
+    return &mailbox;
 }
 
-bool zmq::app_thread_t::process_commands (bool block_, bool throttle_)
+bool zmq::app_thread_t::process_commands (bool block_)
 {
     bool received;
     command_t cmd;
     if (block_) {
-        received = signaler.recv (&cmd, true);
+        received = mailbox.recv (&cmd, true);
         zmq_assert (received);
     }   
     else {
 
-#if defined ZMQ_DELAY_COMMANDS
-        //  Optimised version of command processing - it doesn't have to check
-        //  for incoming commands each time. It does so only if certain time
-        //  elapsed since last command processing. Command delay varies
-        //  depending on CPU speed: It's ~1ms on 3GHz CPU, ~2ms on 1.5GHz CPU
-        //  etc. The optimisation makes sense only on platforms where getting
-        //  a timestamp is a very cheap operation (tens of nanoseconds).
-        if (throttle_) {
-
-            //  Get timestamp counter.
-#if defined __GNUC__
-            uint32_t low;
-            uint32_t high;
-            __asm__ volatile ("rdtsc" : "=a" (low), "=d" (high));
-            uint64_t current_time = (uint64_t) high << 32 | low;
-#elif defined _MSC_VER
-            uint64_t current_time = __rdtsc ();
-#else
-#error
-#endif
-
-            //  Check whether TSC haven't jumped backwards (in case of migration
-            //  between CPU cores) and whether certain time have elapsed since
-            //  last command processing. If it didn't do nothing.
-            if (current_time >= last_processing_time &&
-                  current_time - last_processing_time <= max_command_delay)
-                return !terminated;
-            last_processing_time = current_time;
-        }
-#endif
+        //  The mailbox flags pending commands in a single word, so checking
+        //  it on every call is cheaper than any attempt to check less often.
+        if (!mailbox.pending ())
+            return !terminated;
 
-        //  Check whether there are any commands pending for this thread.
-        received = signaler.recv (&cmd, false);
+        //  Get the first of the pending commands.
+        received = mailbox.recv (&cmd, false);
     }
 
     //  Process all the commands available at the moment.
     while (received) {
         cmd.destination->process_command (cmd);
-        received = signaler.recv (&cmd, false);
+        received = mailbox.recv (&cmd, false);
     }
 
     return !terminated;
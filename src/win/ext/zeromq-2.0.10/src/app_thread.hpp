@@ -25,7 +25,7 @@
 #include "stdint.hpp"
 #include "object.hpp"
 #include "yarray.hpp"
-#include "signaler.hpp"
+#include "mailbox.hpp"
 
 namespace zmq
 {
@@ -42,15 +42,14 @@ namespace zmq
         //  This function is is called from a different thread!
         void stop ();
 
-        //  Returns signaler associated with this application thread.
-        signaler_t *get_signaler ();
+        //  Returns mailbox associated with this application thread.
+        mailbox_t *get_mailbox ();
 
         //  Processes commands sent to this thread (if any). If 'block' is
         //  set to true, returns only after at least one command was processed.
-        //  If throttle argument is true, commands are processed at most once
-        //  in a predefined time period. The function returns false is the
-        //  associated context was terminated, true otherwise.
-        bool process_commands (bool block_, bool throttle_);
+        //  The function returns false is the associated context was
+        //  terminated, true otherwise.
+        bool process_commands (bool block_);
 
         //  Create a socket of a specified type.
         class socket_base_t *create_socket (int type_);
@@ -70,11 +69,8 @@ namespace zmq
         typedef yarray_t <socket_base_t> sockets_t;
         sockets_t sockets;
 
-        //  App thread's signaler object.
-        signaler_t signaler;
-
-        //  Timestamp of when commands were processed the last time.
-        uint64_t last_processing_time;
+        //  App thread's mailbox object.
+        mailbox_t mailbox;
 
         //  If true, 'stop' command was already received.
         bool terminated;
@@ -70,6 +70,13 @@ namespace zmq
             this->ptr = ptr_;
         }
 
+        //  Read the value of the pointer. No memory barrier is involved, so
+        //  the value may be slightly out of date. Use it as a hint only.
+        inline T *get ()
+        {
+            return (T*) ptr;
+        }
+
         //  Perform atomic 'exchange pointers' operation. Pointer is set
         //  to the 'val' value. Old value is returned.
         inline T *xchg (T *val_)
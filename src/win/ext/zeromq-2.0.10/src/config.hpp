@@ -40,38 +40,46 @@ namespace zmq
         //  using a single system call.
         signal_buffer_size = 8,
 
-        //  Determines how often does socket poll for new commands when it
-        //  still has unprocessed messages to handle. Thus, if it is set to 100,
-        //  socket will process 100 inbound messages before doing the poll.
-        //  If there are no unprocessed messages available, poll is done
-        //  immediately. Decreasing the value trades overall latency for more
-        //  real-time behaviour (less latency peaks).
-        inbound_poll_rate = 100,
-
         //  Maximal batching size for engines with receiving functionality.
         //  So, if there are 10 messages that fit into the batch size, all of
         //  them may be read by a single 'recv' system call, thus avoiding
         //  unnecessary network stack traversals.
         in_batch_size = 8192,
 
+        //  Maximal number of messages left in place in a single receive
+        //  batch. Any further messages in the batch are copied out of it.
+        in_batch_messages = 128,
+
         //  Maximal batching size for engines with sending functionality.
         //  So, if there are 10 messages that fit into the batch size, all of
         //  them may be written by a single 'send' system call, thus avoiding
         //  unnecessary network stack traversals.
         out_batch_size = 8192,
 
+        //  Message bodies at least this big are written to the network
+        //  straight from the message instead of being copied to the batch.
+        min_gather_size = 1024,
+
+        //  Maximal number of pieces in a scatter-gather batch.
+        out_batch_pieces = 64,
+
+        //  Maximal number of batches an engine writes per output event, so
+        //  that a single busy connection can't starve the others.
+        out_batches_per_event = 4,
+
         //  Maximal delta between high and low watermark.
         max_wm_delta = 1024,
 
+        //  Maximal number of bytes a thread keeps cached in the memory pool.
+        //  Blocks released beyond that go back to the system allocator.
+        pool_cache_size = 8388608,
+
         //  Maximum number of events the I/O thread can process in one go.
         max_io_events = 256,
 
-        //  Maximal wait time for a timer (milliseconds).
-        max_timer_period = 100,
-
-        //  Maximal delay to process command in API thread (in CPU ticks).
-        //  3,000,000 ticks equals to 1 - 2 milliseconds on current CPUs.
-        max_command_delay = 3000000,
+        //  Time to wait before trying to reconnect after a failed
+        //  connection attempt (milliseconds).
+        reconnect_ivl = 100,
 
         //  Maximal number of non-accepted connections that can be held by
         //  TCP listener object.
@@ -29,6 +29,7 @@
 #include "platform.hpp"
 #include "err.hpp"
 #include "pipe.hpp"
+#include "stats.hpp"
 
 #if defined ZMQ_HAVE_WINDOWS
 #include "windows.h"
@@ -38,6 +39,8 @@ zmq::ctx_t::ctx_t (uint32_t io_threads_) :
     sockets (0),
     terminated (false)
 {
+    memset (&closed_stats, 0, sizeof (closed_stats));
+
 #ifdef ZMQ_HAVE_WINDOWS
     //  Intialise Windows sockets. Note that WSAStartup can be called multiple
     //  times given that WSACleanup will be called for each WSAStartup.
@@ -49,18 +52,18 @@ zmq::ctx_t::ctx_t (uint32_t io_threads_) :
         HIBYTE (wsa_data.wVersion) == 2);
 #endif
 
-    //  Initialise the array of signalers.
-    signalers_count = max_app_threads + io_threads_;
-    signalers = (signaler_t**) malloc (sizeof (signaler_t*) * signalers_count);
-    zmq_assert (signalers);
-    memset (signalers, 0, sizeof (signaler_t*) * signalers_count);
+    //  Initialise the array of mailboxes.
+    mailboxes_count = max_app_threads + io_threads_;
+    mailboxes = (mailbox_t**) malloc (sizeof (mailbox_t*) * mailboxes_count);
+    zmq_assert (mailboxes);
+    memset (mailboxes, 0, sizeof (mailbox_t*) * mailboxes_count);
 
     //  Create I/O thread objects and launch them.
     for (uint32_t i = 0; i != io_threads_; i++) {
         io_thread_t *io_thread = new (std::nothrow) io_thread_t (this, i);
         zmq_assert (io_thread);
         io_threads.push_back (io_thread);
-        signalers [i] = io_thread->get_signaler ();
+        mailboxes [i] = io_thread->get_mailbox ();
         io_thread->start ();
     }
 }
@@ -105,10 +108,10 @@ zmq::ctx_t::~ctx_t ()
     while (!pipes.empty ())
         delete *pipes.begin ();
 
-    //  Deallocate the array of pointers to signalers. No special work is
-    //  needed as signalers themselves were deallocated with their
+    //  Deallocate the array of pointers to mailboxes. No special work is
+    //  needed as mailboxes themselves were deallocated with their
     //  corresponding (app_/io_) thread objects.
-    free (signalers);
+    free (mailboxes);
     
 #ifdef ZMQ_HAVE_WINDOWS
     //  On Windows, uninitialise socket layer.
@@ -156,8 +159,8 @@ zmq::socket_base_t *zmq::ctx_t::create_socket (int type_)
             info.app_thread = new (std::nothrow) app_thread_t (this,
                 io_threads.size () + app_threads.size ());
             zmq_assert (info.app_thread);
-            signalers [io_threads.size () + app_threads.size ()] =
-                info.app_thread->get_signaler ();
+            mailboxes [io_threads.size () + app_threads.size ()] =
+                info.app_thread->get_mailbox ();
             app_threads.push_back (info);
         }
 
@@ -214,13 +217,13 @@ void zmq::ctx_t::no_sockets (app_thread_t *thread_)
 void zmq::ctx_t::send_command (uint32_t destination_,
     const command_t &command_)
 {
-    signalers [destination_]->send (command_);
+    mailboxes [destination_]->send (command_);
 }
 
 bool zmq::ctx_t::recv_command (uint32_t thread_slot_,
     command_t *command_, bool block_)
 {
-    return signalers [thread_slot_]->recv (command_, block_);
+    return mailboxes [thread_slot_]->recv (command_, block_);
 }
 
 zmq::io_thread_t *zmq::ctx_t::choose_io_thread (uint64_t affinity_)
@@ -258,6 +261,32 @@ void zmq::ctx_t::unregister_pipe (class pipe_t *pipe_)
     pipes_sync.unlock ();
 }
 
+void zmq::ctx_t::register_stats (socket_stats_t *stats_)
+{
+    stats_sync.lock ();
+    bool inserted = stats.insert (stats_).second;
+    zmq_assert (inserted);
+    stats_sync.unlock ();
+}
+
+void zmq::ctx_t::unregister_stats (socket_stats_t *stats_)
+{
+    stats_sync.lock ();
+    stats_t::size_type erased = stats.erase (stats_);
+    zmq_assert (erased == 1);
+    stats_->sum (&closed_stats);
+    stats_sync.unlock ();
+}
+
+void zmq::ctx_t::get_stats (zmq_stats_t *stats_)
+{
+    stats_sync.lock ();
+    *stats_ = closed_stats;
+    for (stats_t::iterator it = stats.begin (); it != stats.end (); it++)
+        (*it)->sum (stats_);
+    stats_sync.unlock ();
+}
+
 int zmq::ctx_t::register_endpoint (const char *addr_,
     socket_base_t *socket_)
 {
@@ -25,7 +25,9 @@
 #include <map>
 #include <string>
 
-#include "signaler.hpp"
+#include "../include/zmq.h"
+
+#include "mailbox.hpp"
 #include "ypipe.hpp"
 #include "config.hpp"
 #include "mutex.hpp"
@@ -83,6 +85,16 @@ namespace zmq
         void unregister_endpoints (class socket_base_t *socket_);
         class socket_base_t *find_endpoint (const char *addr_);
 
+        //  Sockets register their statistics with the context so that
+        //  the totals for the context can be computed. When unregistered,
+        //  the statistics are added to the totals of the closed sockets.
+        void register_stats (struct socket_stats_t *stats_);
+        void unregister_stats (struct socket_stats_t *stats_);
+
+        //  Fills in stats_ with the totals for all the sockets in the
+        //  context, whether still alive or closed.
+        void get_stats (zmq_stats_t *stats_);
+
     private:
 
         ~ctx_t ();
@@ -112,9 +124,9 @@ namespace zmq
         typedef std::vector <class io_thread_t*> io_threads_t;
         io_threads_t io_threads;
 
-        //  Array of pointers to signalers for both application and I/O threads.
-        int signalers_count;
-        signaler_t **signalers;
+        //  Array of pointers to mailboxes for both application and I/O threads.
+        int mailboxes_count;
+        mailbox_t **mailboxes;
 
         //  As pipes may reside in orphaned state in particular moments
         //  of the pipe shutdown process, i.e. neither pipe reader nor
@@ -146,6 +158,15 @@ namespace zmq
         //  Synchronisation of access to the list of inproc endpoints.
         mutex_t endpoints_sync;
 
+        //  Statistics of the sockets alive and the totals of the sockets
+        //  already closed.
+        typedef std::set <struct socket_stats_t*> stats_t;
+        stats_t stats;
+        zmq_stats_t closed_stats;
+
+        //  Synchronisation of access to the statistics.
+        mutex_t stats_sync;
+
         ctx_t (const ctx_t&);
         void operator = (const ctx_t&);
     };
@@ -22,9 +22,11 @@
 
 #include <stddef.h>
 #include <string.h>
-#include <stdlib.h>
 #include <algorithm>
 
+#include "../include/zmq.h"
+
+#include "slab.hpp"
 #include "err.hpp"
 
 namespace zmq
@@ -40,6 +42,9 @@ namespace zmq
     //
     //  Decoder implements the state machine that parses the incoming buffer.
     //  Derived class should implement individual state machine actions.
+    //
+    //  Data are read into a slab that messages can refer to in place (see
+    //  carve) rather than having their bodies copied out of it.
 
     template <typename T> class decoder_t
     {
@@ -49,17 +54,20 @@ namespace zmq
             read_pos (NULL),
             to_read (0),
             next (NULL),
+            in_pos (NULL),
+            in_end (NULL),
+            in_slab (false),
             bufsize (bufsize_)
         {
-            buf = (unsigned char*) malloc (bufsize_);
-            zmq_assert (buf);
+            slab = slab_t::create (bufsize_);
+            zmq_assert (slab);
         }
 
         //  The destructor doesn't have to be virtual. It is mad virtual
         //  just to keep ICC and code checking tools from complaining.
         inline virtual ~decoder_t ()
         {
-            free (buf);
+            slab->release ();
         }
 
         //  Returns a buffer to be filled with binary data.
@@ -79,7 +87,15 @@ namespace zmq
                 return;
             }
 
-            *data_ = buf;
+            //  Messages carved out of the slab may still be around, in which
+            //  case their data must stay intact and a new slab is needed.
+            if (!slab->reuse ()) {
+                slab->release ();
+                slab = slab_t::create (bufsize);
+                zmq_assert (slab);
+            }
+
+            *data_ = slab->data ();
             *size_ = bufsize;
         }
 
@@ -95,6 +111,7 @@ namespace zmq
             if (data_ == read_pos) {
                 read_pos += size_;
                 to_read -= size_;
+                in_slab = false;
 
                 while (!to_read)
                     if (!(static_cast <T*> (this)->*next) ())
@@ -102,24 +119,30 @@ namespace zmq
                 return size_;
             }
 
-            size_t pos = 0;
+            in_pos = data_;
+            in_end = data_ + size_;
+
+            //  Only data in the slab can be referred to in place.
+            in_slab = data_ >= slab->data () &&
+                data_ < slab->data () + slab->size ();
+
             while (true) {
 
                 //  Try to get more space in the message to fill in.
                 //  If none is available, return.
                 while (!to_read)
                     if (!(static_cast <T*> (this)->*next) ())
-                        return pos;
+                        return in_pos - data_;
 
                 //  If there are no more data in the buffer, return.
-                if (pos == size_)
-                    return pos;
+                if (in_pos == in_end)
+                    return size_;
 
                 //  Copy the data from buffer to the message.
-                size_t to_copy = std::min (to_read, size_ - pos);
-                memcpy (read_pos, data_ + pos, to_copy);
+                size_t to_copy = std::min (to_read, (size_t) (in_end - in_pos));
+                memcpy (read_pos, in_pos, to_copy);
                 read_pos += to_copy;
-                pos += to_copy;
+                in_pos += to_copy;
                 to_read -= to_copy;
             }
         }
@@ -130,6 +153,18 @@ namespace zmq
         //  it is unable to push the data to the system.
         typedef bool (T::*step_t) ();
 
+        //  If the next size_ bytes of input are in the slab already,
+        //  initialises msg_ to refer to them in place, skips them and
+        //  returns true. Otherwise returns false and msg_ is left untouched.
+        inline bool carve (::zmq_msg_t *msg_, size_t size_)
+        {
+            if (!in_slab || (size_t) (in_end - in_pos) < size_ ||
+                  !slab->carve (msg_, in_pos, size_))
+                return false;
+            in_pos += size_;
+            return true;
+        }
+
         //  This function should be called from derived class to read data
         //  from the buffer and schedule next state machine action.
         inline void next_step (void *read_pos_, size_t to_read_,
@@ -146,8 +181,14 @@ namespace zmq
         size_t to_read;
         step_t next;
 
+        //  The part of the input being processed not consumed yet and
+        //  whether it lies in the slab.
+        unsigned char *in_pos;
+        unsigned char *in_end;
+        bool in_slab;
+
         size_t bufsize;
-        unsigned char *buf;
+        slab_t *slab;
 
         decoder_t (const decoder_t&);
         void operator = (const decoder_t&);
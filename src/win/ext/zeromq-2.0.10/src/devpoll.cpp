@@ -128,18 +128,6 @@ void zmq::devpoll_t::reset_pollout (handle_t handle_)
     devpoll_ctl (handle_, fd_table [handle_].events);
 }
 
-void zmq::devpoll_t::add_timer (i_poll_events *events_)
-{
-     timers.push_back (events_);
-}
-
-void zmq::devpoll_t::cancel_timer (i_poll_events *events_)
-{
-    timers_t::iterator it = std::find (timers.begin (), timers.end (), events_);
-    if (it != timers.end ())
-        timers.erase (it);
-}
-
 int zmq::devpoll_t::get_load ()
 {
     return load.get ();
@@ -172,7 +160,9 @@ void zmq::devpoll_t::loop ()
 
         poll_req.dp_fds = &ev_buf [0];
         poll_req.dp_nfds = nfds;
-        poll_req.dp_timeout = timers.empty () ? -1 : max_timer_period;
+
+        //  Fire the due timers and find out how long we can wait.
+        poll_req.dp_timeout = execute_timers ();
 
         //  Wait for events.
         int n = ioctl (devpoll_fd, DP_POLL, &poll_req);
@@ -180,21 +170,6 @@ void zmq::devpoll_t::loop ()
             continue;
         errno_assert (n != -1);
 
-        //  Handle timer.
-        if (!n) {
-
-            //  Use local list of timers as timer handlers may fill new timers
-            //  into the original array.
-            timers_t t;
-            std::swap (timers, t);
-
-            //  Trigger all the timers.
-            for (timers_t::iterator it = t.begin (); it != t.end (); it ++)
-                (*it)->timer_event ();
-
-            continue;
-        }
-
         for (int i = 0; i < n; i ++) {
 
             fd_entry_t *fd_ptr = &fd_table [ev_buf [i].fd];
@@ -29,6 +29,7 @@
 #include "fd.hpp"
 #include "thread.hpp"
 #include "atomic_counter.hpp"
+#include "poller_base.hpp"
 
 namespace zmq
 {
@@ -36,7 +37,7 @@ namespace zmq
     //  Implements socket polling mechanism using the Solaris-specific
     //  "/dev/poll" interface.
 
-    class devpoll_t
+    class devpoll_t : public poller_base_t
     {
     public:
 
@@ -52,8 +53,6 @@ namespace zmq
         void reset_pollin (handle_t handle_);
         void set_pollout (handle_t handle_);
         void reset_pollout (handle_t handle_);
-        void add_timer (struct i_poll_events *events_);
-        void cancel_timer (struct i_poll_events *events_);
         int get_load ();
         void start ();
         void stop ();
@@ -85,10 +84,6 @@ namespace zmq
         //  Pollset manipulation function.
         void devpoll_ctl (fd_t fd_, short events_);
 
-        //  List of all the engines waiting for the timer event.
-        typedef std::vector <struct i_poll_events*> timers_t;
-        timers_t timers;
-
         //  If true, thread is in the process of shutting down.
         bool stopping;
 
@@ -31,6 +31,8 @@
 #include <algorithm>
 
 #include "err.hpp"
+#include "iovec.hpp"
+#include "config.hpp"
 
 namespace zmq
 {
@@ -66,6 +68,9 @@ namespace zmq
         inline void get_data (unsigned char **data_, size_t *size_,
             int *offset_ = NULL)
         {
+            //  The previous batch is written out by now.
+            static_cast <T*> (this)->release ();
+
             unsigned char *buffer = !*data_ ? buf : *data_;
             size_t buffersize = !*data_ ? bufsize : *size_;
 
@@ -126,6 +131,70 @@ namespace zmq
             }
         }
 
+        //  Scatter-gather counterpart of get_data. Fills in at most count_
+        //  pieces and returns the number of pieces filled in. Zero means
+        //  there's nothing to send. Chunks marked as stable that are at least
+        //  min_gather_size bytes long are returned in place and the derived
+        //  class is asked to pin them. Everything else, such as message
+        //  headers and very small messages, is copied into the batch buffer
+        //  where it gets coalesced. The pins are released on the next call,
+        //  so the whole batch has to be written out before asking for more.
+        inline int get_iov (iovec_t *iov_, int count_)
+        {
+            static_cast <T*> (this)->release ();
+
+            size_t pos = 0;
+            int n = 0;
+
+            //  True if the last piece is a run of bytes in the batch buffer
+            //  that further copies can extend.
+            bool coalescing = false;
+
+            while (true) {
+
+                //  If there are no more data to return, run the state machine.
+                //  If there are still no data, return what we already have.
+                if (!to_write) {
+                    if (!(static_cast <T*> (this)->*next) ())
+                        return n;
+                    if (!to_write)
+                        continue;
+                }
+
+                //  Return large stable chunks in place.
+                if (stable && to_write >= min_gather_size) {
+                    if (n == count_)
+                        return n;
+                    iov_ [n].data = write_pos;
+                    iov_ [n].size = to_write;
+                    n++;
+                    coalescing = false;
+                    static_cast <T*> (this)->pin ();
+                    write_pos += to_write;
+                    to_write = 0;
+                    continue;
+                }
+
+                //  Copy data to the buffer. If the buffer is full, return.
+                if (pos == bufsize)
+                    return n;
+                if (!coalescing) {
+                    if (n == count_)
+                        return n;
+                    iov_ [n].data = buf + pos;
+                    iov_ [n].size = 0;
+                    n++;
+                    coalescing = true;
+                }
+                size_t to_copy = std::min (to_write, bufsize - pos);
+                memcpy (buf + pos, write_pos, to_copy);
+                pos += to_copy;
+                write_pos += to_copy;
+                to_write -= to_copy;
+                iov_ [n - 1].size += to_copy;
+            }
+        }
+
     protected:
 
         //  Prototype of state machine action.
@@ -133,14 +202,17 @@ namespace zmq
 
         //  This function should be called from derived class to write the data
         //  to the buffer and schedule next state machine action. Set beginning
-        //  to true when you are writing first byte of a message.
+        //  to true when you are writing first byte of a message. Set stable
+        //  to true if the data stay valid after the next action as long as
+        //  they are pinned.
         inline void next_step (void *write_pos_, size_t to_write_,
-            step_t next_, bool beginning_)
+            step_t next_, bool beginning_, bool stable_ = false)
         {
             write_pos = (unsigned char*) write_pos_;
             to_write = to_write_;
             next = next_;
             beginning = beginning_;
+            stable = stable_;
         }
 
     private:
@@ -149,6 +221,7 @@ namespace zmq
         size_t to_write;
         step_t next;
         bool beginning;
+        bool stable;
 
         size_t bufsize;
         unsigned char *buf;
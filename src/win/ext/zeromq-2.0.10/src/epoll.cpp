@@ -25,7 +25,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
-#include <algorithm>
 #include <new>
 
 #include "epoll.hpp"
@@ -65,10 +64,14 @@ zmq::epoll_t::handle_t zmq::epoll_t::add_fd (fd_t fd_, i_poll_events *events_)
     pe->fd = fd_;
     pe->ev.events = 0;
     pe->ev.data.ptr = pe;
+    pe->desired = 0;
+    pe->registered = false;
+    pe->changed = false;
     pe->events = events_;
 
-    int rc = epoll_ctl (epoll_fd, EPOLL_CTL_ADD, fd_, &pe->ev);
-    errno_assert (rc != -1);
+    //  The fd is added to the epoll set lazily, usually together with the
+    //  events the owner asks for right after this call.
+    change (pe);
 
     //  Increase the load metric of the thread.
     load.add (1);
@@ -79,8 +82,12 @@ zmq::epoll_t::handle_t zmq::epoll_t::add_fd (fd_t fd_, i_poll_events *events_)
 void zmq::epoll_t::rm_fd (handle_t handle_)
 {
     poll_entry_t *pe = (poll_entry_t*) handle_;
-    int rc = epoll_ctl (epoll_fd, EPOLL_CTL_DEL, pe->fd, &pe->ev);
-    errno_assert (rc != -1);
+
+    //  The fd is going to be closed, so it has to leave the epoll set now.
+    if (pe->registered) {
+        int rc = epoll_ctl (epoll_fd, EPOLL_CTL_DEL, pe->fd, &pe->ev);
+        errno_assert (rc != -1);
+    }
     pe->fd = retired_fd;
     retired.push_back (pe);
 
@@ -91,46 +98,56 @@ void zmq::epoll_t::rm_fd (handle_t handle_)
 void zmq::epoll_t::set_pollin (handle_t handle_)
 {
     poll_entry_t *pe = (poll_entry_t*) handle_;
-    pe->ev.events |= EPOLLIN;
-    int rc = epoll_ctl (epoll_fd, EPOLL_CTL_MOD, pe->fd, &pe->ev);
-    errno_assert (rc != -1);
+    pe->desired |= EPOLLIN;
+    change (pe);
 }
 
 void zmq::epoll_t::reset_pollin (handle_t handle_)
 {
     poll_entry_t *pe = (poll_entry_t*) handle_;
-    pe->ev.events &= ~((short) EPOLLIN);
-    int rc = epoll_ctl (epoll_fd, EPOLL_CTL_MOD, pe->fd, &pe->ev);
-    errno_assert (rc != -1);
+    pe->desired &= ~((uint32_t) EPOLLIN);
+    change (pe);
 }
 
 void zmq::epoll_t::set_pollout (handle_t handle_)
 {
     poll_entry_t *pe = (poll_entry_t*) handle_;
-    pe->ev.events |= EPOLLOUT;
-    int rc = epoll_ctl (epoll_fd, EPOLL_CTL_MOD, pe->fd, &pe->ev);
-    errno_assert (rc != -1);
+    pe->desired |= EPOLLOUT;
+    change (pe);
 }
 
 void zmq::epoll_t::reset_pollout (handle_t handle_)
 {
     poll_entry_t *pe = (poll_entry_t*) handle_;
-    pe->ev.events &= ~((short) EPOLLOUT);
-    int rc = epoll_ctl (epoll_fd, EPOLL_CTL_MOD, pe->fd, &pe->ev);
-    errno_assert (rc != -1);
+    pe->desired &= ~((uint32_t) EPOLLOUT);
+    change (pe);
 }
 
-void zmq::epoll_t::add_timer (i_poll_events *events_)
+void zmq::epoll_t::change (poll_entry_t *pe_)
 {
-     timers.push_back (events_);
+    if (pe_->changed)
+        return;
+    pe_->changed = true;
+    changed.push_back (pe_);
 }
 
-void zmq::epoll_t::cancel_timer (i_poll_events *events_)
+void zmq::epoll_t::apply_changes ()
 {
-    timers_t::iterator it = std::find (timers.begin (), timers.end (), events_);
-    if (it == timers.end ())
-        return;
-    timers.erase (it);
+    for (changed_t::iterator it = changed.begin (); it != changed.end ();
+          it ++) {
+        poll_entry_t *pe = *it;
+        pe->changed = false;
+        if (pe->fd == retired_fd)
+            continue;
+        if (pe->registered && pe->ev.events == pe->desired)
+            continue;
+        pe->ev.events = pe->desired;
+        int rc = epoll_ctl (epoll_fd,
+            pe->registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, pe->fd, &pe->ev);
+        errno_assert (rc != -1);
+        pe->registered = true;
+    }
+    changed.clear ();
 }
 
 int zmq::epoll_t::get_load ()
@@ -154,32 +171,30 @@ void zmq::epoll_t::loop ()
 
     while (!stopping) {
 
+        //  Bring the epoll set up to date.
+        apply_changes ();
+
+        //  Destroy retired event sources. No change refers to them anymore
+        //  and neither does the event buffer.
+        for (retired_t::iterator it = retired.begin (); it != retired.end ();
+              it ++)
+            delete *it;
+        retired.clear ();
+
+        //  Fire the due timers. This happens on every iteration so that
+        //  a steady stream of I/O events cannot hold them back.
+        int timeout = execute_timers ();
+
         //  Wait for events.
         int n;
         while (true) {
-            n = epoll_wait (epoll_fd, &ev_buf [0], max_io_events,
-                timers.empty () ? -1 : max_timer_period);
+            n = epoll_wait (epoll_fd, &ev_buf [0], max_io_events, timeout);
             if (!(n == -1 && errno == EINTR)) {
                 errno_assert (n != -1);
                 break;
             }
         }
 
-        //  Handle timer.
-        if (!n) {
-
-            //  Use local list of timers as timer handlers may fill new timers
-            //  into the original array.
-            timers_t t;
-            std::swap (timers, t);
-
-            //  Trigger all the timers.
-            for (timers_t::iterator it = t.begin (); it != t.end (); it ++)
-                (*it)->timer_event ();
-
-            continue;
-        }
-
         for (int i = 0; i < n; i ++) {
             poll_entry_t *pe = ((poll_entry_t*) ev_buf [i].data.ptr);
 
@@ -189,19 +204,16 @@ void zmq::epoll_t::loop ()
                 pe->events->in_event ();
             if (pe->fd == retired_fd)
                continue;
-            if (ev_buf [i].events & EPOLLOUT)
+
+            //  Skip events the owner lost interest in while this batch
+            //  was being processed.
+            if (ev_buf [i].events & pe->desired & EPOLLOUT)
                 pe->events->out_event ();
             if (pe->fd == retired_fd)
                 continue;
-            if (ev_buf [i].events & EPOLLIN)
+            if (ev_buf [i].events & pe->desired & EPOLLIN)
                 pe->events->in_event ();
         }
-
-        //  Destroy retired event sources.
-        for (retired_t::iterator it = retired.begin (); it != retired.end ();
-              it ++)
-            delete *it;
-        retired.clear ();
     }
 }
 
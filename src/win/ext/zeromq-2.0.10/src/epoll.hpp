@@ -30,14 +30,17 @@
 #include "fd.hpp"
 #include "thread.hpp"
 #include "atomic_counter.hpp"
+#include "poller_base.hpp"
 
 namespace zmq
 {
 
     //  This class implements socket polling mechanism using the Linux-specific
-    //  epoll mechanism.
+    //  epoll mechanism. Interest changes are recorded and applied once per
+    //  loop iteration, just before waiting, so that a set/reset pair made
+    //  while handling a batch of events costs no system call at all.
 
-    class epoll_t
+    class epoll_t : public poller_base_t
     {
     public:
 
@@ -53,8 +56,6 @@ namespace zmq
         void reset_pollin (handle_t handle_);
         void set_pollout (handle_t handle_);
         void reset_pollout (handle_t handle_);
-        void add_timer (struct i_poll_events *events_);
-        void cancel_timer (struct i_poll_events *events_);
         int get_load ();
         void start ();
         void stop ();
@@ -73,18 +74,36 @@ namespace zmq
         struct poll_entry_t
         {
             fd_t fd;
+
+            //  Events registered with epoll at the moment.
             epoll_event ev;
+
+            //  Events the owner wants to be notified about.
+            uint32_t desired;
+
+            //  True if the fd was added to the epoll set already.
+            bool registered;
+
+            //  True if the entry is in the list of changed entries.
+            bool changed;
+
             struct i_poll_events *events;
         };
 
+        //  Schedules the entry to be brought in line with its desired events.
+        void change (poll_entry_t *pe_);
+
+        //  Applies the changes scheduled since the last call to epoll.
+        void apply_changes ();
+
+        //  Entries whose desired events may differ from the registered ones.
+        typedef std::vector <poll_entry_t*> changed_t;
+        changed_t changed;
+
         //  List of retired event sources.
         typedef std::vector <poll_entry_t*> retired_t;
         retired_t retired;
 
-        //  List of all the engines waiting for the timer event.
-        typedef std::vector <struct i_poll_events*> timers_t;
-        timers_t timers;
-
         //  If true, thread is in the process of shutting down.
         bool stopping;
 
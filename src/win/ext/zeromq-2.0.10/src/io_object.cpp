@@ -66,14 +66,14 @@ void zmq::io_object_t::reset_pollout (handle_t handle_)
     poller->reset_pollout (handle_);
 }
 
-void zmq::io_object_t::add_timer ()
+zmq::io_object_t::timer_handle_t zmq::io_object_t::add_timer (int timeout_)
 {
-    poller->add_timer (this);
+    return poller->add_timer (timeout_, this);
 }
 
-void zmq::io_object_t::cancel_timer ()
+void zmq::io_object_t::cancel_timer (timer_handle_t handle_)
 {
-    poller->cancel_timer (this);
+    poller->cancel_timer (handle_);
 }
 
 void zmq::io_object_t::in_event ()
@@ -43,6 +43,7 @@ namespace zmq
     protected:
 
         typedef poller_t::handle_t handle_t;
+        typedef poller_t::timer_handle_t timer_handle_t;
 
         //  Derived class can init/swap the underlying I/O thread.
         //  Caution: Remove all the file descriptors from the old I/O thread
@@ -56,8 +57,8 @@ namespace zmq
         void reset_pollin (handle_t handle_);
         void set_pollout (handle_t handle_);
         void reset_pollout (handle_t handle_);
-        void add_timer ();
-        void cancel_timer ();
+        timer_handle_t add_timer (int timeout_);
+        void cancel_timer (timer_handle_t handle_);
 
         //  i_poll_events interface implementation.
         void in_event ();
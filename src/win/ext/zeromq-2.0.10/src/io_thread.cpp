@@ -33,8 +33,8 @@ zmq::io_thread_t::io_thread_t (ctx_t *ctx_,
     poller = new (std::nothrow) poller_t;
     zmq_assert (poller);
 
-    signaler_handle = poller->add_fd (signaler.get_fd (), this);
-    poller->set_pollin (signaler_handle);
+    mailbox_handle = poller->add_fd (mailbox.get_fd (), this);
+    poller->set_pollin (mailbox_handle);
 }
 
 zmq::io_thread_t::~io_thread_t ()
@@ -53,9 +53,9 @@ void zmq::io_thread_t::stop ()
     send_stop ();
 }
 
-zmq::signaler_t *zmq::io_thread_t::get_signaler ()
+zmq::mailbox_t *zmq::io_thread_t::get_mailbox ()
 {
-    return &signaler;
+    return &mailbox;
 }
 
 int zmq::io_thread_t::get_load ()
@@ -72,7 +72,7 @@ void zmq::io_thread_t::in_event ()
 
         //  Get the next command. If there is none, exit.
         command_t cmd;
-        if (!signaler.recv (&cmd, false))
+        if (!mailbox.recv (&cmd, false))
             break;
 
         //  Process the command.
@@ -100,6 +100,6 @@ zmq::poller_t *zmq::io_thread_t::get_poller ()
 
 void zmq::io_thread_t::process_stop ()
 {
-    poller->rm_fd (signaler_handle);
+    poller->rm_fd (mailbox_handle);
     poller->stop ();
 }
@@ -0,0 +1,462 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "io_uring.hpp"
+
+#ifdef ZMQ_HAVE_IO_URING
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <new>
+
+#include "err.hpp"
+#include "config.hpp"
+#include "i_poll_events.hpp"
+
+//  Completions that carry no poll entry.
+#define ZMQ_IO_URING_IGNORE 0
+#define ZMQ_IO_URING_TIMEOUT 1
+
+zmq::io_uring_t::io_uring_t () :
+    fallback (NULL),
+    ring_fd (retired_fd),
+    sq_ring (MAP_FAILED),
+    cq_ring (MAP_FAILED),
+    sqes ((struct io_uring_sqe*) MAP_FAILED),
+    sq_local_tail (0),
+    to_submit (0),
+    poll32 (false),
+    timeout_armed (false),
+    stopping (false)
+{
+    if (!setup ()) {
+        fallback = new (std::nothrow) epoll_t;
+        zmq_assert (fallback);
+    }
+}
+
+zmq::io_uring_t::~io_uring_t ()
+{
+    if (fallback) {
+        delete fallback;
+        return;
+    }
+
+    //  Wait till the worker thread exits.
+    worker.stop ();
+
+    //  Make sure there are no fds registered on shutdown.
+    zmq_assert (load.get () == 0);
+
+    //  Closing the ring cancels whatever requests are still in flight.
+    close (ring_fd);
+    munmap (sqes, sqes_size);
+    if (cq_ring != sq_ring)
+        munmap (cq_ring, cq_ring_size);
+    munmap (sq_ring, sq_ring_size);
+    for (retired_t::iterator it = retired.begin (); it != retired.end (); it ++)
+        delete *it;
+}
+
+bool zmq::io_uring_t::setup ()
+{
+    struct io_uring_params params;
+    memset (&params, 0, sizeof (params));
+    int fd = syscall (__NR_io_uring_setup, max_io_events, &params);
+    if (fd == -1)
+        return false;
+
+    //  Without NODROP, completions that don't fit the completion queue are
+    //  lost, and with them the poll requests. Old kernels get epoll.
+    if (!(params.features & IORING_FEAT_NODROP)) {
+        close (fd);
+        return false;
+    }
+
+    ring_fd = fd;
+    poll32 = params.features & IORING_FEAT_POLL_32BITS;
+    sq_entries = params.sq_entries;
+
+    sq_ring_size = params.sq_off.array + params.sq_entries *
+        sizeof (unsigned int);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries *
+        sizeof (struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        sq_ring_size = cq_ring_size = std::max (sq_ring_size, cq_ring_size);
+
+    sq_ring = mmap (NULL, sq_ring_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    errno_assert (sq_ring != MAP_FAILED);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        cq_ring = sq_ring;
+    else {
+        cq_ring = mmap (NULL, cq_ring_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        errno_assert (cq_ring != MAP_FAILED);
+    }
+    sqes_size = params.sq_entries * sizeof (struct io_uring_sqe);
+    sqes = (struct io_uring_sqe*) mmap (NULL, sqes_size,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+        IORING_OFF_SQES);
+    errno_assert (sqes != MAP_FAILED);
+
+    char *sq = (char*) sq_ring;
+    sq_head = (unsigned int*) (sq + params.sq_off.head);
+    sq_tail = (unsigned int*) (sq + params.sq_off.tail);
+    sq_mask = (unsigned int*) (sq + params.sq_off.ring_mask);
+    sq_array = (unsigned int*) (sq + params.sq_off.array);
+    char *cq = (char*) cq_ring;
+    cq_head = (unsigned int*) (cq + params.cq_off.head);
+    cq_tail = (unsigned int*) (cq + params.cq_off.tail);
+    cq_mask = (unsigned int*) (cq + params.cq_off.ring_mask);
+    cqes = (struct io_uring_cqe*) (cq + params.cq_off.cqes);
+
+    sq_local_tail = *sq_tail;
+    return true;
+}
+
+zmq::io_uring_t::handle_t zmq::io_uring_t::add_fd (fd_t fd_,
+    i_poll_events *events_)
+{
+    if (fallback)
+        return fallback->add_fd (fd_, events_);
+
+    poll_entry_t *pe = new (std::nothrow) poll_entry_t;
+    zmq_assert (pe != NULL);
+    pe->fd = fd_;
+    pe->desired = 0;
+    pe->armed = 0;
+    pe->cancelling = false;
+    pe->events = events_;
+
+    //  Increase the load metric of the thread.
+    load.add (1);
+
+    return pe;
+}
+
+void zmq::io_uring_t::rm_fd (handle_t handle_)
+{
+    if (fallback) {
+        fallback->rm_fd (handle_);
+        return;
+    }
+
+    poll_entry_t *pe = (poll_entry_t*) handle_;
+    pe->fd = retired_fd;
+    pe->desired = 0;
+    update (pe);
+    retired.push_back (pe);
+
+    //  Decrease the load metric of the thread.
+    load.sub (1);
+}
+
+void zmq::io_uring_t::set_pollin (handle_t handle_)
+{
+    if (fallback) {
+        fallback->set_pollin (handle_);
+        return;
+    }
+
+    poll_entry_t *pe = (poll_entry_t*) handle_;
+    pe->desired |= POLLIN;
+    update (pe);
+}
+
+void zmq::io_uring_t::reset_pollin (handle_t handle_)
+{
+    if (fallback) {
+        fallback->reset_pollin (handle_);
+        return;
+    }
+
+    poll_entry_t *pe = (poll_entry_t*) handle_;
+    pe->desired &= ~POLLIN;
+    update (pe);
+}
+
+void zmq::io_uring_t::set_pollout (handle_t handle_)
+{
+    if (fallback) {
+        fallback->set_pollout (handle_);
+        return;
+    }
+
+    poll_entry_t *pe = (poll_entry_t*) handle_;
+    pe->desired |= POLLOUT;
+    update (pe);
+}
+
+void zmq::io_uring_t::reset_pollout (handle_t handle_)
+{
+    if (fallback) {
+        fallback->reset_pollout (handle_);
+        return;
+    }
+
+    poll_entry_t *pe = (poll_entry_t*) handle_;
+    pe->desired &= ~POLLOUT;
+    update (pe);
+}
+
+zmq::io_uring_t::timer_handle_t zmq::io_uring_t::add_timer (int timeout_,
+    i_poll_events *sink_)
+{
+    if (fallback)
+        return fallback->add_timer (timeout_, sink_);
+
+    return poller_base_t::add_timer (timeout_, sink_);
+}
+
+void zmq::io_uring_t::cancel_timer (timer_handle_t handle_)
+{
+    if (fallback) {
+        fallback->cancel_timer (handle_);
+        return;
+    }
+
+    poller_base_t::cancel_timer (handle_);
+}
+
+int zmq::io_uring_t::get_load ()
+{
+    if (fallback)
+        return fallback->get_load ();
+
+    return load.get ();
+}
+
+void zmq::io_uring_t::start ()
+{
+    if (fallback) {
+        fallback->start ();
+        return;
+    }
+
+    worker.start (worker_routine, this);
+}
+
+void zmq::io_uring_t::stop ()
+{
+    if (fallback) {
+        fallback->stop ();
+        return;
+    }
+
+    stopping = true;
+}
+
+void zmq::io_uring_t::update (poll_entry_t *pe_)
+{
+    //  A request for events we no longer want is left to complete; its
+    //  events are filtered out then. A request that misses some of the
+    //  events we want has to be removed and re-armed.
+    if (pe_->armed) {
+        if ((pe_->desired & ~pe_->armed) || pe_->fd == retired_fd) {
+            if (!pe_->cancelling) {
+                struct io_uring_sqe *sqe = get_sqe ();
+                sqe->opcode = IORING_OP_POLL_REMOVE;
+                sqe->fd = -1;
+                sqe->addr = (unsigned long) pe_;
+                sqe->user_data = ZMQ_IO_URING_IGNORE;
+                pe_->cancelling = true;
+            }
+        }
+        return;
+    }
+
+    if (!pe_->desired || pe_->fd == retired_fd)
+        return;
+
+    struct io_uring_sqe *sqe = get_sqe ();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = pe_->fd;
+    if (poll32)
+        sqe->poll32_events = pe_->desired;
+    else
+        sqe->poll_events = pe_->desired;
+    sqe->user_data = (unsigned long) pe_;
+    pe_->armed = pe_->desired;
+}
+
+struct io_uring_sqe *zmq::io_uring_t::get_sqe ()
+{
+    unsigned int head = __atomic_load_n (sq_head, __ATOMIC_ACQUIRE);
+    while (sq_local_tail - head == sq_entries) {
+
+        //  While completions it couldn't post are pending, the kernel
+        //  refuses submissions with EBUSY. Clear the completion queue so
+        //  that it can flush them. Handling the completions has to wait for
+        //  the loop; we may be inside an event handler here.
+        if (!enter (false))
+            reap ();
+        head = __atomic_load_n (sq_head, __ATOMIC_ACQUIRE);
+    }
+
+    unsigned int index = sq_local_tail & *sq_mask;
+    struct io_uring_sqe *sqe = &sqes [index];
+    memset (sqe, 0, sizeof (struct io_uring_sqe));
+    sq_array [index] = index;
+    sq_local_tail++;
+    to_submit++;
+    return sqe;
+}
+
+bool zmq::io_uring_t::enter (bool wait_)
+{
+    //  Publish the queued submissions.
+    __atomic_store_n (sq_tail, sq_local_tail, __ATOMIC_RELEASE);
+
+    while (true) {
+        int rc = syscall (__NR_io_uring_enter, ring_fd, to_submit,
+            wait_ ? 1 : 0, wait_ ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (rc >= 0) {
+            to_submit -= rc;
+            if (!to_submit)
+                return true;
+            continue;
+        }
+        if (errno == EINTR)
+            continue;
+
+        //  Completions overflowed; the caller has to reap some before
+        //  anything more can be submitted.
+        if (errno == EBUSY || errno == EAGAIN)
+            return false;
+        errno_assert (false);
+    }
+}
+
+void zmq::io_uring_t::reap ()
+{
+    unsigned int head = *cq_head;
+    unsigned int tail = __atomic_load_n (cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        reaped.push_back (cqes [head & *cq_mask]);
+        head++;
+    }
+    __atomic_store_n (cq_head, head, __ATOMIC_RELEASE);
+}
+
+void zmq::io_uring_t::complete (const struct io_uring_cqe &cqe_)
+{
+    if (cqe_.user_data == ZMQ_IO_URING_IGNORE)
+        return;
+
+    if (cqe_.user_data == ZMQ_IO_URING_TIMEOUT) {
+        timeout_armed = false;
+        return;
+    }
+
+    poll_entry_t *pe = (poll_entry_t*) cqe_.user_data;
+    pe->armed = 0;
+    pe->cancelling = false;
+
+    if (pe->fd == retired_fd)
+        return;
+
+    //  Removed requests complete with an error, fired ones with the events.
+    int revents = cqe_.res > 0 ? cqe_.res : 0;
+
+    if (revents & (POLLERR | POLLHUP))
+        pe->events->in_event ();
+    if (pe->fd == retired_fd)
+        return;
+    if ((revents & POLLOUT) && (pe->desired & POLLOUT))
+        pe->events->out_event ();
+    if (pe->fd == retired_fd)
+        return;
+    if ((revents & POLLIN) && (pe->desired & POLLIN))
+        pe->events->in_event ();
+
+    //  Poll requests are single-shot. Re-arm unless an event handler did so.
+    if (pe->fd != retired_fd)
+        update (pe);
+}
+
+void zmq::io_uring_t::loop ()
+{
+    //  After the stop, keep going till the removals of the last retired
+    //  entries complete. Until then the kernel holds on to their sockets,
+    //  so a listening socket would still occupy its port.
+    while (!stopping || !retired.empty ()) {
+
+        //  Fire the due timers and find out how long we can wait.
+        int wait = execute_timers ();
+
+        //  Wake up when the next timer is due. With 'off' set to one the
+        //  timeout request also completes as soon as any other request does,
+        //  so the one armed before never outlives the iteration it was meant
+        //  for and a timer added since is accounted for on the next one.
+        //  With 'off' zero it would be a plain timer and an earlier timer
+        //  added meanwhile would fire late.
+        if (!stopping && wait != -1 && !timeout_armed) {
+            timeout.tv_sec = wait / 1000;
+            timeout.tv_nsec = (wait % 1000) * 1000000;
+            struct io_uring_sqe *sqe = get_sqe ();
+            sqe->opcode = IORING_OP_TIMEOUT;
+            sqe->fd = -1;
+            sqe->off = 1;
+            sqe->addr = (unsigned long) &timeout;
+            sqe->len = 1;
+            sqe->user_data = ZMQ_IO_URING_TIMEOUT;
+            timeout_armed = true;
+        }
+
+        //  Submit the interest changes made while processing the previous
+        //  batch and wait for events, all in one system call.
+        enter (true);
+
+        //  Handlers may submit and so reap more; those are handled in the
+        //  next round.
+        reap ();
+        while (!reaped.empty ()) {
+            batch.swap (reaped);
+            for (cqes_t::iterator it = batch.begin (); it != batch.end ();
+                  it ++)
+                complete (*it);
+            batch.clear ();
+        }
+
+        //  Destroy retired event sources. Those the kernel still holds a poll
+        //  request for have to wait for its completion.
+        retired_t pending;
+        for (retired_t::iterator it = retired.begin (); it != retired.end ();
+              it ++) {
+            if ((*it)->armed)
+                pending.push_back (*it);
+            else
+                delete *it;
+        }
+        retired.swap (pending);
+    }
+}
+
+void zmq::io_uring_t::worker_routine (void *arg_)
+{
+    ((io_uring_t*) arg_)->loop ();
+}
+
+#endif
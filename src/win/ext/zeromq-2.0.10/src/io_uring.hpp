@@ -0,0 +1,193 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __ZMQ_IO_URING_HPP_INCLUDED__
+#define __ZMQ_IO_URING_HPP_INCLUDED__
+
+#include "platform.hpp"
+
+//  The poller relies on NODROP (5.5), __kernel_timespec (5.6) and the 32-bit
+//  poll mask (5.9); headers older than that get epoll.
+#if defined ZMQ_HAVE_LINUX && defined __has_include
+#if __has_include (<linux/io_uring.h>) && __has_include (<linux/time_types.h>)
+#include <linux/io_uring.h>
+#if defined IORING_FEAT_NODROP && defined IORING_FEAT_POLL_32BITS
+#define ZMQ_HAVE_IO_URING
+#endif
+#endif
+#endif
+
+#ifdef ZMQ_HAVE_IO_URING
+
+#include <vector>
+#include <linux/time_types.h>
+
+#include "fd.hpp"
+#include "thread.hpp"
+#include "atomic_counter.hpp"
+#include "poller_base.hpp"
+#include "epoll.hpp"
+
+namespace zmq
+{
+
+    //  This class implements socket polling mechanism using Linux io_uring.
+    //  Interest changes are queued as submissions and handed to the kernel
+    //  together with the wait, so the set/reset_poll* calls made while
+    //  handling a batch of events cost no system calls of their own. If the
+    //  kernel doesn't support io_uring (or it is disabled), the work is
+    //  delegated to epoll_t.
+
+    class io_uring_t : public poller_base_t
+    {
+    public:
+
+        typedef void* handle_t;
+
+        io_uring_t ();
+        ~io_uring_t ();
+
+        //  "poller" concept.
+        handle_t add_fd (fd_t fd_, struct i_poll_events *events_);
+        void rm_fd (handle_t handle_);
+        void set_pollin (handle_t handle_);
+        void reset_pollin (handle_t handle_);
+        void set_pollout (handle_t handle_);
+        void reset_pollout (handle_t handle_);
+        timer_handle_t add_timer (int timeout_, struct i_poll_events *sink_);
+        void cancel_timer (timer_handle_t handle_);
+        int get_load ();
+        void start ();
+        void stop ();
+
+    private:
+
+        //  Main worker thread routine.
+        static void worker_routine (void *arg_);
+
+        //  Main event loop.
+        void loop ();
+
+        struct poll_entry_t
+        {
+            fd_t fd;
+
+            //  Events the owner wants to be notified about.
+            unsigned int desired;
+
+            //  Events of the poll request the kernel holds at the moment,
+            //  zero if there is none. The entry cannot be deallocated before
+            //  that request completes.
+            unsigned int armed;
+
+            //  True if removal of the armed request was requested already.
+            bool cancelling;
+
+            struct i_poll_events *events;
+        };
+
+        //  Brings the armed poll request in line with the desired events.
+        void update (poll_entry_t *pe_);
+
+        //  Returns a free submission queue entry, submitting the queued ones
+        //  first if the queue is full.
+        struct io_uring_sqe *get_sqe ();
+
+        //  Hands queued submissions to the kernel. If 'wait' is true, blocks
+        //  till there's at least one completion. Returns false if the kernel
+        //  refused them because completions are backed up.
+        bool enter (bool wait_);
+
+        //  Moves the posted completions off the completion queue, to be
+        //  handled by the loop.
+        void reap ();
+
+        //  Handles a single completion.
+        void complete (const struct io_uring_cqe &cqe_);
+
+        //  Set up the rings. Returns false if io_uring is not available.
+        bool setup ();
+
+        //  Poller used if the kernel has no io_uring support.
+        epoll_t *fallback;
+
+        //  The io_uring file descriptor and the memory shared with kernel.
+        fd_t ring_fd;
+        void *sq_ring;
+        size_t sq_ring_size;
+        void *cq_ring;
+        size_t cq_ring_size;
+        struct io_uring_sqe *sqes;
+        size_t sqes_size;
+
+        //  Pointers into the shared rings.
+        unsigned int *sq_head;
+        unsigned int *sq_tail;
+        unsigned int *sq_mask;
+        unsigned int *sq_array;
+        unsigned int *cq_head;
+        unsigned int *cq_tail;
+        unsigned int *cq_mask;
+        struct io_uring_cqe *cqes;
+
+        //  Number of submission entries in the ring.
+        unsigned int sq_entries;
+
+        //  Local copy of the submission tail and the number of entries
+        //  queued since the last submission.
+        unsigned int sq_local_tail;
+        unsigned int to_submit;
+
+        //  True if the kernel reads the 32-bit poll event mask.
+        bool poll32;
+
+        //  Completions taken off the ring but not handled yet, and the ones
+        //  being handled. The two are swapped so that neither reallocates.
+        typedef std::vector <struct io_uring_cqe> cqes_t;
+        cqes_t reaped;
+        cqes_t batch;
+
+        //  Timeout request used to wake up the loop for the next timer.
+        struct __kernel_timespec timeout;
+        bool timeout_armed;
+
+        //  List of retired event sources.
+        typedef std::vector <poll_entry_t*> retired_t;
+        retired_t retired;
+
+        //  If true, thread is in the process of shutting down.
+        bool stopping;
+
+        //  Handle of the physical thread doing the I/O work.
+        thread_t worker;
+
+        //  Load of the poller. Currently number of file descriptors
+        //  registered with the poller.
+        atomic_counter_t load;
+
+        io_uring_t (const io_uring_t&);
+        void operator = (const io_uring_t&);
+    };
+
+}
+
+#endif
+
+#endif
@@ -27,7 +27,6 @@
 #include <sys/event.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include <algorithm>
 #include <new>
 
 #include "kqueue.hpp"
@@ -132,18 +131,6 @@ void zmq::kqueue_t::reset_pollout (handle_t handle_)
     kevent_delete (pe->fd, EVFILT_WRITE);
 }
 
-void zmq::kqueue_t::add_timer (i_poll_events *events_)
-{
-     timers.push_back (events_);
-}
-
-void zmq::kqueue_t::cancel_timer (i_poll_events *events_)
-{
-    timers_t::iterator it = std::find (timers.begin (), timers.end (), events_);
-    if (it != timers.end ())
-        timers.erase (it);
-}
-
 int zmq::kqueue_t::get_load ()
 {
     return load.get ();
@@ -165,32 +152,17 @@ void zmq::kqueue_t::loop ()
 
         struct kevent ev_buf [max_io_events];
 
-        //  Compute time interval to wait.
-        timespec timeout = {max_timer_period / 1000,
-            (max_timer_period % 1000) * 1000000};
+        //  Fire the due timers and compute time interval to wait.
+        int timeout = execute_timers ();
+        timespec ts = {timeout / 1000, (timeout % 1000) * 1000000};
 
         //  Wait for events.
         int n = kevent (kqueue_fd, NULL, 0,
-             &ev_buf [0], max_io_events, timers.empty () ? NULL : &timeout);
+             &ev_buf [0], max_io_events, timeout == -1 ? NULL : &ts);
         if (n == -1 && errno == EINTR)
             continue;
         errno_assert (n != -1);
 
-        //  Handle timer.
-        if (!n) {
-
-            //  Use local list of timers as timer handlers may fill new timers
-            //  into the original array.
-            timers_t t;
-            std::swap (timers, t);
-
-            //  Trigger all the timers.
-            for (timers_t::iterator it = t.begin (); it != t.end (); it ++)
-                (*it)->timer_event ();
-
-            continue;
-        }
-
         for (int i = 0; i < n; i ++) {
             poll_entry_t *pe = (poll_entry_t*) ev_buf [i].udata;
 
@@ -0,0 +1,133 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <new>
+
+#include "mailbox.hpp"
+#include "err.hpp"
+
+zmq::mailbox_t::mailbox_t () :
+    tail (&stub)
+{
+    stub.next.set (NULL);
+    head.set (&stub);
+    signaled.set (NULL);
+}
+
+zmq::mailbox_t::~mailbox_t ()
+{
+    //  Commands nobody is going to process anymore.
+    node_t *node;
+    while ((node = pop ()))
+        delete node;
+}
+
+zmq::fd_t zmq::mailbox_t::get_fd ()
+{
+    return signaler.get_fd ();
+}
+
+void zmq::mailbox_t::send (const command_t &cmd_)
+{
+    node_t *node = new (std::nothrow) node_t;
+    zmq_assert (node);
+    node->cmd = cmd_;
+    push (node);
+
+    //  Only the sender that finds the mailbox unsignaled wakes the receiver
+    //  up. Everybody else just leaves the command in the queue.
+    if (!signaled.cas (NULL, this))
+        signaler.signal ();
+}
+
+bool zmq::mailbox_t::recv (command_t *cmd_, bool block_)
+{
+    while (true) {
+
+        node_t *node = pop ();
+        if (node) {
+            *cmd_ = node->cmd;
+            delete node;
+            return true;
+        }
+
+        //  The queue looks empty. Take back the signal sent for the commands
+        //  processed so far so that the next sender signals anew, then check
+        //  once more for a command pushed in the meantime.
+        if (signaled.xchg (NULL))
+            signaler.wait ();
+        node = pop ();
+        if (node) {
+            *cmd_ = node->cmd;
+            delete node;
+            return true;
+        }
+
+        if (!block_)
+            return false;
+
+        //  Sleep till the next sender signals. It has marked the mailbox as
+        //  signaled already, so reset that to keep the two in step.
+        signaler.wait ();
+        signaled.xchg (NULL);
+    }
+}
+
+void zmq::mailbox_t::push (node_t *node_)
+{
+    node_->next.set (NULL);
+    node_t *prev = head.xchg (node_);
+    prev->next.xchg (node_);
+}
+
+zmq::mailbox_t::node_t *zmq::mailbox_t::pop ()
+{
+    //  The atomic pointer has no plain load; a compare-and-swap with NULL
+    //  on both sides reads the value with full ordering and never changes it.
+    node_t *node = tail;
+    node_t *next = node->next.cas (NULL, NULL);
+
+    if (node == &stub) {
+        if (!next)
+            return NULL;
+        tail = next;
+        node = next;
+        next = next->next.cas (NULL, NULL);
+    }
+
+    if (next) {
+        tail = next;
+        return node;
+    }
+
+    //  Either a sender is linking a new node in right now, or 'node' is the
+    //  last one. In the latter case put the stub behind it so that it can
+    //  be handed out.
+    if (node != head.cas (NULL, NULL))
+        return NULL;
+    push (&stub);
+    next = node->next.cas (NULL, NULL);
+    if (next) {
+        tail = next;
+        return node;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,103 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __ZMQ_MAILBOX_HPP_INCLUDED__
+#define __ZMQ_MAILBOX_HPP_INCLUDED__
+
+#include <stddef.h>
+
+#include "platform.hpp"
+#include "fd.hpp"
+#include "command.hpp"
+#include "signaler.hpp"
+#include "atomic_ptr.hpp"
+
+namespace zmq
+{
+
+    //  Mailbox delivers commands to a single thread. Any number of threads
+    //  may send to it at the same time; a send is a lock-free push onto an
+    //  intrusive queue (D. Vyukov's MPSC node queue). The file descriptor is
+    //  signaled only on the empty to non-empty transition, so as long as the
+    //  receiving thread keeps up no system calls are made on either side.
+
+    class mailbox_t
+    {
+    public:
+
+        mailbox_t ();
+        ~mailbox_t ();
+
+        //  The file descriptor becomes readable when there are commands
+        //  the receiving thread hasn't picked up yet.
+        fd_t get_fd ();
+
+        //  Can be called from any thread.
+        void send (const command_t &cmd_);
+
+        //  Can be called only from the receiving thread. Returns false if
+        //  there's no command and 'block' is false.
+        bool recv (command_t *cmd_, bool block_);
+
+        //  Returns true if there may be commands waiting. It costs a single
+        //  load, so it can be checked on every call into the API. A command
+        //  that is being sent right now may be missed; it will be seen on
+        //  the next check, or its signal will wake the thread up.
+        inline bool pending ()
+        {
+            return signaled.get () != NULL;
+        }
+
+    private:
+
+        struct node_t
+        {
+            atomic_ptr_t <node_t> next;
+            command_t cmd;
+        };
+
+        void push (node_t *node_);
+
+        //  Returns NULL if the queue is empty, or if a sender is half way
+        //  through a push. In the latter case the sender signals afterwards.
+        node_t *pop ();
+
+        //  Most recently pushed node. Shared by the senders.
+        atomic_ptr_t <node_t> head;
+
+        //  Oldest node not received yet. Accessed by receiving thread only.
+        node_t *tail;
+
+        //  Placeholder that keeps the queue from ever becoming truly empty.
+        node_t stub;
+
+        //  Points to the mailbox itself while the file descriptor holds
+        //  a signal, NULL when the next sender has to signal.
+        atomic_ptr_t <mailbox_t> signaled;
+
+        signaler_t signaler;
+
+        mailbox_t (const mailbox_t&);
+        void operator = (const mailbox_t&);
+    };
+
+}
+
+#endif
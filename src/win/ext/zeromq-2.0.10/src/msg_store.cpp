@@ -125,8 +125,8 @@ bool zmq::msg_store_t::store (zmq_msg_t *msg_)
     if (buffer_space () <= (int64_t) (sizeof msg_size + 1 + msg_size))
         return false;
 
-    //  Don't store the ZMQ_MSG_SHARED flag.
-    uint8_t msg_flags = msg_->flags & ~ZMQ_MSG_SHARED;
+    //  Don't store the ZMQ_MSG_SHARED and ZMQ_MSG_SLAB flags.
+    uint8_t msg_flags = msg_->flags & ~(ZMQ_MSG_SHARED | ZMQ_MSG_SLAB);
 
     //  Write message length, flags, and message body.
     copy_to_file (&msg_size, sizeof msg_size);
@@ -155,11 +155,14 @@ void zmq::msg_store_t::fetch (zmq_msg_t *msg_)
 
     //  Retrieve the message payload.
     copy_from_file (zmq_msg_data (msg_), msg_size);
+
+    bytes_used.set ((commit_pos - read_pos + filesize) % filesize);
 }
 
 void zmq::msg_store_t::commit ()
 {
     commit_pos = write_pos;
+    bytes_used.set ((commit_pos - read_pos + filesize) % filesize);
 }
 
 void zmq::msg_store_t::rollback ()
@@ -188,6 +191,11 @@ bool zmq::msg_store_t::empty ()
     return read_pos == write_pos;
 }
 
+uint64_t zmq::msg_store_t::used ()
+{
+    return bytes_used.get ();
+}
+
 bool zmq::msg_store_t::full ()
 {
     return buffer_space () == 1;
@@ -24,6 +24,7 @@
 
 #include <string>
 #include "stdint.hpp"
+#include "stats.hpp"
 
 namespace zmq
 {
@@ -62,6 +63,10 @@ namespace zmq
         //  Returns true if and only if the store is full.
         bool full ();
 
+        //  Returns number of bytes of committed messages in the store.
+        //  Unlike the rest of the interface it can be called from any thread.
+        uint64_t used ();
+
     private:
 
         //  Copies data from a memory buffer to the backing file.
@@ -107,6 +112,9 @@ namespace zmq
         char *write_buf;
 
         int64_t write_buf_start_addr;
+
+        //  Snapshot of the store usage, updated on commit and fetch.
+        stat_counter_t bytes_used;
     };
 
 }
@@ -36,9 +36,9 @@ zmq::pair_t::pair_t (class app_thread_t *parent_) :
 zmq::pair_t::~pair_t ()
 {
     if (inpipe)
-        inpipe->term ();
+        term_pipe (inpipe);
     if (outpipe)
-        outpipe->term ();
+        term_pipe (outpipe);
 }
 
 void zmq::pair_t::xattach_pipes (class reader_t *inpipe_,
@@ -26,7 +26,6 @@ zmq::reader_t::reader_t (object_t *parent_, uint64_t lwm_) :
     pipe (NULL),
     peer (NULL),
     lwm (lwm_),
-    msgs_read (0),
     endpoint (NULL)
 {}
 
@@ -89,10 +88,11 @@ bool zmq::reader_t::read (zmq_msg_t *msg_)
     }
 
     if (!(msg_->flags & ZMQ_MSG_MORE))
-        msgs_read++;
+        msgs_read.add (1);
 
-    if (lwm > 0 && msgs_read % lwm == 0)
-        send_reader_info (peer, msgs_read);
+    uint64_t read = msgs_read.get ();
+    if (lwm > 0 && read % lwm == 0)
+        send_reader_info (peer, read);
 
     return true;
 }
@@ -108,6 +108,20 @@ void zmq::reader_t::term ()
     send_pipe_term (peer);
 }
 
+uint64_t zmq::reader_t::get_queued ()
+{
+    //  The writer is part of the same pipe object so it cannot go away
+    //  while the reader is alive.
+    uint64_t written = pipe->writer.msgs_written.get ();
+    uint64_t read = msgs_read.get ();
+    return written > read ? written - read : 0;
+}
+
+uint64_t zmq::reader_t::get_swapped ()
+{
+    return pipe->writer.get_swapped ();
+}
+
 void zmq::reader_t::process_revive ()
 {
     //  Beacuse of command throttling mechanism, incoming termination request
@@ -130,7 +144,6 @@ zmq::writer_t::writer_t (object_t *parent_,
     peer (NULL),
     hwm (hwm_),
     msgs_read (0),
-    msgs_written (0),
     msg_store (NULL),
     extra_msg_flag (false),
     stalled (false),
@@ -195,7 +208,7 @@ bool zmq::writer_t::write (zmq_msg_t *msg_)
     else {
         pipe->write (*msg_, msg_->flags & ZMQ_MSG_MORE);
         if (!(msg_->flags & ZMQ_MSG_MORE))
-            msgs_written++;
+            msgs_written.add (1);
     }
 
     return true;
@@ -268,14 +281,14 @@ void zmq::writer_t::process_reader_info (uint64_t msgs_read_)
             //  Write message into the pipe.
             pipe->write (msg, msg.flags & ZMQ_MSG_MORE);
             if (!(msg.flags & ZMQ_MSG_MORE))
-                msgs_written++;
+                msgs_written.add (1);
         }
 
         if (extra_msg_flag) {
             if (!pipe_full ()) {
                 pipe->write (extra_msg, extra_msg.flags & ZMQ_MSG_MORE);
                 if (!(extra_msg.flags & ZMQ_MSG_MORE))
-                    msgs_written++;
+                    msgs_written.add (1);
                 extra_msg_flag = false;
             }
             else if (msg_store->store (&extra_msg)) {
@@ -309,9 +322,23 @@ void zmq::writer_t::process_pipe_term ()
     send_pipe_term_ack (p);
 }
 
+uint64_t zmq::writer_t::get_queued ()
+{
+    //  The pipe is not deallocated before the writer is detached from
+    //  its endpoint, so the reader is still there.
+    uint64_t written = msgs_written.get ();
+    uint64_t read = pipe->reader.msgs_read.get ();
+    return written > read ? written - read : 0;
+}
+
+uint64_t zmq::writer_t::get_swapped ()
+{
+    return msg_store ? msg_store->used () : 0;
+}
+
 bool zmq::writer_t::pipe_full ()
 {
-    return hwm > 0 && msgs_written - msgs_read == hwm;
+    return hwm > 0 && msgs_written.get () - msgs_read == hwm;
 }
 
 zmq::pipe_t::pipe_t (object_t *reader_parent_, object_t *writer_parent_,
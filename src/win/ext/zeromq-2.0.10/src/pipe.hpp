@@ -29,6 +29,7 @@
 #include "msg_store.hpp"
 #include "config.hpp"
 #include "object.hpp"
+#include "stats.hpp"
 
 namespace zmq
 {
@@ -52,6 +53,12 @@ namespace zmq
         //  Ask pipe to terminate.
         void term ();
 
+        //  Number of messages waiting in the pipe and bytes of them
+        //  swapped to disk by the writer. The writer may be running in
+        //  a different thread so the values are approximate.
+        uint64_t get_queued ();
+        uint64_t get_swapped ();
+
     private:
 
         //  Command handlers.
@@ -70,14 +77,17 @@ namespace zmq
         //  Low watermark for in-memory storage (in bytes).
         uint64_t lwm;
 
-        //  Number of messages read so far.
-        uint64_t msgs_read;
+        //  Number of messages read so far. The writer peeks at it when
+        //  reporting the length of the queue.
+        stat_counter_t msgs_read;
 
         //  Endpoint (either session or socket) the pipe is attached to.
         i_endpoint *endpoint;
 
         reader_t (const reader_t&);
         void operator = (const reader_t&);
+
+        friend class writer_t;
     };
 
     class writer_t : public object_t, public yarray_item_t
@@ -108,6 +118,12 @@ namespace zmq
         //  Ask pipe to terminate.
         void term ();
 
+        //  Number of messages waiting in the pipe and bytes of them
+        //  swapped to disk. The reader may be running in a different
+        //  thread so the values are approximate.
+        uint64_t get_queued ();
+        uint64_t get_swapped ();
+
     private:
 
         void process_reader_info (uint64_t msgs_read_);
@@ -135,8 +151,9 @@ namespace zmq
         //  The actual number can be higher.
         uint64_t msgs_read;
 
-        //  Number of messages we have written so far.
-        uint64_t msgs_written;
+        //  Number of messages we have written so far. The reader peeks
+        //  at it when reporting the length of the queue.
+        stat_counter_t msgs_written;
 
         //  Pointer to backing store. If NULL, messages are always
         //  kept in main memory.
@@ -156,6 +173,8 @@ namespace zmq
 
         writer_t (const writer_t&);
         void operator = (const writer_t&);
+
+        friend class reader_t;
     };
 
     //  Message pipe.
@@ -29,7 +29,6 @@
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <poll.h>
-#include <algorithm>
 
 #include "poll.hpp"
 #include "err.hpp"
@@ -112,18 +111,6 @@ void zmq::poll_t::reset_pollout (handle_t handle_)
     pollset [index].events &= ~((short) POLLOUT);
 }
 
-void zmq::poll_t::add_timer (i_poll_events *events_)
-{
-     timers.push_back (events_);
-}
-
-void zmq::poll_t::cancel_timer (i_poll_events *events_)
-{
-    timers_t::iterator it = std::find (timers.begin (), timers.end (), events_);
-    if (it != timers.end ())
-        timers.erase (it);
-}
-
 int zmq::poll_t::get_load ()
 {
     return load.get ();
@@ -143,28 +130,15 @@ void zmq::poll_t::loop ()
 {
     while (!stopping) {
 
+        //  Fire the due timers and find out how long we can wait.
+        int timeout = execute_timers ();
+
         //  Wait for events.
-        int rc = poll (&pollset [0], pollset.size (),
-            timers.empty () ? -1 : max_timer_period);
+        int rc = poll (&pollset [0], pollset.size (), timeout);
         if (rc == -1 && errno == EINTR)
             continue;
         errno_assert (rc != -1);
 
-        //  Handle timer.
-        if (!rc) {
-
-            //  Use local list of timers as timer handlers may fill new timers
-            //  into the original array.
-            timers_t t;
-            std::swap (timers, t);
-
-            //  Trigger all the timers.
-            for (timers_t::iterator it = t.begin (); it != t.end (); it ++)
-                (*it)->timer_event ();
-
-            continue;
-        }
-
         for (pollset_t::size_type i = 0; i != pollset.size (); i++) {
 
             zmq_assert (!(pollset [i].revents & POLLNVAL));
@@ -35,6 +35,7 @@
 #include "fd.hpp"
 #include "thread.hpp"
 #include "atomic_counter.hpp"
+#include "poller_base.hpp"
 
 namespace zmq
 {
@@ -42,7 +43,7 @@ namespace zmq
     //  Implements socket polling mechanism using the POSIX.1-2001
     //  poll() system call.
 
-    class poll_t
+    class poll_t : public poller_base_t
     {
     public:
 
@@ -58,8 +59,6 @@ namespace zmq
         void reset_pollin (handle_t handle_);
         void set_pollout (handle_t handle_);
         void reset_pollout (handle_t handle_);
-        void add_timer (struct i_poll_events *events_);
-        void cancel_timer (struct i_poll_events *events_);
         int get_load ();
         void start ();
         void stop ();
@@ -88,10 +87,6 @@ namespace zmq
         //  If true, there's at least one retired event source.
         bool retired;
 
-        //  List of all the engines waiting for the timer event.
-        typedef std::vector <struct i_poll_events*> timers_t;
-        timers_t timers;
-
         //  If true, thread is in the process of shutting down.
         bool stopping;
 
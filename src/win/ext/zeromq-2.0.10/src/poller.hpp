@@ -21,6 +21,7 @@
 #define __ZMQ_POLLER_HPP_INCLUDED__
 
 #include "epoll.hpp"
+#include "io_uring.hpp"
 #include "poll.hpp"
 #include "select.hpp"
 #include "devpoll.hpp"
@@ -39,6 +40,8 @@ namespace zmq
     typedef devpoll_t poller_t;
 #elif defined ZMQ_FORCE_KQUEUE
     typedef kqueue_t poller_t;
+#elif defined ZMQ_HAVE_IO_URING
+    typedef io_uring_t poller_t;
 #elif defined ZMQ_HAVE_LINUX
     typedef epoll_t poller_t;
 #elif defined ZMQ_HAVE_WINDOWS
@@ -0,0 +1,170 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "platform.hpp"
+
+#ifdef ZMQ_HAVE_WINDOWS
+#include "windows.hpp"
+#else
+#include <time.h>
+#include <sys/time.h>
+#endif
+
+#include <new>
+
+#include "poller_base.hpp"
+#include "i_poll_events.hpp"
+#include "err.hpp"
+
+zmq::poller_base_t::poller_base_t () :
+    count (0)
+{
+    for (int i = 0; i != wheel_slots; i++)
+        wheel [i].prev = wheel [i].next = &wheel [i];
+    due.prev = due.next = &due;
+    current = now_ms ();
+}
+
+zmq::poller_base_t::~poller_base_t ()
+{
+    for (int i = 0; i != wheel_slots; i++)
+        while (wheel [i].next != &wheel [i]) {
+            timer_entry_t *timer = wheel [i].next;
+            unlink (timer);
+            delete timer;
+        }
+}
+
+zmq::poller_base_t::timer_handle_t zmq::poller_base_t::add_timer (
+    int timeout_, i_poll_events *sink_)
+{
+    timer_entry_t *timer = new (std::nothrow) timer_entry_t;
+    zmq_assert (timer);
+    timer->deadline = now_ms () + timeout_;
+    timer->sink = sink_;
+
+    //  A deadline at or before the last processed tick would never be
+    //  visited again. Such timers go to the slot processed next.
+    uint64_t tick = timer->deadline > current ? timer->deadline : current + 1;
+    link (&wheel [tick & (wheel_slots - 1)], timer);
+    count++;
+
+    return timer;
+}
+
+void zmq::poller_base_t::cancel_timer (timer_handle_t handle_)
+{
+    timer_entry_t *timer = (timer_entry_t*) handle_;
+    unlink (timer);
+    delete timer;
+    count--;
+}
+
+int zmq::poller_base_t::execute_timers ()
+{
+    uint64_t now = now_ms ();
+
+    //  Visit the slots of all the ticks that elapsed since the last call.
+    //  If the wheel went round completely, each slot is visited once.
+    if (count) {
+        uint64_t ticks = now - current;
+        if (ticks > wheel_slots)
+            ticks = wheel_slots;
+        for (uint64_t tick = current + 1; tick <= current + ticks; tick++)
+            collect (tick, now);
+    }
+    current = now;
+
+    //  Fire the due timers. Handlers may add new timers or cancel the
+    //  ones still waiting in the 'due' list.
+    while (due.next != &due) {
+        timer_entry_t *timer = due.next;
+        i_poll_events *sink = timer->sink;
+        unlink (timer);
+        delete timer;
+        count--;
+        sink->timer_event ();
+    }
+
+    if (!count)
+        return -1;
+
+    //  Find the first tick that has a timer due within this revolution.
+    for (int i = 1; i <= wheel_slots; i++) {
+        timer_entry_t *slot = &wheel [(current + i) & (wheel_slots - 1)];
+        for (timer_entry_t *timer = slot->next; timer != slot;
+              timer = timer->next)
+            if (timer->deadline <= current + i)
+                return i;
+    }
+
+    //  All the timers are more than one revolution away. Check again
+    //  after a full revolution.
+    return wheel_slots;
+}
+
+void zmq::poller_base_t::collect (uint64_t tick_, uint64_t now_)
+{
+    timer_entry_t *slot = &wheel [tick_ & (wheel_slots - 1)];
+    timer_entry_t *timer = slot->next;
+    while (timer != slot) {
+        timer_entry_t *next = timer->next;
+        if (timer->deadline <= now_) {
+            unlink (timer);
+            link (&due, timer);
+        }
+        timer = next;
+    }
+}
+
+void zmq::poller_base_t::link (timer_entry_t *list_, timer_entry_t *timer_)
+{
+    timer_->prev = list_->prev;
+    timer_->next = list_;
+    list_->prev->next = timer_;
+    list_->prev = timer_;
+}
+
+void zmq::poller_base_t::unlink (timer_entry_t *timer_)
+{
+    timer_->prev->next = timer_->next;
+    timer_->next->prev = timer_->prev;
+}
+
+uint64_t zmq::poller_base_t::now_ms ()
+{
+#if defined ZMQ_HAVE_WINDOWS
+    LARGE_INTEGER ticks_per_second;
+    QueryPerformanceFrequency (&ticks_per_second);
+    LARGE_INTEGER tick;
+    QueryPerformanceCounter (&tick);
+    return (uint64_t) (tick.QuadPart / (ticks_per_second.QuadPart / 1000));
+#elif defined CLOCK_MONOTONIC
+    timespec ts;
+    int rc = clock_gettime (CLOCK_MONOTONIC, &ts);
+    errno_assert (rc == 0);
+    return ts.tv_sec * (uint64_t) 1000 + ts.tv_nsec / 1000000;
+#else
+    timeval tv;
+    int rc = gettimeofday (&tv, NULL);
+    errno_assert (rc == 0);
+    return tv.tv_sec * (uint64_t) 1000 + tv.tv_usec / 1000;
+#endif
+}
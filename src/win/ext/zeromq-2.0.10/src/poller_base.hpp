@@ -0,0 +1,108 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __ZMQ_POLLER_BASE_HPP_INCLUDED__
+#define __ZMQ_POLLER_BASE_HPP_INCLUDED__
+
+#include "stdint.hpp"
+
+namespace zmq
+{
+
+    //  Timer bookkeeping shared by all the poller implementations. Timers
+    //  are kept in a hashed timing wheel with one millisecond ticks: each
+    //  timer sits in the slot its deadline hashes to, so that adding and
+    //  cancelling a timer is O(1) and firing only visits the slots for the
+    //  ticks that elapsed since the last call. Deadlines further away than
+    //  one revolution share the slots and simply stay put until they are due.
+
+    class poller_base_t
+    {
+    public:
+
+        typedef void* timer_handle_t;
+
+        poller_base_t ();
+        ~poller_base_t ();
+
+        //  Call timer_event on sink_ once timeout_ milliseconds elapse.
+        //  The handle returned is valid until the timer fires or is
+        //  cancelled, whichever comes first.
+        timer_handle_t add_timer (int timeout_,
+            struct i_poll_events *sink_);
+
+        //  Cancel a timer that has not fired yet.
+        void cancel_timer (timer_handle_t handle_);
+
+    protected:
+
+        //  Fires all the timers that are due. Returns the number of
+        //  milliseconds the poller can wait before another timer is due,
+        //  or -1 if there are no timers at all.
+        int execute_timers ();
+
+    private:
+
+        enum {
+
+            //  Number of slots in the wheel. Must be a power of two.
+            wheel_slots = 256
+        };
+
+        //  Timers form an intrusive doubly-linked list per slot, so that
+        //  a timer can unlink itself without knowing where it is.
+        struct timer_entry_t
+        {
+            timer_entry_t *prev;
+            timer_entry_t *next;
+            uint64_t deadline;
+            struct i_poll_events *sink;
+        };
+
+        //  Monotonic time in milliseconds.
+        static uint64_t now_ms ();
+
+        static void link (timer_entry_t *list_, timer_entry_t *timer_);
+        static void unlink (timer_entry_t *timer_);
+
+        //  Moves the timers in the slot for tick_ that are due at time
+        //  now_ to the 'due' list.
+        void collect (uint64_t tick_, uint64_t now_);
+
+        //  Sentinels of the slot lists.
+        timer_entry_t wheel [wheel_slots];
+
+        //  Timers collected for firing. They can still be cancelled by the
+        //  handlers of the timers fired before them.
+        timer_entry_t due;
+
+        //  The last tick processed by execute_timers.
+        uint64_t current;
+
+        //  Number of timers pending.
+        int count;
+
+        poller_base_t (const poller_base_t&);
+        void operator = (const poller_base_t&);
+    };
+
+}
+
+#endif
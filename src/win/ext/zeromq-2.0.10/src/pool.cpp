@@ -0,0 +1,376 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "platform.hpp"
+
+#ifdef ZMQ_HAVE_WINDOWS
+#include "windows.hpp"
+#include <malloc.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <stdlib.h>
+#include <new>
+
+#include "pool.hpp"
+#include "atomic_ptr.hpp"
+#include "mutex.hpp"
+#include "config.hpp"
+#include "err.hpp"
+
+namespace zmq
+{
+
+    enum
+    {
+        //  Size of the block header. Keeps the payload aligned for any
+        //  type on all the platforms.
+        pool_header_size = 32,
+
+        //  Blocks start on a cache line boundary.
+        pool_alignment = 64,
+
+        //  Size classes go up in cache lines till 256 bytes and in quarters
+        //  of a power of two from there on, so no block is more than 25%
+        //  bigger than requested. Blocks bigger than pool_max_block are
+        //  passed to malloc.
+        pool_small_classes = 4,
+        pool_small_limit = pool_small_classes * pool_alignment,
+        pool_small_shift = 8,
+        pool_max_shift = 14,
+        pool_max_block = 1 << pool_max_shift,
+        pool_classes = pool_small_classes +
+            (pool_max_shift - pool_small_shift) * 4
+    };
+
+    struct pool_heap_t;
+
+    //  Header preceding each block. Huge blocks have no owner.
+    struct pool_block_t
+    {
+        pool_heap_t *owner;
+        pool_block_t *next;
+        size_t size;
+        int cls;
+    };
+
+    //  Per-thread state of the pool.
+    struct pool_heap_t
+    {
+        //  Blocks ready to be reused by the owning thread.
+        pool_block_t *cached [pool_classes];
+        size_t cached_bytes;
+
+        //  Blocks released by other threads.
+        atomic_ptr_t <pool_block_t> remote;
+
+        //  True if the owning thread has exited. Another thread can
+        //  adopt the heap along with the blocks still in flight.
+        bool abandoned;
+
+#ifdef ZMQ_HAVE_WINDOWS
+        //  The owning thread. Windows gives no thread exit hook that works
+        //  for a DLL loaded on demand, so a heap is abandoned once this
+        //  handle gets signaled.
+        HANDLE thread;
+#endif
+
+        pool_heap_t *next;
+    };
+
+}
+
+//  All the heaps ever created. Heaps are never destroyed because blocks
+//  they own can be released at any time.
+static zmq::mutex_t heaps_sync;
+static zmq::pool_heap_t *heaps = NULL;
+
+#ifdef ZMQ_HAVE_WINDOWS
+
+static DWORD heap_key = TlsAlloc ();
+
+static zmq::pool_heap_t *get_heap ()
+{
+    return (zmq::pool_heap_t*) TlsGetValue (heap_key);
+}
+
+static void set_heap (zmq::pool_heap_t *heap_)
+{
+    BOOL rc = TlsSetValue (heap_key, heap_);
+    win_assert (rc != 0);
+}
+
+static void *alloc_block (size_t size_)
+{
+    return _aligned_malloc (size_, zmq::pool_alignment);
+}
+
+static void free_block (void *block_)
+{
+    _aligned_free (block_);
+}
+
+//  Checks whether the owner of the heap has exited. Called with heaps_sync
+//  held.
+static bool is_abandoned (zmq::pool_heap_t *heap_)
+{
+    if (!heap_->abandoned && heap_->thread &&
+          WaitForSingleObject (heap_->thread, 0) == WAIT_OBJECT_0) {
+        CloseHandle (heap_->thread);
+        heap_->thread = NULL;
+        heap_->abandoned = true;
+    }
+    return heap_->abandoned;
+}
+
+//  Makes the calling thread the owner of the heap. Its cached blocks are
+//  kept for the new owner. Called with heaps_sync held.
+static void adopt_heap (zmq::pool_heap_t *heap_)
+{
+    BOOL rc = DuplicateHandle (GetCurrentProcess (), GetCurrentThread (),
+        GetCurrentProcess (), &heap_->thread, SYNCHRONIZE, FALSE, 0);
+    win_assert (rc != 0);
+    heap_->abandoned = false;
+}
+
+#else
+
+static void abandon_heap (void *heap_);
+
+static pthread_key_t create_heap_key ()
+{
+    pthread_key_t key;
+    int rc = pthread_key_create (&key, abandon_heap);
+    posix_assert (rc);
+    return key;
+}
+
+static pthread_key_t heap_key = create_heap_key ();
+
+static zmq::pool_heap_t *get_heap ()
+{
+    return (zmq::pool_heap_t*) pthread_getspecific (heap_key);
+}
+
+static void set_heap (zmq::pool_heap_t *heap_)
+{
+    int rc = pthread_setspecific (heap_key, heap_);
+    posix_assert (rc);
+}
+
+static void *alloc_block (size_t size_)
+{
+    void *block;
+    if (posix_memalign (&block, zmq::pool_alignment, size_))
+        return NULL;
+    return block;
+}
+
+static void free_block (void *block_)
+{
+    free (block_);
+}
+
+//  Heaps are marked abandoned by the thread-specific data destructor.
+static bool is_abandoned (zmq::pool_heap_t *heap_)
+{
+    return heap_->abandoned;
+}
+
+static void adopt_heap (zmq::pool_heap_t *heap_)
+{
+    heap_->abandoned = false;
+}
+
+#endif
+
+//  Returns the size class for a block of size_ bytes, header included.
+static int size_class (size_t size_)
+{
+    if (size_ <= zmq::pool_small_limit)
+        return (int) ((size_ - 1) / zmq::pool_alignment);
+
+    //  Find the power of two the size rounds up to, then the quarter of
+    //  the preceding range it falls into.
+    int shift = zmq::pool_small_shift + 1;
+    while (((size_t) 1 << shift) < size_)
+        shift++;
+    size_t base = (size_t) 1 << (shift - 1);
+    int quarter = (int) ((size_ - base - 1) >> (shift - 3));
+    return zmq::pool_small_classes +
+        (shift - zmq::pool_small_shift - 1) * 4 + quarter;
+}
+
+//  Returns the block size of the size class.
+static size_t class_size (int cls_)
+{
+    if (cls_ < zmq::pool_small_classes)
+        return (size_t) (cls_ + 1) * zmq::pool_alignment;
+
+    int shift = zmq::pool_small_shift + (cls_ - zmq::pool_small_classes) / 4;
+    int quarter = (cls_ - zmq::pool_small_classes) % 4 + 1;
+    return ((size_t) 1 << shift) + ((size_t) quarter << (shift - 2));
+}
+
+//  Puts a released block to the cache of its owning heap, unless the
+//  cache is full already.
+static void cache_block (zmq::pool_heap_t *heap_, zmq::pool_block_t *block_)
+{
+    if (heap_->cached_bytes + block_->size > zmq::pool_cache_size) {
+        free_block (block_);
+        return;
+    }
+    block_->next = heap_->cached [block_->cls];
+    heap_->cached [block_->cls] = block_;
+    heap_->cached_bytes += block_->size;
+}
+
+//  Moves the blocks released by other threads to the cache.
+static void reclaim_blocks (zmq::pool_heap_t *heap_)
+{
+    zmq::pool_block_t *block = heap_->remote.xchg (NULL);
+    while (block) {
+        zmq::pool_block_t *next = block->next;
+        cache_block (heap_, block);
+        block = next;
+    }
+}
+
+#ifndef ZMQ_HAVE_WINDOWS
+
+static void abandon_heap (void *heap_)
+{
+    zmq::pool_heap_t *heap = (zmq::pool_heap_t*) heap_;
+
+    //  Blocks still in flight will find their way to the heap's remote
+    //  list. Those cached can go back to the system.
+    heaps_sync.lock ();
+    for (int cls = 0; cls != zmq::pool_classes; cls++) {
+        while (heap->cached [cls]) {
+            zmq::pool_block_t *block = heap->cached [cls];
+            heap->cached [cls] = block->next;
+            free_block (block);
+        }
+    }
+    heap->cached_bytes = 0;
+    heap->abandoned = true;
+    heaps_sync.unlock ();
+}
+
+#endif
+
+//  Returns the heap of the calling thread, adopting an abandoned one or
+//  creating a new one if the thread has none yet.
+static zmq::pool_heap_t *current_heap ()
+{
+    zmq::pool_heap_t *heap = get_heap ();
+    if (heap)
+        return heap;
+
+    heaps_sync.lock ();
+    for (heap = heaps; heap; heap = heap->next)
+        if (is_abandoned (heap))
+            break;
+    if (!heap) {
+        heap = new (std::nothrow) zmq::pool_heap_t;
+        zmq_assert (heap);
+        for (int cls = 0; cls != zmq::pool_classes; cls++)
+            heap->cached [cls] = NULL;
+        heap->cached_bytes = 0;
+#ifdef ZMQ_HAVE_WINDOWS
+        heap->thread = NULL;
+#endif
+        heap->next = heaps;
+        heaps = heap;
+    }
+    adopt_heap (heap);
+    heaps_sync.unlock ();
+
+    set_heap (heap);
+    return heap;
+}
+
+void *zmq::pool_alloc (size_t size_)
+{
+    size_t total = size_ + pool_header_size;
+
+    //  Huge blocks are not pooled.
+    if (total > pool_max_block || total < size_) {
+        pool_block_t *block = (pool_block_t*) malloc (total);
+        if (!block)
+            return NULL;
+        block->owner = NULL;
+        return (unsigned char*) block + pool_header_size;
+    }
+
+    int cls = size_class (total);
+    pool_heap_t *heap = current_heap ();
+    if (!heap->cached [cls])
+        reclaim_blocks (heap);
+
+    pool_block_t *block = heap->cached [cls];
+    if (block) {
+        heap->cached [cls] = block->next;
+        heap->cached_bytes -= block->size;
+    }
+    else {
+        size_t size = class_size (cls);
+        block = (pool_block_t*) alloc_block (size);
+        if (!block)
+            return NULL;
+        block->owner = heap;
+        block->size = size;
+        block->cls = cls;
+    }
+
+    return (unsigned char*) block + pool_header_size;
+}
+
+void zmq::pool_free (void *ptr_)
+{
+    if (!ptr_)
+        return;
+
+    pool_block_t *block =
+        (pool_block_t*) ((unsigned char*) ptr_ - pool_header_size);
+    if (!block->owner) {
+        free (block);
+        return;
+    }
+
+    //  The owning thread caches the block straight away.
+    pool_heap_t *heap = block->owner;
+    if (heap == get_heap ()) {
+        cache_block (heap, block);
+        return;
+    }
+
+    //  Other threads push it to the owner's remote list. The owner only
+    //  ever takes the whole list at once, so pushing is ABA-safe.
+    pool_block_t *head = heap->remote.get ();
+    while (true) {
+        block->next = head;
+        pool_block_t *old = heap->remote.cas (head, block);
+        if (old == head)
+            break;
+        head = old;
+    }
+}
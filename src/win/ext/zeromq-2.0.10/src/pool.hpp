@@ -0,0 +1,46 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __ZMQ_POOL_HPP_INCLUDED__
+#define __ZMQ_POOL_HPP_INCLUDED__
+
+#include <stddef.h>
+
+namespace zmq
+{
+
+    //  Memory pool for message contents and queue chunks. Blocks come in
+    //  size classes and start on a cache line, so that two blocks never
+    //  share one. Each thread caches the blocks it allocated
+    //  once they are freed. Blocks freed by other threads are handed back
+    //  to the owning thread through a lock-free list, so the usual pattern
+    //  of one thread allocating a message and another one releasing it
+    //  doesn't bounce through the system allocator. Requests beyond the
+    //  largest size class go straight to malloc.
+
+    //  Allocates size_ bytes. Returns NULL if out of memory.
+    void *pool_alloc (size_t size_);
+
+    //  Releases memory obtained from pool_alloc. Any thread can do so.
+    void pool_free (void *ptr_);
+
+}
+
+#endif
@@ -35,7 +35,7 @@ zmq::pub_t::pub_t (class app_thread_t *parent_) :
 zmq::pub_t::~pub_t ()
 {
     for (pipes_t::size_type i = 0; i != pipes.size (); i++)
-        pipes [i]->term ();
+        term_pipe (pipes [i]);
     pipes.clear ();
 }
 
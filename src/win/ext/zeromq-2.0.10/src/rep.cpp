@@ -73,7 +73,7 @@ void zmq::rep_t::xdetach_inpipe (class reader_t *pipe_)
     }
 
     if (out_pipes [index])
-        out_pipes [index]->term ();
+        term_pipe (out_pipes [index]);
     in_pipes.erase (index);
     out_pipes.erase (index);
 }
@@ -98,7 +98,7 @@ void zmq::rep_t::xdetach_outpipe (class writer_t *pipe_)
     }
 
     if (in_pipes [index])
-        in_pipes [index]->term ();
+        term_pipe (in_pipes [index]);
     in_pipes.erase (index);
     out_pipes.erase (index);
 }
@@ -71,7 +71,7 @@ void zmq::req_t::xdetach_inpipe (class reader_t *pipe_)
     in_pipes_t::size_type index = in_pipes.index (pipe_);
 
     if (out_pipes [index])
-        out_pipes [index]->term ();
+        term_pipe (out_pipes [index]);
     in_pipes.erase (index);
     out_pipes.erase (index);
     if (index < active) {
@@ -91,7 +91,7 @@ void zmq::req_t::xdetach_outpipe (class writer_t *pipe_)
     out_pipes_t::size_type index = out_pipes.index (pipe_);
 
     if (in_pipes [index])
-        in_pipes [index]->term ();
+        term_pipe (in_pipes [index]);
     in_pipes.erase (index);
     out_pipes.erase (index);
     if (index < active) {
@@ -88,6 +88,11 @@ bool zmq::session_t::write (::zmq_msg_t *msg_)
         return true;
     }
 
+    //  The engine stops reading until the pipe is revived, so each
+    //  stall is counted once.
+    if (out_pipe)
+        owner->get_stats ()->recv_hwm_hits.add_shared (1);
+
     return false;
 }
 
@@ -30,8 +30,6 @@
 #include "windows.hpp"
 #else
 #include <unistd.h>
-#include <fcntl.h>
-#include <limits.h>
 #endif
 
 zmq::fd_t zmq::signaler_t::get_fd ()
@@ -74,6 +72,12 @@ zmq::signaler_t::signaler_t ()
     //  Create the socket.
     w = WSASocket (AF_INET, SOCK_STREAM, 0, NULL, 0,  0);
     wsa_assert (w != INVALID_SOCKET);
+
+    //  Signals are single bytes and have to go out immediately.
+    BOOL nodelay = TRUE;
+    rc = setsockopt (w, IPPROTO_TCP, TCP_NODELAY, (char*) &nodelay,
+        sizeof (nodelay));
+    wsa_assert (rc != SOCKET_ERROR);
                       
     //  Connect to the remote peer.
     rc = connect (w, (sockaddr *) &addr, sizeof (addr));
@@ -83,11 +87,6 @@ zmq::signaler_t::signaler_t ()
     r = accept (listener, NULL, NULL);
     wsa_assert (r != INVALID_SOCKET);
 
-    //  Set the read site of the pair to non-blocking mode.
-    unsigned long argp = 1;
-    rc = ioctlsocket (r, FIONBIO, &argp);
-    wsa_assert (rc != SOCKET_ERROR);
-
     //  We don't need the listening socket anymore. Close it.
     rc = closesocket (listener);
     wsa_assert (rc != SOCKET_ERROR);
@@ -102,128 +101,55 @@ zmq::signaler_t::~signaler_t ()
     wsa_assert (rc != SOCKET_ERROR);
 }
 
-void zmq::signaler_t::send (const command_t &cmd_)
+void zmq::signaler_t::signal ()
 {
-    //  TODO: Note that send is a blocking operation.
-    //  How should we behave if the signal cannot be written to the signaler?
-    //  Even worse: What if half of a command is written?
-    int rc = ::send (w, (char*) &cmd_, sizeof (command_t), 0);
-    win_assert (rc != SOCKET_ERROR);
-    zmq_assert (rc == sizeof (command_t));
+    unsigned char dummy = 0;
+    int rc = ::send (w, (char*) &dummy, sizeof (dummy), 0);
+    wsa_assert (rc != SOCKET_ERROR);
+    zmq_assert (rc == sizeof (dummy));
 }
 
-bool zmq::signaler_t::recv (command_t *cmd_, bool block_)
+void zmq::signaler_t::wait ()
 {
-    if (block_) {
-
-        //  Switch to blocking mode.
-        unsigned long argp = 0;
-        int rc = ioctlsocket (r, FIONBIO, &argp);
-        wsa_assert (rc != SOCKET_ERROR);
-    }
-
-    bool result;
-    int nbytes = ::recv (r, (char*) cmd_, sizeof (command_t), 0);
-    if (nbytes == -1 && WSAGetLastError () == WSAEWOULDBLOCK) {
-        result = false;
-    }
-    else {
-        wsa_assert (nbytes != -1);
-
-        //  Check whether we haven't got half of a signal.
-        zmq_assert (nbytes % sizeof (uint32_t) == 0);
-
-        result = true;
-    }
-
-    if (block_) {
-
-        //  Switch back to non-blocking mode.
-        unsigned long argp = 1;
-        int rc = ioctlsocket (r, FIONBIO, &argp);
-        wsa_assert (rc != SOCKET_ERROR);
-    }
-
-    return result;
+    unsigned char dummy;
+    int nbytes = ::recv (r, (char*) &dummy, sizeof (dummy), 0);
+    wsa_assert (nbytes != SOCKET_ERROR);
+    zmq_assert (nbytes == sizeof (dummy));
 }
 
-#elif defined ZMQ_HAVE_HPUX || defined ZMQ_HAVE_AIX
-
-#include <sys/types.h>
-#include <sys/socket.h>
+#elif defined ZMQ_SIGNALER_EVENTFD
 
 zmq::signaler_t::signaler_t ()
 {
-    int sv [2];
-    int rc = socketpair (AF_UNIX, SOCK_STREAM, 0, sv);
-    errno_assert (rc == 0);
-    w = sv [0];
-    r = sv [1];
-
-    //  Set the reader to non-blocking mode.
-    int flags = fcntl (r, F_GETFL, 0);
-    if (flags == -1)
-        flags = 0;
-    rc = fcntl (r, F_SETFL, flags | O_NONBLOCK);
-    errno_assert (rc != -1);
+    w = r = eventfd (0, EFD_SEMAPHORE);
+    errno_assert (r != -1);
 }
 
 zmq::signaler_t::~signaler_t ()
 {
-    close (w);
     close (r);
 }
 
-void zmq::signaler_t::send (const command_t &cmd_)
+void zmq::signaler_t::signal ()
 {
+    const uint64_t inc = 1;
     ssize_t nbytes;
     do {
-        nbytes = ::send (w, &cmd_, sizeof (command_t), 0);
+        nbytes = ::write (w, &inc, sizeof (inc));
     } while (nbytes == -1 && errno == EINTR);
     errno_assert (nbytes != -1);
-    zmq_assert (nbytes == sizeof (command_t));
+    zmq_assert (nbytes == sizeof (inc));
 }
 
-bool zmq::signaler_t::recv (command_t *cmd_, bool block_)
+void zmq::signaler_t::wait ()
 {
-    if (block_) {
-
-        //  Set the reader to blocking mode.
-        int flags = fcntl (r, F_GETFL, 0);
-        if (flags == -1)
-            flags = 0;
-        int rc = fcntl (r, F_SETFL, flags & ~O_NONBLOCK);
-        errno_assert (rc != -1);
-    }
-
-    bool result;
+    uint64_t dummy;
     ssize_t nbytes;
     do {
-        nbytes = ::recv (r, (char*) cmd_, sizeof (command_t), 0);
+        nbytes = ::read (r, &dummy, sizeof (dummy));
     } while (nbytes == -1 && errno == EINTR);
-    if (nbytes == -1 && errno == EAGAIN) {
-        result = false;
-    }
-    else {
-        zmq_assert (nbytes != -1);
-
-        //  Check whether we haven't got half of command.
-        zmq_assert (nbytes == sizeof (command_t));
-
-        result = true;
-    }
-
-   if (block_) {
-
-        //  Set the reader to non-blocking mode.
-        int flags = fcntl (r, F_GETFL, 0);
-        if (flags == -1)
-            flags = 0;
-        int rc = fcntl (r, F_SETFL, flags | O_NONBLOCK);
-        errno_assert (rc != -1);
-    }
-
-    return result;
+    errno_assert (nbytes != -1);
+    zmq_assert (nbytes == sizeof (dummy));
 }
 
 #else
@@ -233,11 +159,6 @@ bool zmq::signaler_t::recv (command_t *cmd_, bool block_)
 
 zmq::signaler_t::signaler_t ()
 {
-    //  Make sure that command can be written to the socket in atomic fashion.
-    //  If this wasn't guaranteed, commands from different threads would be
-    //  interleaved.
-    zmq_assert (sizeof (command_t) <= PIPE_BUF);
-
     int sv [2];
     int rc = socketpair (AF_UNIX, SOCK_STREAM, 0, sv);
     errno_assert (rc == 0);
@@ -251,39 +172,28 @@ zmq::signaler_t::~signaler_t ()
     close (r);
 }
 
-void zmq::signaler_t::send (const command_t &cmd_)
+void zmq::signaler_t::signal ()
 {
-    //  TODO: Note that send is a blocking operation.
-    //  How should we behave if the command cannot be written to the signaler?
+    //  At most a couple of signals are ever outstanding, so the write
+    //  cannot block on a full socket buffer.
+    unsigned char dummy = 0;
     ssize_t nbytes;
     do {
-        nbytes = ::send (w, &cmd_, sizeof (command_t), 0);
+        nbytes = ::send (w, &dummy, sizeof (dummy), 0);
     } while (nbytes == -1 && errno == EINTR);
     errno_assert (nbytes != -1);
-
-    //  This should never happen as we've already checked that command size is
-    //  less than PIPE_BUF.
-    zmq_assert (nbytes == sizeof (command_t));
+    zmq_assert (nbytes == sizeof (dummy));
 }
 
-bool zmq::signaler_t::recv (command_t *cmd_, bool block_)
+void zmq::signaler_t::wait ()
 {
+    unsigned char dummy;
     ssize_t nbytes;
     do {
-        nbytes = ::recv (r, cmd_, sizeof (command_t),
-            block_ ? 0 : MSG_DONTWAIT);
+        nbytes = ::recv (r, &dummy, sizeof (dummy), 0);
     } while (nbytes == -1 && errno == EINTR);
-
-    //  If there's no signal available return false.
-    if (nbytes == -1 && errno == EAGAIN)
-        return false;
-
     errno_assert (nbytes != -1);
-
-    //  Check whether we haven't got half of command.
-    zmq_assert (nbytes == sizeof (command_t));
-
-    return true;
+    zmq_assert (nbytes == sizeof (dummy));
 }
 
 #endif
@@ -25,12 +25,25 @@
 #include "platform.hpp"
 #include "fd.hpp"
 #include "stdint.hpp"
-#include "config.hpp"
-#include "command.hpp"
+
+#if defined ZMQ_HAVE_LINUX
+#include <sys/eventfd.h>
+#endif
+
+//  An eventfd in semaphore mode hands out exactly one signal per read, which
+//  is all the signaler needs. Elsewhere a socketpair carries one byte per
+//  signal.
+#if defined ZMQ_HAVE_LINUX && defined EFD_SEMAPHORE
+#define ZMQ_SIGNALER_EVENTFD
+#endif
 
 namespace zmq
 {
 
+    //  Wake-up channel of a mailbox. Each signal() makes the file descriptor
+    //  readable until a matching wait() consumes it. Signals are counted,
+    //  not merged, so every signal sent has to be waited for exactly once.
+
     class signaler_t
     {
     public:
@@ -39,9 +52,12 @@ namespace zmq
         ~signaler_t ();
 
         fd_t get_fd ();
-        void send (const command_t &cmd_);
-        bool recv (command_t *cmd_, bool block_);
-        
+        void signal ();
+
+        //  Blocks until a signal is available and consumes it.
+        void wait ();
+
+
     private:
 
 #if defined ZMQ_HAVE_OPENVMS
@@ -57,7 +73,8 @@ namespace zmq
             int sv_ [2]);
 #endif
 
-        //  Write & read end of the socketpair.
+        //  Write & read end of the socketpair. Both are the same descriptor
+        //  when eventfd is used.
         fd_t w;
         fd_t r;
 
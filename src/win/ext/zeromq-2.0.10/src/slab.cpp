@@ -0,0 +1,89 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <new>
+
+#include "slab.hpp"
+#include "pool.hpp"
+#include "err.hpp"
+
+zmq::slab_t *zmq::slab_t::create (size_t size_)
+{
+    void *ptr = pool_alloc (sizeof (slab_t) +
+        in_batch_messages * sizeof (msg_content_t) + size_);
+    if (!ptr)
+        return NULL;
+    return new (ptr) slab_t (size_);
+}
+
+zmq::slab_t::slab_t (size_t size_) :
+    refcnt (1),
+    bufsize (size_),
+    used (0)
+{
+}
+
+zmq::slab_t::~slab_t ()
+{
+}
+
+void zmq::slab_t::release ()
+{
+    if (!refcnt.sub (1)) {
+        this->~slab_t ();
+        pool_free (this);
+    }
+}
+
+bool zmq::slab_t::reuse ()
+{
+    //  No other reference can appear meanwhile as only the holder of
+    //  the slab carves messages out of it.
+    if (refcnt.add (0) != 1)
+        return false;
+    used = 0;
+    return true;
+}
+
+bool zmq::slab_t::carve (::zmq_msg_t *msg_, unsigned char *data_,
+    size_t size_)
+{
+    zmq_assert (data_ >= data () && data_ + size_ <= data () + bufsize);
+
+    if (used == in_batch_messages)
+        return false;
+
+    msg_content_t *content = slots () + used;
+    used++;
+    content->data = data_;
+    content->size = size_;
+    content->ffn = release_fn;
+    content->hint = this;
+    new (&content->refcnt) atomic_counter_t ();
+    refcnt.add (1);
+
+    msg_->content = content;
+    msg_->flags = ZMQ_MSG_SLAB;
+    return true;
+}
+
+void zmq::slab_t::release_fn (void *, void *hint_)
+{
+    ((slab_t*) hint_)->release ();
+}
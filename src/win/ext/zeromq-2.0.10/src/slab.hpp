@@ -0,0 +1,104 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __ZMQ_SLAB_HPP_INCLUDED__
+#define __ZMQ_SLAB_HPP_INCLUDED__
+
+#include <stddef.h>
+
+#include "../include/zmq.h"
+
+#include "atomic_counter.hpp"
+#include "msg_content.hpp"
+#include "config.hpp"
+
+namespace zmq
+{
+
+    //  Receive buffer shared by the messages decoded from it. Data are read
+    //  from the network into the slab and the messages found whole in it
+    //  refer to their bodies in place. The content structures of those
+    //  messages are kept in the slab as well, so a batch of small messages
+    //  costs a single allocation. The slab is deallocated once the decoder
+    //  and all the messages are done with it.
+
+    class slab_t
+    {
+    public:
+
+        //  Creates a slab with room for size_ bytes of data. The caller
+        //  holds the only reference to it. Returns NULL if out of memory.
+        static slab_t *create (size_t size_);
+
+        //  Drops one reference to the slab.
+        void release ();
+
+        //  Returns true if the caller holds the only reference to the slab,
+        //  i.e. all the messages referring to it are gone. The data area can
+        //  be filled in anew and all the content structures are available.
+        bool reuse ();
+
+        //  Initialises msg_ to refer to size_ bytes at data_, which have to
+        //  lie within the data area. Returns false if the slab has run out
+        //  of content structures, in which case msg_ is left untouched.
+        bool carve (::zmq_msg_t *msg_, unsigned char *data_, size_t size_);
+
+        //  The data area.
+        inline unsigned char *data ()
+        {
+            return (unsigned char*) (slots () + in_batch_messages);
+        }
+
+        inline size_t size ()
+        {
+            return bufsize;
+        }
+
+    private:
+
+        slab_t (size_t size_);
+        ~slab_t ();
+
+        //  The content structures follow the slab_t structure itself.
+        inline msg_content_t *slots ()
+        {
+            return (msg_content_t*) (this + 1);
+        }
+
+        //  Deallocation function of the carved messages.
+        static void release_fn (void *data_, void *hint_);
+
+        //  Number of references: one held by the creator and one for each
+        //  message referring to the slab.
+        atomic_counter_t refcnt;
+
+        //  Size of the data area.
+        size_t bufsize;
+
+        //  Number of content structures handed out since the slab was
+        //  created or last reused.
+        int used;
+
+        slab_t (const slab_t&);
+        void operator = (const slab_t&);
+    };
+
+}
+
+#endif
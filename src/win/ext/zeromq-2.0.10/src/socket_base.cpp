@@ -18,6 +18,7 @@
 */
 
 #include <new>
+#include <string.h>
 #include <string>
 #include <algorithm>
 
@@ -44,14 +45,17 @@
 zmq::socket_base_t::socket_base_t (app_thread_t *parent_) :
     object_t (parent_),
     pending_term_acks (0),
-    ticks (0),
     rcvmore (false),
     app_thread (parent_),
     shutting_down (false),
     sent_seqnum (0),
     processed_seqnum (0),
-    next_ordinal (1)
+    next_ordinal (1),
+    monitor_fn (NULL),
+    monitor_hint (NULL),
+    monitor_events (0)
 {
+    get_ctx ()->register_stats (&stats);
 }
 
 zmq::socket_base_t::~socket_base_t ()
@@ -94,6 +98,33 @@ int zmq::socket_base_t::getsockopt (int option_, void *optval_,
         return 0;
     }
 
+    if (option_ == ZMQ_STATS) {
+        if (*optvallen_ < sizeof (zmq_stats_t)) {
+            errno = EINVAL;
+            return -1;
+        }
+        zmq_stats_t *result = (zmq_stats_t*) optval_;
+        memset (result, 0, sizeof (zmq_stats_t));
+        stats.sum (result);
+
+        //  The peers update their ends of the pipes concurrently, so the
+        //  queue lengths are mere snapshots.
+        result->pipes = inpipes.size () + outpipes.size ();
+        for (inpipes_t::iterator it = inpipes.begin (); it != inpipes.end ();
+              it++) {
+            result->queued_in += (*it)->get_queued ();
+            result->swap_bytes += (*it)->get_swapped ();
+        }
+        for (outpipes_t::iterator it = outpipes.begin ();
+              it != outpipes.end (); it++) {
+            result->queued_out += (*it)->get_queued ();
+            result->swap_bytes += (*it)->get_swapped ();
+        }
+
+        *optvallen_ = sizeof (zmq_stats_t);
+        return 0;
+    }
+
     return options.getsockopt (option_, optval_, optvallen_);
 }
 
@@ -136,7 +167,10 @@ int zmq::socket_base_t::bind (const char *addr_)
         zmq_assert (listener);
         int rc = listener->set_address (addr_type.c_str(), addr_args.c_str ());
         if (rc != 0) {
+            int err = errno;
             delete listener;
+            monitor_event (ZMQ_EVENT_BIND_FAILED, addr_type, addr_args, err);
+            errno = err;
             return -1;
         }
 
@@ -348,7 +382,7 @@ int zmq::socket_base_t::connect (const char *addr_)
 int zmq::socket_base_t::send (::zmq_msg_t *msg_, int flags_)
 {
     //  Process pending commands, if any.
-    if (unlikely (!app_thread->process_commands (false, true))) {
+    if (unlikely (!app_thread->process_commands (false))) {
         errno = ETERM;
         return -1;
     }
@@ -357,10 +391,20 @@ int zmq::socket_base_t::send (::zmq_msg_t *msg_, int flags_)
     if (flags_ & ZMQ_SNDMORE)
         msg_->flags |= ZMQ_MSG_MORE;
 
+    //  The message is gone once sent, so get its size beforehand.
+    size_t size = zmq_msg_size (msg_);
+
     //  Try to send the message.
     int rc = xsend (msg_, flags_);
-    if (rc == 0)
+    if (rc == 0) {
+        stats.msgs_sent.add (1);
+        stats.bytes_sent.add (size);
         return 0;
+    }
+
+    //  No pipe could take the message.
+    if (errno == EAGAIN)
+        stats.send_hwm_hits.add (1);
 
     //  In case of non-blocking send we'll simply propagate
     //  the error - including EAGAIN - upwards.
@@ -372,12 +416,14 @@ int zmq::socket_base_t::send (::zmq_msg_t *msg_, int flags_)
     while (rc != 0) {
         if (errno != EAGAIN)
             return -1;
-        if (unlikely (!app_thread->process_commands (true, false))) {
+        if (unlikely (!app_thread->process_commands (true))) {
             errno = ETERM;
             return -1;
         }
         rc = xsend (msg_, flags_);
     }
+    stats.msgs_sent.add (1);
+    stats.bytes_sent.add (size);
     return 0;
 }
 
@@ -387,20 +433,11 @@ int zmq::socket_base_t::recv (::zmq_msg_t *msg_, int flags_)
     int rc = xrecv (msg_, flags_);
     int err = errno;
 
-    //  Once every inbound_poll_rate messages check for signals and process
-    //  incoming commands. This happens only if we are not polling altogether
-    //  because there are messages available all the time. If poll occurs,
-    //  ticks is set to zero and thus we avoid this code.
-    //
-    //  Note that 'recv' uses different command throttling algorithm (the one
-    //  described above) from the one used by 'send'. This is because counting
-    //  ticks is more efficient than doing rdtsc all the time.
-    if (++ticks == inbound_poll_rate) {
-        if (unlikely (!app_thread->process_commands (false, false))) {
-            errno = ETERM;
-            return -1;
-        }
-        ticks = 0;
+    //  Process pending commands, if any. This matters when messages are
+    //  available all the time and we never get to block below.
+    if (unlikely (!app_thread->process_commands (false))) {
+        errno = ETERM;
+        return -1;
     }
 
     //  If we have the message, return immediately.
@@ -408,6 +445,8 @@ int zmq::socket_base_t::recv (::zmq_msg_t *msg_, int flags_)
         rcvmore = msg_->flags & ZMQ_MSG_MORE;
         if (rcvmore)
             msg_->flags &= ~ZMQ_MSG_MORE;
+        stats.msgs_received.add (1);
+        stats.bytes_received.add (zmq_msg_size (msg_));
         return 0;
     }
 
@@ -420,37 +459,43 @@ int zmq::socket_base_t::recv (::zmq_msg_t *msg_, int flags_)
     if (flags_ & ZMQ_NOBLOCK) {
         if (errno != EAGAIN)
             return -1;
-        if (unlikely (!app_thread->process_commands (false, false))) {
+        if (unlikely (!app_thread->process_commands (false))) {
             errno = ETERM;
             return -1;
         }
-        ticks = 0;
 
         rc = xrecv (msg_, flags_);
         if (rc == 0) {
             rcvmore = msg_->flags & ZMQ_MSG_MORE;
             if (rcvmore)
                 msg_->flags &= ~ZMQ_MSG_MORE;
+            stats.msgs_received.add (1);
+            stats.bytes_received.add (zmq_msg_size (msg_));
         }
         return rc;
     }
 
     //  In blocking scenario, commands are processed over and over again until
-    //  we are able to fetch a message.
+    //  we are able to fetch a message. The commands processed above may have
+    //  revived a pipe already, so try once more before going to sleep.
+    if (errno != EAGAIN)
+        return -1;
+    rc = xrecv (msg_, flags_);
     while (rc != 0) {
         if (errno != EAGAIN)
             return -1;
-        if (unlikely (!app_thread->process_commands (true, false))) {
+        if (unlikely (!app_thread->process_commands (true))) {
             errno = ETERM;
             return -1;
         }
         rc = xrecv (msg_, flags_);
-        ticks = 0;
     }
 
     rcvmore = msg_->flags & ZMQ_MSG_MORE;
     if (rcvmore)
         msg_->flags &= ~ZMQ_MSG_MORE;
+    stats.msgs_received.add (1);
+    stats.bytes_received.add (zmq_msg_size (msg_));
     return 0;
 }
 
@@ -473,7 +518,7 @@ int zmq::socket_base_t::close ()
     //  Wait till all undelivered commands are delivered. This should happen
     //  very quickly. There's no way to wait here for extensive period of time.
     while (processed_seqnum != sent_seqnum.get ())
-        app_thread->process_commands (true, false);
+        app_thread->process_commands (true);
 
     while (true) {
 
@@ -495,7 +540,7 @@ int zmq::socket_base_t::close ()
 
         //  Process commands till we get all the termination acknowledgements.
         while (pending_term_acks)
-            app_thread->process_commands (true, false);
+            app_thread->process_commands (true);
     }
 
     //  Check whether there are no session leaks.
@@ -504,6 +549,9 @@ int zmq::socket_base_t::close ()
     zmq_assert (unnamed_sessions.empty ());
     sessions_sync.unlock ();
 
+    //  No I/O object is left to update the statistics, so they are final.
+    ctx->unregister_stats (&stats);
+
     delete this;
 
     //  This function must be called after the socket is completely deallocated
@@ -622,13 +670,49 @@ void zmq::socket_base_t::revive (writer_t *pipe_)
     xrevive (pipe_);
 }
 
+zmq::socket_stats_t *zmq::socket_base_t::get_stats ()
+{
+    return &stats;
+}
+
+int zmq::socket_base_t::monitor (zmq_monitor_fn *monitor_, void *hint_,
+    int events_)
+{
+    if (events_ & ~ZMQ_EVENT_ALL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    monitor_sync.lock ();
+    monitor_fn = monitor_;
+    monitor_hint = hint_;
+    monitor_events = monitor_ ? events_ : 0;
+    monitor_sync.unlock ();
+    return 0;
+}
+
+void zmq::socket_base_t::monitor_event (int event_,
+    const std::string &protocol_, const std::string &address_, int err_)
+{
+    monitor_sync.lock ();
+    if (monitor_events & event_) {
+        std::string endpoint = protocol_ + "://" + address_;
+        monitor_fn (this, event_, endpoint.c_str (), err_, monitor_hint);
+    }
+    monitor_sync.unlock ();
+}
+
 void zmq::socket_base_t::attach_pipes (class reader_t *inpipe_,
     class writer_t *outpipe_, const blob_t &peer_identity_)
 {
-    if (inpipe_)
+    if (inpipe_) {
         inpipe_->set_endpoint (this);
-    if (outpipe_)
+        inpipes.insert (inpipe_);
+    }
+    if (outpipe_) {
         outpipe_->set_endpoint (this);
+        outpipes.insert (outpipe_);
+    }
 
     //  If the peer haven't specified it's identity, let's generate one.
     if (peer_identity_.size ()) {
@@ -645,12 +729,26 @@ void zmq::socket_base_t::detach_inpipe (class reader_t *pipe_)
 {
     xdetach_inpipe (pipe_);
     pipe_->set_endpoint (NULL); // ?
+    inpipes.erase (pipe_);
 }
 
 void zmq::socket_base_t::detach_outpipe (class writer_t *pipe_)
 {
     xdetach_outpipe (pipe_);
     pipe_->set_endpoint (NULL); // ?
+    outpipes.erase (pipe_);
+}
+
+void zmq::socket_base_t::term_pipe (class reader_t *pipe_)
+{
+    inpipes.erase (pipe_);
+    pipe_->term ();
+}
+
+void zmq::socket_base_t::term_pipe (class writer_t *pipe_)
+{
+    outpipes.erase (pipe_);
+    pipe_->term ();
 }
 
 void zmq::socket_base_t::process_own (owned_t *object_)
@@ -23,6 +23,7 @@
 #include <set>
 #include <map>
 #include <vector>
+#include <string>
 
 #include "../include/zmq.h"
 
@@ -35,6 +36,7 @@
 #include "atomic_counter.hpp"
 #include "stdint.hpp"
 #include "blob.hpp"
+#include "stats.hpp"
 
 namespace zmq
 {
@@ -94,6 +96,19 @@ namespace zmq
         void revive (class reader_t *pipe_);
         void revive (class writer_t *pipe_);
 
+        //  Statistics of the socket. I/O objects owned by the socket update
+        //  the counters meant for I/O threads.
+        socket_stats_t *get_stats ();
+
+        //  Sets the callback to report lifecycle events of the socket's
+        //  connections to.
+        int monitor (zmq_monitor_fn *monitor_, void *hint_, int events_);
+
+        //  Reports an event to the monitor, if there's one interested in it.
+        //  Can be called from any thread.
+        void monitor_event (int event_, const std::string &protocol_,
+            const std::string &address_, int err_);
+
     protected:
 
         //  Destructor is protected. Socket is closed using 'close' function.
@@ -108,6 +123,11 @@ namespace zmq
         virtual void xrevive (class reader_t *pipe_) = 0;
         virtual void xrevive (class writer_t *pipe_) = 0;
 
+        //  Terminates a pipe the socket type gives up on by itself. Such
+        //  a pipe is never detached, so it has to be forgotten here.
+        void term_pipe (class reader_t *pipe_);
+        void term_pipe (class writer_t *pipe_);
+
         //  Actual algorithms are to be defined by individual socket types.
         virtual int xsetsockopt (int option_, const void *optval_,
             size_t optvallen_) = 0;
@@ -138,9 +158,6 @@ namespace zmq
         //  but haven't acknowledged it yet.
         int pending_term_acks;
 
-        //  Number of messages received since last command processing.
-        int ticks;
-
         //  If true there's a half-read message in the socket.
         bool rcvmore;
 
@@ -168,6 +185,24 @@ namespace zmq
         uint64_t next_ordinal;
         mutex_t sessions_sync;
 
+        //  Statistics of the socket.
+        socket_stats_t stats;
+
+        //  Monitor callback, its argument and the events it is interested
+        //  in. I/O threads invoke the monitor while holding the lock so that
+        //  it's not invoked any more once replaced.
+        zmq_monitor_fn *monitor_fn;
+        void *monitor_hint;
+        int monitor_events;
+        mutex_t monitor_sync;
+
+        //  Pipes attached to the socket. They are kept track of only to
+        //  report the state of the queues.
+        typedef std::set <class reader_t*> inpipes_t;
+        inpipes_t inpipes;
+        typedef std::set <class writer_t*> outpipes_t;
+        outpipes_t outpipes;
+
         socket_base_t (const socket_base_t&);
         void operator = (const socket_base_t&);
     };
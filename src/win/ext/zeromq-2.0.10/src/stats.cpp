@@ -0,0 +1,32 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "stats.hpp"
+
+void zmq::socket_stats_t::sum (zmq_stats_t *stats_)
+{
+    stats_->msgs_sent += msgs_sent.get ();
+    stats_->bytes_sent += bytes_sent.get ();
+    stats_->msgs_received += msgs_received.get ();
+    stats_->bytes_received += bytes_received.get ();
+    stats_->send_hwm_hits += send_hwm_hits.get ();
+    stats_->recv_hwm_hits += recv_hwm_hits.get ();
+    stats_->reconnects += reconnects.get ();
+}
@@ -0,0 +1,151 @@
+/*
+    Copyright (c) 2007-2010 iMatix Corporation
+
+    This file is part of 0MQ.
+
+    0MQ is free software; you can redistribute it and/or modify it under
+    the terms of the Lesser GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    0MQ is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    Lesser GNU General Public License for more details.
+
+    You should have received a copy of the Lesser GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __ZMQ_STATS_HPP_INCLUDED__
+#define __ZMQ_STATS_HPP_INCLUDED__
+
+#include "../include/zmq.h"
+
+#include "stdint.hpp"
+#include "platform.hpp"
+
+#if defined ZMQ_FORCE_MUTEXES
+#define ZMQ_STAT_COUNTER_MUTEX
+#elif defined __GNUC__ && defined __ATOMIC_RELAXED
+#define ZMQ_STAT_COUNTER_GCC
+#elif defined ZMQ_HAVE_WINDOWS
+#define ZMQ_STAT_COUNTER_WINDOWS
+#else
+#define ZMQ_STAT_COUNTER_MUTEX
+#endif
+
+#if defined ZMQ_STAT_COUNTER_MUTEX
+#include "mutex.hpp"
+#elif defined ZMQ_STAT_COUNTER_WINDOWS
+#include "windows.hpp"
+#endif
+
+namespace zmq
+{
+
+    //  Statistics counter that any thread can read. As long as a counter
+    //  is updated by a single thread, it can use 'add' which needs no
+    //  locked instructions and thus costs next to nothing. Counters updated
+    //  by several threads have to use 'add_shared' instead.
+
+    class stat_counter_t
+    {
+    public:
+
+        inline stat_counter_t () :
+            value (0)
+        {
+        }
+
+        inline void add (uint64_t increment_)
+        {
+#if defined ZMQ_STAT_COUNTER_GCC
+            __atomic_store_n (&value,
+                __atomic_load_n (&value, __ATOMIC_RELAXED) + increment_,
+                __ATOMIC_RELAXED);
+#elif defined ZMQ_STAT_COUNTER_MUTEX
+            sync.lock ();
+            value += increment_;
+            sync.unlock ();
+#else
+            value += increment_;
+#endif
+        }
+
+        inline void add_shared (uint64_t increment_)
+        {
+#if defined ZMQ_STAT_COUNTER_GCC
+            __atomic_fetch_add (&value, increment_, __ATOMIC_RELAXED);
+#elif defined ZMQ_STAT_COUNTER_WINDOWS
+            InterlockedExchangeAdd64 ((LONGLONG*) &value, increment_);
+#else
+            add (increment_);
+#endif
+        }
+
+        //  Sets the value. Suitable for gauges updated by a single thread.
+        inline void set (uint64_t value_)
+        {
+#if defined ZMQ_STAT_COUNTER_GCC
+            __atomic_store_n (&value, value_, __ATOMIC_RELAXED);
+#elif defined ZMQ_STAT_COUNTER_MUTEX
+            sync.lock ();
+            value = value_;
+            sync.unlock ();
+#else
+            value = value_;
+#endif
+        }
+
+        //  Note that on 32-bit Windows the value read may be torn while
+        //  it's being updated.
+        inline uint64_t get ()
+        {
+#if defined ZMQ_STAT_COUNTER_GCC
+            return __atomic_load_n (&value, __ATOMIC_RELAXED);
+#elif defined ZMQ_STAT_COUNTER_MUTEX
+            sync.lock ();
+            uint64_t result = value;
+            sync.unlock ();
+            return result;
+#else
+            return value;
+#endif
+        }
+
+    private:
+
+        volatile uint64_t value;
+#if defined ZMQ_STAT_COUNTER_MUTEX
+        mutex_t sync;
+#endif
+
+        stat_counter_t (const stat_counter_t&);
+        void operator = (const stat_counter_t&);
+    };
+
+    //  Cumulative statistics of a socket. The comments say which thread
+    //  updates which counter.
+
+    struct socket_stats_t
+    {
+        //  Updated by the socket's application thread.
+        stat_counter_t msgs_sent;
+        stat_counter_t bytes_sent;
+        stat_counter_t msgs_received;
+        stat_counter_t bytes_received;
+        stat_counter_t send_hwm_hits;
+
+        //  Updated by the I/O threads.
+        stat_counter_t recv_hwm_hits;
+        stat_counter_t reconnects;
+
+        //  Adds the counters to the ones in stats_.
+        void sum (zmq_stats_t *stats_);
+    };
+
+}
+
+#endif
@@ -20,11 +20,13 @@
 #include "tcp_socket.hpp"
 #include "platform.hpp"
 #include "err.hpp"
+#include "config.hpp"
 
 #ifdef ZMQ_HAVE_WINDOWS
 
 zmq::tcp_socket_t::tcp_socket_t () :
-    s (retired_fd)
+    s (retired_fd),
+    max_write (0)
 {
 }
 
@@ -44,6 +46,7 @@ int zmq::tcp_socket_t::open (fd_t fd_, uint64_t sndbuf_, uint64_t rcvbuf_)
         int rc = setsockopt (s, SOL_SOCKET, SO_SNDBUF,
             (char*) &sz, sizeof (int));
         errno_assert (rc == 0);
+        max_write = (size_t) sndbuf_;
     }
 
     if (rcvbuf_) {
@@ -86,14 +89,61 @@ int zmq::tcp_socket_t::write (const void *data, int size)
           WSAGetLastError () == WSAEHOSTUNREACH ||
           WSAGetLastError () == WSAECONNABORTED ||
           WSAGetLastError () == WSAETIMEDOUT ||
-          WSAGetLastError () == WSAECONNRESET))
+          WSAGetLastError () == WSAECONNRESET)) {
+        errno = WSAGetLastError ();
         return -1;
+    }
 
     wsa_assert (nbytes != SOCKET_ERROR);
 
     return (size_t) nbytes;
 }
 
+int zmq::tcp_socket_t::writev (const iovec_t *iov_, int count_)
+{
+    if (count_ > out_batch_pieces)
+        count_ = out_batch_pieces;
+
+    WSABUF bufs [out_batch_pieces];
+    size_t total = 0;
+    for (int i = 0; i != count_; i++) {
+        bufs [i].buf = (char*) iov_ [i].data;
+        bufs [i].len = (u_long) iov_ [i].size;
+
+        //  Write at most as much as the send buffer set explicitly holds.
+        if (max_write && total + iov_ [i].size >= max_write) {
+            bufs [i].len = (u_long) (max_write - total);
+            count_ = i + 1;
+            break;
+        }
+        total += iov_ [i].size;
+    }
+
+    DWORD nbytes;
+    int rc = WSASend (s, bufs, count_, &nbytes, 0, NULL, NULL);
+
+    //  If not a single byte can be written to the socket in non-blocking mode
+    //  we'll get an error (this may happen during the speculative write).
+    if (rc == SOCKET_ERROR && WSAGetLastError () == WSAEWOULDBLOCK)
+        return 0;
+
+    //  Signalise peer failure.
+    if (rc == SOCKET_ERROR && (
+          WSAGetLastError () == WSAENETDOWN ||
+          WSAGetLastError () == WSAENETRESET ||
+          WSAGetLastError () == WSAEHOSTUNREACH ||
+          WSAGetLastError () == WSAECONNABORTED ||
+          WSAGetLastError () == WSAETIMEDOUT ||
+          WSAGetLastError () == WSAECONNRESET)) {
+        errno = WSAGetLastError ();
+        return -1;
+    }
+
+    wsa_assert (rc != SOCKET_ERROR);
+
+    return (int) nbytes;
+}
+
 int zmq::tcp_socket_t::read (void *data, int size)
 {
     int nbytes = recv (s, (char*) data, size, 0);
@@ -111,14 +161,18 @@ int zmq::tcp_socket_t::read (void *data, int size)
           WSAGetLastError () == WSAETIMEDOUT ||
           WSAGetLastError () == WSAECONNRESET ||
           WSAGetLastError () == WSAECONNREFUSED ||
-          WSAGetLastError () == WSAENOTCONN))
+          WSAGetLastError () == WSAENOTCONN)) {
+        errno = WSAGetLastError ();
         return -1;
+    }
 
     wsa_assert (nbytes != SOCKET_ERROR);
 
     //  Orderly shutdown by the other peer.
-    if (nbytes == 0)
-        return -1; 
+    if (nbytes == 0) {
+        errno = 0;
+        return -1;
+    }
 
     return (size_t) nbytes;
 }
@@ -126,7 +180,9 @@ int zmq::tcp_socket_t::read (void *data, int size)
 #else
 
 #include <unistd.h>
+#include <limits.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <arpa/inet.h>
 #include <netinet/tcp.h>
 #include <netinet/in.h>
@@ -134,7 +190,8 @@ int zmq::tcp_socket_t::read (void *data, int size)
 #include <fcntl.h>
 
 zmq::tcp_socket_t::tcp_socket_t () :
-    s (retired_fd)
+    s (retired_fd),
+    max_write (0)
 {
 }
 
@@ -153,6 +210,7 @@ int zmq::tcp_socket_t::open (fd_t fd_, uint64_t sndbuf_, uint64_t rcvbuf_)
         int sz = (int) sndbuf_;
         int rc = setsockopt (s, SOL_SOCKET, SO_SNDBUF, &sz, sizeof (int));
         errno_assert (rc == 0);
+        max_write = (size_t) sndbuf_;
     }
 
     if (rcvbuf_) {
@@ -198,6 +256,47 @@ int zmq::tcp_socket_t::write (const void *data, int size)
     return (size_t) nbytes;
 }
 
+int zmq::tcp_socket_t::writev (const iovec_t *iov_, int count_)
+{
+    if (count_ > out_batch_pieces)
+        count_ = out_batch_pieces;
+#ifdef IOV_MAX
+    if (count_ > IOV_MAX)
+        count_ = IOV_MAX;
+#endif
+
+    iovec iov [out_batch_pieces];
+    size_t total = 0;
+    for (int i = 0; i != count_; i++) {
+        iov [i].iov_base = iov_ [i].data;
+        iov [i].iov_len = iov_ [i].size;
+
+        //  When the send buffer was set explicitly, a single write larger
+        //  than the buffer makes the stream crawl, at least on Linux. The
+        //  pieces are written in the buffer-sized runs then.
+        if (max_write && total + iov_ [i].size >= max_write) {
+            iov [i].iov_len = max_write - total;
+            count_ = i + 1;
+            break;
+        }
+        total += iov_ [i].size;
+    }
+
+    ssize_t nbytes = ::writev (s, iov, count_);
+
+    //  The same errors are OK as with write.
+    if (nbytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK ||
+          errno == EINTR))
+        return 0;
+
+    //  Signalise peer failure.
+    if (nbytes == -1 && (errno == ECONNRESET || errno == EPIPE))
+        return -1;
+
+    errno_assert (nbytes != -1);
+    return (int) nbytes;
+}
+
 int zmq::tcp_socket_t::read (void *data, int size)
 {
     ssize_t nbytes = recv (s, data, size, 0);
@@ -217,8 +316,10 @@ int zmq::tcp_socket_t::read (void *data, int size)
     errno_assert (nbytes != -1);
 
     //  Orderly shutdown by the other peer.
-    if (nbytes == 0)
+    if (nbytes == 0) {
+        errno = 0;
         return -1;
+    }
 
     return (size_t) nbytes;
 }
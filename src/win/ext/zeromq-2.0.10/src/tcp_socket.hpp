@@ -22,6 +22,7 @@
 
 #include "fd.hpp"
 #include "stdint.hpp"
+#include "iovec.hpp"
 
 namespace zmq
 {
@@ -50,10 +51,17 @@ namespace zmq
         //  of error or orderly shutdown by the other peer -1 is returned.
         int write (const void *data, int size);
 
+        //  Writes the pieces in iov_ to the socket in a single go. Returns
+        //  the same as write does. Note that a system may limit the number
+        //  of pieces written at once and the amount of data is limited to
+        //  the send buffer size when one was set.
+        int writev (const iovec_t *iov_, int count_);
+
         //  Reads data from the socket (up to 'size' bytes). Returns the number
         //  of bytes actually read (even zero is to be considered to be
         //  a success). In case of error or orderly shutdown by the other
-        //  peer -1 is returned.
+        //  peer -1 is returned and errno is set to the error, or to zero
+        //  for the orderly shutdown.
         int read (void *data, int size);
 
     private:
@@ -61,6 +69,10 @@ namespace zmq
         //  Underlying socket.
         fd_t s;
 
+        //  The most bytes writev passes to the system at once, zero meaning
+        //  no limit. It's the send buffer size if one was set explicitly.
+        size_t max_write;
+
         //  Disable copy construction of tcp_socket.
         tcp_socket_t (const tcp_socket_t&);
         void operator = (const tcp_socket_t&);
@@ -42,10 +42,10 @@ zmq::xrep_t::xrep_t (class app_thread_t *parent_) :
 zmq::xrep_t::~xrep_t ()
 {
     for (inpipes_t::iterator it = inpipes.begin (); it != inpipes.end (); it++)
-        it->reader->term ();
+        term_pipe (it->reader);
     for (outpipes_t::iterator it = outpipes.begin (); it != outpipes.end ();
           it++)
-        it->second.writer->term ();
+        term_pipe (it->second.writer);
 }
 
 void zmq::xrep_t::xattach_pipes (class reader_t *inpipe_,
@@ -20,11 +20,11 @@
 #ifndef __ZMQ_YQUEUE_HPP_INCLUDED__
 #define __ZMQ_YQUEUE_HPP_INCLUDED__
 
-#include <stdlib.h>
 #include <stddef.h>
 
 #include "err.hpp"
 #include "atomic_ptr.hpp"
+#include "pool.hpp"
 
 namespace zmq
 {
@@ -49,7 +49,7 @@ namespace zmq
         //  Create the queue.
         inline yqueue_t ()
         {
-             begin_chunk = (chunk_t*) malloc (sizeof (chunk_t));
+             begin_chunk = (chunk_t*) pool_alloc (sizeof (chunk_t));
              zmq_assert (begin_chunk);
              begin_pos = 0;
              back_chunk = NULL;
@@ -63,17 +63,17 @@ namespace zmq
         {
             while (true) {
                 if (begin_chunk == end_chunk) {
-                    free (begin_chunk);
+                    pool_free (begin_chunk);
                     break;
                 } 
                 chunk_t *o = begin_chunk;
                 begin_chunk = begin_chunk->next;
-                free (o);
+                pool_free (o);
             }
 
             chunk_t *sc = spare_chunk.xchg (NULL);
             if (sc)
-                free (sc);
+                pool_free (sc);
         }
 
         //  Returns reference to the front element of the queue.
@@ -104,7 +104,7 @@ namespace zmq
                 end_chunk->next = sc;
                 sc->prev = end_chunk;
             } else {
-                end_chunk->next = (chunk_t*) malloc (sizeof (chunk_t));
+                end_chunk->next = (chunk_t*) pool_alloc (sizeof (chunk_t));
                 zmq_assert (end_chunk->next);
                 end_chunk->next->prev = end_chunk;
             }
@@ -138,7 +138,7 @@ namespace zmq
             else {
                 end_pos = N - 1;
                 end_chunk = end_chunk->prev;
-                free (end_chunk->next);
+                pool_free (end_chunk->next);
                 end_chunk->next = NULL;
             }
         }
@@ -157,7 +157,7 @@ namespace zmq
                 //  use 'o' as the spare.
                 chunk_t *cs = spare_chunk.xchg (o);
                 if (cs)
-                    free (cs);
+                    pool_free (cs);
             }
         }
 
@@ -184,7 +184,7 @@ namespace zmq
 
         //  People are likely to produce and consume at similar rates.  In
         //  this scenario holding onto the most recently freed chunk saves
-        //  us from having to call malloc/free.
+        //  us from having to go to the memory pool.
         atomic_ptr_t<chunk_t> spare_chunk;
 
         //  Disable copying of yqueue.
@@ -31,6 +31,7 @@
 #include "socket_base.hpp"
 #include "app_thread.hpp"
 #include "msg_content.hpp"
+#include "pool.hpp"
 #include "platform.hpp"
 #include "stdint.hpp"
 #include "config.hpp"
@@ -119,8 +120,8 @@ int zmq_msg_init_size (zmq_msg_t *msg_, size_t size_)
         msg_->vsm_size = (uint8_t) size_;
     }
     else {
-        msg_->content =
-            (zmq::msg_content_t*) malloc (sizeof (zmq::msg_content_t) + size_);
+        msg_->content = (zmq::msg_content_t*) zmq::pool_alloc (
+            sizeof (zmq::msg_content_t) + size_);
         if (!msg_->content) {
             errno = ENOMEM;
             return -1;
@@ -140,7 +141,8 @@ int zmq_msg_init_size (zmq_msg_t *msg_, size_t size_)
 int zmq_msg_init_data (zmq_msg_t *msg_, void *data_, size_t size_,
     zmq_free_fn *ffn_, void *hint_)
 {
-    msg_->content = (zmq::msg_content_t*) malloc (sizeof (zmq::msg_content_t));
+    msg_->content =
+        (zmq::msg_content_t*) zmq::pool_alloc (sizeof (zmq::msg_content_t));
     zmq_assert (msg_->content);
     msg_->flags = 0;
     zmq::msg_content_t *content = (zmq::msg_content_t*) msg_->content;
@@ -168,9 +170,13 @@ int zmq_msg_close (zmq_msg_t *msg_)
         //  counter so we call its destructor now.
         content->refcnt.~atomic_counter_t ();
 
+        //  Content structures of messages left in a receive slab are part
+        //  of the slab and go away with it.
+        bool slab = (msg_->flags & ZMQ_MSG_SLAB) != 0;
         if (content->ffn)
             content->ffn (content->data, content->hint);
-        free (content);
+        if (!slab)
+            zmq::pool_free (content);
     }
 
     return 0;
@@ -366,6 +372,26 @@ int zmq_recv (void *s_, zmq_msg_t *msg_, int flags_)
     return (((zmq::socket_base_t*) s_)->recv (msg_, flags_));
 }
 
+int zmq_ctx_stats (void *ctx_, zmq_stats_t *stats_)
+{
+    if (!ctx_ || !stats_) {
+        errno = EFAULT;
+        return -1;
+    }
+    ((zmq::ctx_t*) ctx_)->get_stats (stats_);
+    return 0;
+}
+
+int zmq_monitor (void *s_, zmq_monitor_fn *monitor_, void *hint_,
+    int events_)
+{
+    if (!s_) {
+        errno = EFAULT;
+        return -1;
+    }
+    return (((zmq::socket_base_t*) s_)->monitor (monitor_, hint_, events_));
+}
+
 int zmq_poll (zmq_pollitem_t *items_, int nitems_, long timeout_)
 {
 #if defined ZMQ_HAVE_LINUX || defined ZMQ_HAVE_FREEBSD ||\
@@ -418,7 +444,7 @@ int zmq_poll (zmq_pollitem_t *items_, int nitems_, long timeout_)
     //  If there's at least one 0MQ socket in the pollset we have to poll
     //  for 0MQ commands. If ZMQ_POLL was not set, fail.
     if (nsockets) {
-        pollfds [npollfds].fd = app_thread->get_signaler ()->get_fd ();
+        pollfds [npollfds].fd = app_thread->get_mailbox ()->get_fd ();
         if (pollfds [npollfds].fd == zmq::retired_fd) {
             free (pollfds);
             errno = ENOTSUP;
@@ -445,7 +471,7 @@ int zmq_poll (zmq_pollitem_t *items_, int nitems_, long timeout_)
 
         //  Process 0MQ commands if needed.
         if (nsockets && pollfds [npollfds -1].revents & POLLIN)
-            if (!app_thread->process_commands (false, false)) {
+            if (!app_thread->process_commands (false)) {
                 free (pollfds);
                 errno = ETERM;
                 return -1;
@@ -570,7 +596,7 @@ int zmq_poll (zmq_pollitem_t *items_, int nitems_, long timeout_)
     //  If there's at least one 0MQ socket in the pollset we have to poll
     //  for 0MQ commands. If ZMQ_POLL was not set, fail.
     if (nsockets) {
-        notify_fd = app_thread->get_signaler ()->get_fd ();
+        notify_fd = app_thread->get_mailbox ()->get_fd ();
         if (notify_fd == zmq::retired_fd) {
             errno = ENOTSUP;
             return -1;
@@ -605,7 +631,7 @@ int zmq_poll (zmq_pollitem_t *items_, int nitems_, long timeout_)
 
         //  Process 0MQ commands if needed.
         if (nsockets && FD_ISSET (notify_fd, &inset))
-            if (!app_thread->process_commands (false, false)) {
+            if (!app_thread->process_commands (false)) {
                 errno = ETERM;
                 return -1;
             }
@@ -23,6 +23,8 @@
 #include "zmq_engine.hpp"
 #include "zmq_init.hpp"
 #include "io_thread.hpp"
+#include "socket_base.hpp"
+#include "config.hpp"
 #include "err.hpp"
 
 zmq::zmq_connecter_t::zmq_connecter_t (io_thread_t *parent_,
@@ -54,16 +56,19 @@ int zmq::zmq_connecter_t::set_address (const char *protocol_,
 
 void zmq::zmq_connecter_t::process_plug ()
 {
-    if (wait)
-        add_timer ();
-    else
+    if (wait) {
+        timer = add_timer (reconnect_ivl);
+        owner->monitor_event (ZMQ_EVENT_CONNECT_RETRIED, protocol, address, 0);
+    }
+    else {
         start_connecting ();
+    }
 }
 
 void zmq::zmq_connecter_t::process_unplug ()
 {
     if (wait)
-        cancel_timer ();
+        cancel_timer (timer);
     if (handle_valid)
         rm_fd (handle);
 }
@@ -84,12 +89,17 @@ void zmq::zmq_connecter_t::out_event ()
 
     //  Handle the error condition by attempt to reconnect.
     if (fd == retired_fd) {
+        int err = errno;
         tcp_connecter.close ();
         wait = true;
-        add_timer ();
+        timer = add_timer (reconnect_ivl);
+        owner->monitor_event (ZMQ_EVENT_CONNECT_RETRIED, protocol, address,
+            err);
         return;
     }
 
+    owner->monitor_event (ZMQ_EVENT_CONNECTED, protocol, address, 0);
+
     //  Create an init object. 
     zmq_init_t *init = new (std::nothrow) zmq_init_t (
         choose_io_thread (options.affinity), owner,
@@ -106,6 +116,7 @@ void zmq::zmq_connecter_t::out_event ()
 void zmq::zmq_connecter_t::timer_event ()
 {
     wait = false;
+    owner->get_stats ()->reconnects.add_shared (1);
     start_connecting ();
 }
 
@@ -131,6 +142,8 @@ void zmq::zmq_connecter_t::start_connecting ()
     }
 
     //  Handle any other error condition by eventual reconnect.
+    int err = errno;
     wait = true;
-    add_timer ();
+    timer = add_timer (reconnect_ivl);
+    owner->monitor_event (ZMQ_EVENT_CONNECT_RETRIED, protocol, address, err);
 }
@@ -69,6 +69,9 @@ namespace zmq
         //  If true, connecter is waiting a while before trying to connect.
         bool wait;
 
+        //  Reconnect timer. Valid only while 'wait' is true.
+        timer_handle_t timer;
+
         //  Ordinal of the session to attach to.
         uint64_t session_ordinal;
 
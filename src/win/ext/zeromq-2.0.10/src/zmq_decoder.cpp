@@ -27,7 +27,8 @@
 
 zmq::zmq_decoder_t::zmq_decoder_t (size_t bufsize_) :
     decoder_t <zmq_decoder_t> (bufsize_),
-    destination (NULL)
+    destination (NULL),
+    msg_size (0)
 {
     zmq_msg_init (&in_progress);
 
@@ -48,8 +49,8 @@ void zmq::zmq_decoder_t::set_inout (i_inout *destination_)
 bool zmq::zmq_decoder_t::one_byte_size_ready ()
 {
     //  First byte of size is read. If it is 0xff read 8-byte size.
-    //  Otherwise allocate the buffer for message data and read the
-    //  message data into it.
+    //  Otherwise read the flags. The message itself is initialised only
+    //  once we know whether its body can be left where it is.
     if (*tmpbuf == 0xff)
         next_step (tmpbuf, 8, &zmq_decoder_t::eight_byte_size_ready);
     else {
@@ -59,11 +60,7 @@ bool zmq::zmq_decoder_t::one_byte_size_ready ()
         //  There has to be at least one byte (the flags) in the message).
         zmq_assert (*tmpbuf > 0);
 
-        //  in_progress is initialised at this point so in theory we should
-        //  close it before calling zmq_msg_init_size, however, it's a 0-byte
-        //  message and thus we can treat it as uninitialised...
-        int rc = zmq_msg_init_size (&in_progress, *tmpbuf - 1);
-        errno_assert (rc == 0);
+        msg_size = *tmpbuf - 1;
         next_step (tmpbuf, 1, &zmq_decoder_t::flags_ready);
     }
     return true;
@@ -71,8 +68,7 @@ bool zmq::zmq_decoder_t::one_byte_size_ready ()
 
 bool zmq::zmq_decoder_t::eight_byte_size_ready ()
 {
-    //  8-byte size is read. Allocate the buffer for message body and
-    //  read the message data into it.
+    //  8-byte size is read. Read the flags next.
     size_t size = (size_t) get_uint64 (tmpbuf);
 
     //  TODO:  Handle over-sized message decently.
@@ -80,12 +76,7 @@ bool zmq::zmq_decoder_t::eight_byte_size_ready ()
     //  There has to be at least one byte (the flags) in the message).
     zmq_assert (size > 0);
 
-
-    //  in_progress is initialised at this point so in theory we should
-    //  close it before calling zmq_msg_init_size, however, it's a 0-byte
-    //  message and thus we can treat it as uninitialised...
-    int rc = zmq_msg_init_size (&in_progress, size - 1);
-    errno_assert (rc == 0);
+    msg_size = size - 1;
     next_step (tmpbuf, 1, &zmq_decoder_t::flags_ready);
 
     return true;
@@ -93,8 +84,27 @@ bool zmq::zmq_decoder_t::eight_byte_size_ready ()
 
 bool zmq::zmq_decoder_t::flags_ready ()
 {
-    //  Store the flags from the wire into the message structure.
-    in_progress.flags = tmpbuf [0];
+    //  Flags that have no equivalent in the wire format are not taken
+    //  from it.
+    unsigned char flags = tmpbuf [0] & ~(ZMQ_MSG_SHARED | ZMQ_MSG_SLAB);
+
+    //  in_progress is initialised at this point so in theory we should
+    //  close it before initialising it anew, however, it's a 0-byte
+    //  message and thus we can treat it as uninitialised...
+
+    //  If the whole body has been received already, leave it in place.
+    //  Very small messages are stored inside the message structure anyway.
+    if (msg_size > ZMQ_MAX_VSM_SIZE && carve (&in_progress, msg_size)) {
+        in_progress.flags |= flags;
+        next_step (NULL, 0, &zmq_decoder_t::message_ready);
+        return true;
+    }
+
+    //  Otherwise allocate the buffer for message body and read the message
+    //  data into it.
+    int rc = zmq_msg_init_size (&in_progress, msg_size);
+    errno_assert (rc == 0);
+    in_progress.flags = flags;
 
     next_step (zmq_msg_data (&in_progress), zmq_msg_size (&in_progress),
         &zmq_decoder_t::message_ready);
@@ -49,6 +49,9 @@ namespace zmq
         unsigned char tmpbuf [8];
         ::zmq_msg_t in_progress;
 
+        //  Size of the message body being read.
+        size_t msg_size;
+
         zmq_decoder_t (const zmq_decoder_t&);
         void operator = (const zmq_decoder_t&);
     };
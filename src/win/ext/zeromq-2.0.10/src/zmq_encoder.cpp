@@ -23,7 +23,8 @@
 
 zmq::zmq_encoder_t::zmq_encoder_t (size_t bufsize_) :
     encoder_t <zmq_encoder_t> (bufsize_),
-    source (NULL)
+    source (NULL),
+    pinned (false)
 {
     zmq_msg_init (&in_progress);
 
@@ -33,6 +34,7 @@ zmq::zmq_encoder_t::zmq_encoder_t (size_t bufsize_) :
 
 zmq::zmq_encoder_t::~zmq_encoder_t ()
 {
+    release ();
     zmq_msg_close (&in_progress);
 }
 
@@ -41,18 +43,38 @@ void zmq::zmq_encoder_t::set_inout (i_inout *source_)
     source = source_;
 }
 
+void zmq::zmq_encoder_t::pin ()
+{
+    pinned = true;
+}
+
+void zmq::zmq_encoder_t::release ()
+{
+    for (held_t::iterator it = held.begin (); it != held.end (); it++)
+        zmq_msg_close (&*it);
+    held.clear ();
+}
+
 bool zmq::zmq_encoder_t::size_ready ()
 {
-    //  Write message body into the buffer.
+    //  Write message body into the buffer. Bodies of very small messages
+    //  live inside the message structure itself, which is reused for the
+    //  next message, so only the others can be written in place.
     next_step (zmq_msg_data (&in_progress), zmq_msg_size (&in_progress),
-        &zmq_encoder_t::message_ready, false);
+        &zmq_encoder_t::message_ready, false,
+        in_progress.content != (void*) ZMQ_VSM);
     return true;
 }
 
 bool zmq::zmq_encoder_t::message_ready ()
 {
-    //  Destroy content of the old message.
-    zmq_msg_close(&in_progress);
+    //  Destroy content of the old message unless a batch still refers to it.
+    if (pinned) {
+        held.push_back (in_progress);
+        pinned = false;
+    }
+    else
+        zmq_msg_close (&in_progress);
 
     //  Read new message. If there is none, return false.
     //  Note that new state is set only if write is successful. That way
@@ -74,14 +96,14 @@ bool zmq::zmq_encoder_t::message_ready ()
     //  message size. In both cases 'flags' field follows.
     if (size < 255) {
         tmpbuf [0] = (unsigned char) size;
-        tmpbuf [1] = (in_progress.flags & ~ZMQ_MSG_SHARED);
+        tmpbuf [1] = (in_progress.flags & ~(ZMQ_MSG_SHARED | ZMQ_MSG_SLAB));
         next_step (tmpbuf, 2, &zmq_encoder_t::size_ready,
             !(in_progress.flags & ZMQ_MSG_MORE));
     }
     else {
         tmpbuf [0] = 0xff;
         put_uint64 (tmpbuf + 1, size);
-        tmpbuf [9] = (in_progress.flags & ~ZMQ_MSG_SHARED);
+        tmpbuf [9] = (in_progress.flags & ~(ZMQ_MSG_SHARED | ZMQ_MSG_SLAB));
         next_step (tmpbuf, 10, &zmq_encoder_t::size_ready,
             !(in_progress.flags & ZMQ_MSG_MORE));
     }
@@ -20,6 +20,8 @@
 #ifndef __ZMQ_ZMQ_ENCODER_HPP_INCLUDED__
 #define __ZMQ_ZMQ_ENCODER_HPP_INCLUDED__
 
+#include <vector>
+
 #include "../include/zmq.h"
 
 #include "encoder.hpp"
@@ -37,6 +39,14 @@ namespace zmq
 
         void set_inout (struct i_inout *source_);
 
+        //  Called by encoder_t. Keeps the message in progress alive till
+        //  release, because a batch refers to its body.
+        void pin ();
+
+        //  Called by encoder_t once the batch referring to the pinned
+        //  messages is written out.
+        void release ();
+
     private:
 
         bool size_ready ();
@@ -44,6 +54,13 @@ namespace zmq
 
         struct i_inout *source;
         ::zmq_msg_t in_progress;
+
+        //  True if the message in progress is pinned.
+        bool pinned;
+
+        //  Finished messages that batches still refer to.
+        typedef std::vector < ::zmq_msg_t> held_t;
+        held_t held;
         unsigned char tmpbuf [10];
 
         zmq_encoder_t (const zmq_encoder_t&);
@@ -29,6 +29,7 @@
 #include "zmq_connecter.hpp"
 #include "io_thread.hpp"
 #include "i_inout.hpp"
+#include "socket_base.hpp"
 #include "config.hpp"
 #include "err.hpp"
 
@@ -39,17 +40,15 @@ zmq::zmq_engine_t::zmq_engine_t (io_thread_t *parent_, fd_t fd_,
     inpos (NULL),
     insize (0),
     decoder (in_batch_size),
-    outpos (NULL),
-    outsize (0),
+    outcount (0),
+    outpos (0),
     encoder (out_batch_size),
     inout (NULL),
     options (options_),
-    reconnect (reconnect_)
+    reconnect (reconnect_),
+    protocol (protocol_),
+    address (address_)
 {
-    if (reconnect) {
-        protocol = protocol_;
-        address = address_;
-    }
 
     //  Initialise the underlying socket.
     int rc = tcp_socket.open (fd_, options.sndbuf, options.rcvbuf);
@@ -88,6 +87,7 @@ void zmq::zmq_engine_t::unplug ()
 void zmq::zmq_engine_t::in_event ()
 {
     bool disconnection = false;
+    int err = 0;
 
     //  If there's no data to process in the buffer...
     if (!insize) {
@@ -100,6 +100,7 @@ void zmq::zmq_engine_t::in_event ()
         if (insize == (size_t) -1) {
             insize = 0;
             disconnection = true;
+            err = errno;
         }
     }
 
@@ -123,36 +124,59 @@ void zmq::zmq_engine_t::in_event ()
     inout->flush ();
 
     if (disconnection)
-        error ();
+        error (err);
 }
 
 void zmq::zmq_engine_t::out_event ()
 {
-    //  If write buffer is empty, try to read new data from the encoder.
-    if (!outsize) {
-
-        outpos = NULL;
-        encoder.get_data (&outpos, &outsize);
-        
-        //  If there is no data to send, stop polling for output.
-        if (outsize == 0) {
-            reset_pollout (handle);
+    //  Write a few batches at most, then leave polling for output on and
+    //  let the other handles of the I/O thread have their turn.
+    for (int batches = 0; ; batches++) {
+
+        //  If the batch is written out, try to get a new one from the encoder.
+        if (outpos == outcount) {
+
+            if (batches == out_batches_per_event)
+                return;
+
+            outcount = encoder.get_iov (outbatch, out_batch_pieces);
+            outpos = 0;
+
+            //  If there is no data to send, stop polling for output.
+            if (!outcount) {
+                reset_pollout (handle);
+                return;
+            }
+        }
+
+        //  Write as much of the batch as possible to the socket.
+        int nbytes = tcp_socket.writev (outbatch + outpos, outcount - outpos);
+
+        //  Handle problems with the connection.
+        if (nbytes == -1) {
+            error (errno);
             return;
         }
-    }
 
-    //  If there are any data to write in write buffer, write as much as
-    //  possible to the socket.
-    int nbytes = tcp_socket.write (outpos, outsize);
+        //  Skip the pieces written completely. The write may end in the
+        //  middle of a piece, in which case only the rest of it is left.
+        size_t written = nbytes;
+        while (written) {
+            iovec_t &piece = outbatch [outpos];
+            if (written < piece.size) {
+                piece.data += written;
+                piece.size -= written;
+                break;
+            }
+            written -= piece.size;
+            outpos++;
+        }
 
-    //  Handle problems with the connection.
-    if (nbytes == -1) {
-        error ();
-        return;
+        //  If the socket didn't take the whole batch, wait till it's
+        //  writable again.
+        if (outpos != outcount)
+            return;
     }
-
-    outpos += nbytes;
-    outsize -= nbytes;
 }
 
 void zmq::zmq_engine_t::revive ()
@@ -173,10 +197,13 @@ void zmq::zmq_engine_t::resume_input ()
     in_event ();
 }
 
-void zmq::zmq_engine_t::error ()
+void zmq::zmq_engine_t::error (int err_)
 {
     zmq_assert (inout);
 
+    inout->get_owner ()->monitor_event (ZMQ_EVENT_DISCONNECTED, protocol,
+        address, err_);
+
     zmq_connecter_t *reconnecter = NULL;
     if (reconnect) {
 
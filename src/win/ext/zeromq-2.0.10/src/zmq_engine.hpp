@@ -30,6 +30,7 @@
 #include "zmq_encoder.hpp"
 #include "zmq_decoder.hpp"
 #include "options.hpp"
+#include "config.hpp"
 
 namespace zmq
 {
@@ -55,8 +56,9 @@ namespace zmq
 
     private:
 
-        //  Function to handle network disconnections.
-        void error ();
+        //  Function to handle network disconnections. 'err_' is the error
+        //  that caused the disconnection, zero for an orderly shutdown.
+        void error (int err_);
 
         tcp_socket_t tcp_socket;
         handle_t handle;
@@ -65,14 +67,19 @@ namespace zmq
         size_t insize;
         zmq_decoder_t decoder;
 
-        unsigned char *outpos;
-        size_t outsize;
+        //  Batch of pieces being written and the first piece that is not
+        //  written completely yet.
+        iovec_t outbatch [out_batch_pieces];
+        int outcount;
+        int outpos;
         zmq_encoder_t encoder;
 
         i_inout *inout;
 
         options_t options;
 
+        //  Endpoint of the connection. It's connected to again after
+        //  a disconnection if 'reconnect' is set.
         bool reconnect;
         std::string protocol;
         std::string address;
@@ -22,6 +22,7 @@
 #include "zmq_listener.hpp"
 #include "zmq_init.hpp"
 #include "io_thread.hpp"
+#include "socket_base.hpp"
 #include "err.hpp"
 
 zmq::zmq_listener_t::zmq_listener_t (io_thread_t *parent_,
@@ -38,7 +39,12 @@ zmq::zmq_listener_t::~zmq_listener_t ()
 
 int zmq::zmq_listener_t::set_address (const char *protocol_, const char *addr_)
 {
-     return tcp_listener.set_address (protocol_, addr_);
+     int rc = tcp_listener.set_address (protocol_, addr_);
+     if (rc != 0)
+         return rc;
+     protocol = protocol_;
+     address = addr_;
+     return 0;
 }
 
 void zmq::zmq_listener_t::process_plug ()
@@ -62,10 +68,13 @@ void zmq::zmq_listener_t::in_event ()
     if (fd == retired_fd)
         return;
 
+    owner->monitor_event (ZMQ_EVENT_ACCEPTED, protocol, address, 0);
+
     //  Create an init object. 
     io_thread_t *io_thread = choose_io_thread (options.affinity);
     zmq_init_t *init = new (std::nothrow) zmq_init_t (
-        io_thread, owner, fd, options, false, NULL, NULL, 0);
+        io_thread, owner, fd, options, false, protocol.c_str (),
+        address.c_str (), 0);
     zmq_assert (init);
     send_plug (init);
     send_own (owner, init);
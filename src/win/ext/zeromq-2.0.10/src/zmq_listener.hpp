@@ -20,6 +20,8 @@
 #ifndef __ZMQ_ZMQ_LISTENER_HPP_INCLUDED__
 #define __ZMQ_ZMQ_LISTENER_HPP_INCLUDED__
 
+#include <string>
+
 #include "owned.hpp"
 #include "io_object.hpp"
 #include "tcp_listener.hpp"
@@ -58,6 +60,10 @@ namespace zmq
         //  Associated socket options.
         options_t options;
 
+        //  Protocol and address being listened on.
+        std::string protocol;
+        std::string address;
+
         zmq_listener_t (const zmq_listener_t&);
         void operator = (const zmq_listener_t&);
     };
@@ -0,0 +1,102 @@
+#ifndef GDI_FRAME_SOURCE_HPP
+#define GDI_FRAME_SOURCE_HPP
+
+	#include <Windows.h>
+	#include "PreviewPublisher.h"
+
+	class GdiFrameSource : public IFrameSource
+	{
+
+	public:
+
+		GdiFrameSource() : memory_dc_(NULL), bitmap_(NULL), pixels_(NULL), width_(0), height_(0) { };
+
+		~GdiFrameSource()
+		{
+			destroy();
+		}
+
+		bool capture(Frame& frame)
+		{
+			int width = GetSystemMetrics(SM_CXSCREEN);
+			int height = GetSystemMetrics(SM_CYSCREEN);
+
+			if (width != width_ || height != height_)
+			{
+				destroy();
+				create(width, height);
+			}
+
+			if (bitmap_ == NULL)
+			{
+				return false;
+			}
+
+			HDC screen_dc = GetDC(NULL);
+			BOOL copied = BitBlt(memory_dc_, 0, 0, width_, height_, screen_dc, 0, 0, SRCCOPY);
+			ReleaseDC(NULL, screen_dc);
+			GdiFlush();
+
+			frame.width = width_;
+			frame.height = height_;
+			frame.stride = width_ * 4;
+			frame.pixels = (const unsigned char*)pixels_;
+			return copied != FALSE;
+		}
+
+		void release(Frame& frame)
+		{
+
+		}
+
+	private:
+
+		void create(int width, int height)
+		{
+			// top-down 32 bit DIB, which is the BGRA layout the encoder reads
+			BITMAPINFO info;
+			memset(&info, 0, sizeof(info));
+			info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+			info.bmiHeader.biWidth = width;
+			info.bmiHeader.biHeight = -height;
+			info.bmiHeader.biPlanes = 1;
+			info.bmiHeader.biBitCount = 32;
+			info.bmiHeader.biCompression = BI_RGB;
+
+			HDC screen_dc = GetDC(NULL);
+			memory_dc_ = CreateCompatibleDC(screen_dc);
+			bitmap_ = CreateDIBSection(screen_dc, &info, DIB_RGB_COLORS, &pixels_, NULL, 0);
+			ReleaseDC(NULL, screen_dc);
+
+			if (bitmap_ != NULL)
+			{
+				SelectObject(memory_dc_, bitmap_);
+				width_ = width;
+				height_ = height;
+			}
+		}
+
+		void destroy()
+		{
+			if (bitmap_ != NULL)
+			{
+				DeleteObject(bitmap_);
+				bitmap_ = NULL;
+			}
+			if (memory_dc_ != NULL)
+			{
+				DeleteDC(memory_dc_);
+				memory_dc_ = NULL;
+			}
+			width_ = height_ = 0;
+		}
+
+		HDC memory_dc_;
+		HBITMAP bitmap_;
+		void* pixels_;
+		int width_;
+		int height_;
+
+	};
+
+#endif
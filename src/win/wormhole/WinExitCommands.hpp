@@ -4,6 +4,11 @@
 	#include <iostream>
 	#include <Windows.h>
 	#include "KeyCodes.hpp"	
+	#include "ScrollAccumulator.h"
+
+#ifndef MOUSEEVENTF_HWHEEL
+	#define MOUSEEVENTF_HWHEEL 0x01000
+#endif
 
 	char* tohex(int value)
 	{
@@ -81,6 +86,20 @@
 
 	};
 
+	class MousePositionCommand : public IExitCommand
+	{
+
+	public:
+
+		static int type() { return MOUSE_POSITION; };
+
+		void Execute(const Message& message)
+		{
+			SetCursorPos(message.x, message.y);
+		};
+
+	};
+
 	class LeftDownCommand : public IExitCommand
 	{
 
@@ -187,4 +206,99 @@
 		};
 	};
 
+	/*
+	 * Windows takes wheel travel in WHEEL_DELTA per notch but accepts any
+	 * subdivision of it, which is how high resolution wheels scroll smoothly.
+	 * A notch is taken to be three lines, the system default.
+	 */
+	class ScrollWheelCommand : public IExitCommand
+	{
+
+	public:
+
+		ScrollWheelCommand()
+			: horizontal_(3 * SCROLL_PIXELS_PER_LINE * SCROLL_FIXED_ONE / WHEEL_DELTA)
+			, vertical_(3 * SCROLL_PIXELS_PER_LINE * SCROLL_FIXED_ONE / WHEEL_DELTA)
+		{ };
+
+		static int type() { return SCROLL_WHEEL; };
+
+		void Execute(const Message& message)
+		{
+			INPUT buffer[2];
+			int count = 0;
+
+			int y = vertical_.add(message.y);
+			if (y != 0)
+			{
+				wheel(buffer[count++], MOUSEEVENTF_WHEEL, y);
+			}
+
+			// OS X counts left as positive, Windows counts right
+			int x = horizontal_.add(message.x);
+			if (x != 0)
+			{
+				wheel(buffer[count++], MOUSEEVENTF_HWHEEL, -x);
+			}
+
+			if (count > 0)
+			{
+				SendInput(count, buffer, sizeof(INPUT));
+			}
+		};
+
+	private:
+
+		void wheel(INPUT& buffer, DWORD flags, int delta)
+		{
+			buffer.type = INPUT_MOUSE;
+			buffer.mi.dx = 0;
+			buffer.mi.dy = 0;
+			buffer.mi.mouseData = (DWORD)delta;
+			buffer.mi.dwFlags = flags;
+			buffer.mi.time = 0;
+			buffer.mi.dwExtraInfo = 0;
+		}
+
+		ScrollAccumulator horizontal_;
+		ScrollAccumulator vertical_;
+
+	};
+
+	class TextCommand : public IExitCommand
+	{
+
+	public:
+
+		static int type() { return TEXT; };
+
+		void Execute(const Message& message)
+		{
+			WCHAR chars[MESSAGE_TEXT_SIZE];
+			int length = MultiByteToWideChar(CP_UTF8, 0, message.text, text_length(message), chars, MESSAGE_TEXT_SIZE);
+
+			// a down and an up per UTF-16 unit, all injected in one call
+			INPUT buffer[MESSAGE_TEXT_SIZE * 2];
+
+			for (int i = 0; i < length; i++)
+			{
+				for (int up = 0; up < 2; up++)
+				{
+					INPUT& input = buffer[i * 2 + up];
+					input.type = INPUT_KEYBOARD;
+					input.ki.wVk = 0;
+					input.ki.wScan = chars[i];
+					input.ki.dwFlags = KEYEVENTF_UNICODE | (up ? KEYEVENTF_KEYUP : 0);
+					input.ki.time = 0;
+					input.ki.dwExtraInfo = 0;
+				}
+			}
+
+			if (length > 0)
+			{
+				SendInput(length * 2, buffer, sizeof(INPUT));
+			}
+		};
+	};
+
 #endif
\ No newline at end of file
@@ -10,6 +10,11 @@
 #include "Constants.hpp"
 #include "Message.h"
 #include "Exit.h"
+#include "Reactor.h"
+#include "ClipboardChannel.h"
+#include "FileReceiver.h"
+#include "PreviewPublisher.h"
+#include "GdiFrameSource.hpp"
 
 #include "resource.h"
 
@@ -22,6 +27,8 @@
 #define ID_TRAY_APP_ICON                5000
 #define ID_TRAY_EXIT_CONTEXT_MENU_ITEM  3000
 #define WM_TRAYICON ( WM_USER + 1 )
+#define WM_CLIPBOARD_OFFERED ( WM_USER + 2 )
+#define ID_CLIPBOARD_TIMER 1
 
 #pragma region constants and globals
 UINT WM_TASKBARCREATED = 0 ;
@@ -33,6 +40,14 @@ NOTIFYICONDATA g_notifyIconData ;
 #pragma endregion
 
 bool quit = false;
+Reactor* reactor = NULL;
+Reactor* transfer_reactor = NULL;
+
+ClipboardChannel* clipboard = NULL;
+HANDLE clipboard_ready = NULL;
+std::string clipboard_content;
+volatile unsigned long long pending_digest = 0;
+DWORD clipboard_sequence = 0;
 
 LRESULT CALLBACK WndProc (HWND, UINT, WPARAM, LPARAM);
 
@@ -49,6 +64,147 @@ void InitNotifyIconData()
   stringcopy(g_notifyIconData.szTip, TEXT("Wormhole"));
 }
 
+class WinClipboardListener : public IClipboardListener
+{
+  
+public:
+  
+  void on_clipboard_offered(unsigned long long digest, unsigned int size)
+  {
+    pending_digest = digest;
+    PostMessage(g_hwnd, WM_CLIPBOARD_OFFERED, 0, 0);
+  }
+  
+  void on_clipboard_ready(unsigned long long digest, const std::string& content)
+  {
+    clipboard_content = content;
+    SetEvent(clipboard_ready);
+  }
+  
+};
+
+void RenderClipboard()
+{
+  if (clipboard == NULL)
+  {
+    return;
+  }
+  
+  ResetEvent(clipboard_ready);
+  clipboard->fetch(pending_digest);
+  
+  if (WaitForSingleObject(clipboard_ready, CLIPBOARD_FETCH_TIMEOUT) != WAIT_OBJECT_0)
+  {
+    return;
+  }
+  
+  int length = MultiByteToWideChar(CP_UTF8, 0, clipboard_content.c_str(), -1, NULL, 0);
+  HGLOBAL memory = GlobalAlloc(GMEM_MOVEABLE, length * sizeof(WCHAR));
+  
+  if (memory != NULL)
+  {
+    MultiByteToWideChar(CP_UTF8, 0, clipboard_content.c_str(), -1, (LPWSTR)GlobalLock(memory), length);
+    GlobalUnlock(memory);
+    SetClipboardData(CF_UNICODETEXT, memory);
+  }
+}
+
+// polled like the OS X pasteboard, so copies here reach the controller too
+void OfferClipboard(HWND hwnd)
+{
+  DWORD sequence = GetClipboardSequenceNumber();
+  
+  if (sequence == clipboard_sequence)
+  {
+    return;
+  }
+  clipboard_sequence = sequence;
+  
+  // our own delayed rendering, the controller already has it
+  if (clipboard == NULL || GetClipboardOwner() == hwnd || !OpenClipboard(hwnd))
+  {
+    return;
+  }
+  
+  HANDLE data = GetClipboardData(CF_UNICODETEXT);
+  LPCWSTR text = (data != NULL) ? (LPCWSTR)GlobalLock(data) : NULL;
+  
+  if (text != NULL)
+  {
+    int length = WideCharToMultiByte(CP_UTF8, 0, text, -1, NULL, 0, NULL, NULL);
+    
+    if (length > 0)
+    {
+      std::string content(length, '\0');
+      WideCharToMultiByte(CP_UTF8, 0, text, -1, &content[0], length, NULL, NULL);
+      content.resize(length - 1);
+      clipboard->offer(content);
+    }
+    GlobalUnlock(data);
+  }
+  CloseClipboard();
+}
+
+// the exit has no settings of its own, so this is an environment switch
+static bool bulk_compression()
+{
+  const char* setting = getenv("WARP_BULK_COMPRESSION");
+  return setting != NULL && std::string(setting) == "1";
+}
+
+DWORD WINAPI NetworkThread(LPVOID parameter)
+{
+  Exit exit;
+  Reactor network_reactor;
+  ClipboardChannel clipboard_channel;
+  WinClipboardListener clipboard_listener;
+  
+  clipboard_channel.set_compression(bulk_compression());
+  
+  exit.attach(&network_reactor);
+  clipboard_channel.bind(CLIPBOARD_PORT);
+  clipboard_channel.attach(&network_reactor, &clipboard_listener);
+  
+  clipboard = &clipboard_channel;
+  reactor = &network_reactor;
+  if (!quit)
+  {
+    network_reactor.run();
+  }
+  reactor = NULL;
+  clipboard = NULL;
+  
+  exit.shutdown();
+  return 0;
+}
+
+DWORD WINAPI TransferThread(LPVOID parameter)
+{
+  const char* profile = getenv("USERPROFILE");
+  std::string downloads = profile ? std::string(profile) + "\\Downloads" : ".";
+  
+  // bulk transfers get a loop of their own so they never delay the exit
+  Reactor reactor_loop;
+  FileReceiver receiver(downloads);
+  GdiFrameSource screen;
+  PreviewPublisher preview(&screen);
+  
+  preview.set_compression(bulk_compression());
+  
+  receiver.bind(TRANSFER_PORT);
+  receiver.attach(&reactor_loop, NULL);
+  preview.bind(PREVIEW_PORT);
+  preview.attach(&reactor_loop);
+  
+  transfer_reactor = &reactor_loop;
+  if (!quit)
+  {
+    reactor_loop.run();
+  }
+  transfer_reactor = NULL;
+  return 0;
+}
+
 int WINAPI WinMain (HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR args, int iCmdShow )
 {
   TCHAR className[] = TEXT( "tray icon class" );
@@ -78,17 +234,29 @@ int WINAPI WinMain (HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR args, in
   Shell_NotifyIcon(NIM_ADD, &g_notifyIconData);
 
   ZeroMQContext::init();
-  Exit exit;
+  clipboard_ready = CreateEvent(NULL, TRUE, FALSE, NULL);
+  HANDLE network_thread = CreateThread(NULL, 0, NetworkThread, NULL, 0, NULL);
+  HANDLE transfer_thread = CreateThread(NULL, 0, TransferThread, NULL, 0, NULL);
  
   MSG msg ;
-  while (!quit)
+  while (!quit && GetMessage(&msg, 0, 0, 0) > 0)
   {
-	PeekMessage(&msg, 0, 0, 0, PM_REMOVE);
-	exit.receive_input();
     TranslateMessage(&msg);
     DispatchMessage(&msg);
   }
 
+  if (reactor)
+  {
+    reactor->stop();
+  }
+  if (transfer_reactor)
+  {
+    transfer_reactor->stop();
+  }
+  WaitForSingleObject(network_thread, INFINITE);
+  WaitForSingleObject(transfer_thread, INFINITE);
+  CloseHandle(clipboard_ready);
+
   Shell_NotifyIcon(NIM_DELETE, &g_notifyIconData);
  
   return msg.wParam;
@@ -106,6 +274,15 @@ LRESULT CALLBACK WndProc (HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
   case WM_CREATE:
     g_menu = CreatePopupMenu();
     AppendMenu(g_menu, MF_STRING, ID_TRAY_EXIT_CONTEXT_MENU_ITEM,  TEXT( "Exit" ) );
+    clipboard_sequence = GetClipboardSequenceNumber();
+    SetTimer(hwnd, ID_CLIPBOARD_TIMER, 1000, NULL);
+    break;
+
+  case WM_TIMER:
+    if (wParam == ID_CLIPBOARD_TIMER)
+    {
+      OfferClipboard(hwnd);
+    }
     break;
 
   case WM_TRAYICON:
@@ -127,6 +304,20 @@ LRESULT CALLBACK WndProc (HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam)
     }
     break;
 
+  case WM_CLIPBOARD_OFFERED:
+    // delayed rendering: the text is only pulled over when something pastes
+    if (OpenClipboard(hwnd))
+    {
+      EmptyClipboard();
+      SetClipboardData(CF_UNICODETEXT, NULL);
+      CloseClipboard();
+    }
+    break;
+
+  case WM_RENDERFORMAT:
+    RenderClipboard();
+    return 0;
+
   case WM_CLOSE:
     printf( "Got an actual WM_CLOSE Message!  Woo hoo!\n" ) ;
     return 0;